@@ -0,0 +1,198 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+/*
+  Host stand-in for the ESP8266 Arduino core
+
+  Only what the firmware uses, for the native env. millis() and micros()
+  read a virtual clock that moves only when a test advances it or the
+  firmware calls delay(), so every run of the same inputs takes the same
+  path. random() is a fixed generator that randomSeed() restarts. Pins,
+  the reset reason and the Serial input are set from host.h, which is
+  also where a test reads back what the firmware sent.
+*/
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define F(s) (s)
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+
+#define D1 5
+#define D2 4
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::min;
+using std::max;
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline uint8_t pgm_read_byte(const void* p) { return *(const uint8_t*)p; }
+inline uint16_t pgm_read_word(const void* p) { return *(const uint16_t*)p; }
+inline uint32_t pgm_read_dword(const void* p) { return *(const uint32_t*)p; }
+inline const void* pgm_read_ptr(const void* p) { return *(const void* const*)p; }
+inline void* memcpy_P(void* dest, const void* src, size_t n) { return memcpy(dest, src, n); }
+inline int strcmp_P(const char* a, const char* b) { return strcmp(a, b); }
+inline size_t strlen_P(const char* s) { return strlen(s); }
+inline int vsnprintf_P(char* buffer, size_t size, const char* fmt, va_list args) {
+  return vsnprintf(buffer, size, fmt, args);
+}
+int snprintf_P(char* buffer, size_t size, const char* fmt, ...);
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dest, const char* src, size_t size);
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t level);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2 = nullptr,
+                const char* server3 = nullptr);
+
+class String {
+public:
+  String(const char* s = "") : text(s ? s : "") {}
+  String(int value) : text(std::to_string(value)) {}
+  String(unsigned int value) : text(std::to_string(value)) {}
+  String(long value) : text(std::to_string(value)) {}
+  String(unsigned long value) : text(std::to_string(value)) {}
+
+  const char* c_str() const { return text.c_str(); }
+  unsigned int length() const { return text.size(); }
+  bool isEmpty() const { return text.empty(); }
+  int toInt() const { return atoi(text.c_str()); }
+  bool startsWith(const char* prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+  bool operator==(const char* s) const { return text == s; }
+  bool operator!=(const char* s) const { return text != s; }
+  bool operator==(const String& s) const { return text == s.text; }
+  String& operator+=(const String& s) { text += s.text; return *this; }
+  String operator+(const String& s) const { return String((text + s.text).c_str()); }
+  friend String operator+(const char* a, const String& b) { return String(a) + b; }
+
+private:
+  std::string text;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* data, size_t length);
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(T value) { return print(value) + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t printf_P(PGM_P fmt, ...);
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(uint8_t* buffer, size_t length);
+  size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+  long parseInt();
+  String readStringUntil(char terminator);
+  void setTimeout(unsigned long ms) {}
+};
+
+// The UART: output is kept for hostSerialOutput(), input comes from hostSerialInput()
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) {}
+  operator bool() { return true; }
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  int availableForWrite() override { return 128; }  // the size of the UART FIFO
+};
+
+extern HardwareSerial Serial;
+
+struct rst_info {
+  uint32_t reason;
+  uint32_t exccause;
+  uint32_t epc1;
+  uint32_t epc2;
+  uint32_t epc3;
+  uint32_t excvaddr;
+  uint32_t depc;
+};
+
+enum rst_reason {
+  REASON_DEFAULT_RST = 0,
+  REASON_WDT_RST = 1,
+  REASON_EXCEPTION_RST = 2,
+  REASON_SOFT_WDT_RST = 3,
+  REASON_SOFT_RESTART = 4,
+  REASON_DEEP_SLEEP_AWAKE = 5,
+  REASON_EXT_SYS_RST = 6
+};
+
+// A fixed heap, 512 bytes of RTC memory, and the running image set with hostSetSketch()
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxFreeBlockSize();
+  uint8_t getHeapFragmentation();
+  void getHeapStats(uint32_t* free = nullptr, uint16_t* max = nullptr, uint8_t* frag = nullptr);
+  void getHeapStats(uint32_t* free, uint32_t* max, uint8_t* frag = nullptr);
+  uint32_t random();
+
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size);
+  rst_info* getResetInfoPtr();
+  void restart();
+
+  uint32_t getSketchSize();
+  String getSketchMD5();
+  bool flashRead(uint32_t address, uint8_t* data, size_t size);
+  uint32_t getCpuFreqMHz() { return 160; }
+  uint32_t getChipId() { return 0x10CEB0; }
+};
+
+extern EspClass ESP;
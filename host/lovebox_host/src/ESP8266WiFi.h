@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class IPAddress {
+public:
+  IPAddress() : address(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : address(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+  uint8_t operator[](int index) const { return address >> (8 * index); }
+  operator uint32_t() const { return address; }
+  String toString() const;
+
+private:
+  uint32_t address;
+};
+
+enum wl_status_t {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD = 6,
+  WL_DISCONNECTED = 7
+};
+
+enum WiFiMode_t {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+};
+
+struct WiFiEventStationModeGotIP {
+  IPAddress ip;
+  IPAddress mask;
+  IPAddress gw;
+};
+
+struct WiFiEventStationModeDisconnected {
+  String ssid;
+  uint8_t bssid[6];
+  uint8_t reason;
+};
+
+class WiFiEventHandlerOpaque {};
+typedef std::shared_ptr<WiFiEventHandlerOpaque> WiFiEventHandler;
+
+// A station that never finds a network; status() is whatever hostSetWifiStatus() set
+class ESP8266WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true);
+  wl_status_t status();
+  bool mode(WiFiMode_t mode) { return true; }
+  bool disconnect(bool wifiOff = false) { return true; }
+  bool softAP(const char* ssid, const char* passphrase = nullptr) { return true; }
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+  IPAddress localIP();
+  String SSID() { return String(); }
+  int32_t RSSI();
+  uint8_t* BSSID();
+
+  int8_t scanNetworks(bool async = false, bool showHidden = false) { return async ? WIFI_SCAN_RUNNING : 0; }
+  int8_t scanComplete() { return 0; }
+  void scanDelete() {}
+  String SSID(uint8_t index) { return String(); }
+  int32_t RSSI(uint8_t index) { return 0; }
+  uint8_t* BSSID(uint8_t index) { return BSSID(); }
+  int32_t channel(uint8_t index) { return 0; }
+
+  WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> handler);
+  WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected&)> handler);
+};
+
+extern ESP8266WiFiClass WiFi;
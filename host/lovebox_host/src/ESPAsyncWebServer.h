@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <functional>
+
+// A server nobody connects to: handlers are registered and never called
+
+enum WebRequestMethod {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_ANY = 0b01111111
+};
+
+class AsyncWebServerRequest;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+
+class AsyncWebParameter {
+public:
+  const String& value() const { return text; }
+
+private:
+  String text;
+};
+
+class AsyncWebServerResponse {
+public:
+  void addHeader(const String& name, const String& value) {}
+};
+
+class AsyncWebServerRequest {
+public:
+  bool hasParam(const String& name, bool post = false, bool file = false) const { return false; }
+  AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const;
+  void send(int code, const String& contentType = String(), const String& content = String()) {}
+  void send(FS& fs, const String& path, const String& contentType = String(), bool download = false) {}
+  void send(AsyncWebServerResponse* response) { delete response; }
+  AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller callback) {
+    return new AsyncWebServerResponse();
+  }
+};
+
+class AsyncWebHandler {
+public:
+  AsyncWebHandler& setDefaultFile(const char* filename) { return *this; }
+};
+
+class AsyncWebServer {
+public:
+  AsyncWebServer(uint16_t port) {}
+  void begin() {}
+  void end() {}
+  AsyncWebHandler& on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction onRequest) {
+    return handler;
+  }
+  AsyncWebHandler& serveStatic(const char* uri, fs::FS& fs, const char* path, const char* cacheControl = nullptr) {
+    return handler;
+  }
+
+private:
+  AsyncWebHandler handler;
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+
+/*
+  Host stand-in for FluxGarage RoboEyes
+
+  Header only and drawing on the global `display`, as the library does, so
+  include it after display is declared. It keeps the fields the eyes
+  governor reads and the library's timing: a frame every frameInterval ms
+  of millis(), blinks and idle glances on random() timers. The tweening
+  and the drawing are plainer than the library's.
+*/
+
+#define DEFAULT 0
+#define TIRED 1
+#define ANGRY 2
+#define HAPPY 3
+
+#define ON 1
+#define OFF 0
+
+class roboEyes {
+public:
+  int screenWidth = 128;
+  int screenHeight = 64;
+  int frameInterval = 20;
+  unsigned long fpsTimer = 0;
+
+  bool tired = false;
+  bool angry = false;
+  bool happy = false;
+  bool curious = false;
+  bool eyeL_open = false;
+  bool eyeR_open = false;
+
+  int spaceBetweenDefault = 10;
+  int eyeLwidthDefault = 36, eyeLheightDefault = 36, eyeLborderRadiusDefault = 8;
+  int eyeLwidthCurrent = 36, eyeLwidthNext = 36;
+  int eyeLheightCurrent = 1, eyeLheightNext = 36;
+  int eyeLborderRadiusCurrent = 8, eyeLborderRadiusNext = 8;
+  int eyeRwidthDefault = 36, eyeRheightDefault = 36, eyeRborderRadiusDefault = 8;
+  int eyeRwidthCurrent = 36, eyeRwidthNext = 36;
+  int eyeRheightCurrent = 1, eyeRheightNext = 36;
+  int eyeRborderRadiusCurrent = 8, eyeRborderRadiusNext = 8;
+  int eyeLx = 0, eyeLy = 0, eyeLxNext = 0, eyeLyNext = 0;
+  int eyeRx = 0, eyeRy = 0, eyeRxNext = 0, eyeRyNext = 0;
+
+  int eyelidsTiredHeight = 0, eyelidsTiredHeightNext = 0;
+  int eyelidsAngryHeight = 0, eyelidsAngryHeightNext = 0;
+  int eyelidsHappyBottomOffset = 0, eyelidsHappyBottomOffsetNext = 0;
+
+  bool hFlicker = false, hFlickerAlternate = false;
+  bool vFlicker = false, vFlickerAlternate = false;
+
+  bool autoblinker = false;
+  int blinkInterval = 1, blinkIntervalVariation = 4;
+  unsigned long blinktimer = 0;
+
+  bool idle = false;
+  int idleInterval = 1, idleIntervalVariation = 3;
+  unsigned long idleAnimationTimer = 0;
+
+  bool confused = false, confusedToggle = true;
+  unsigned long confusedAnimationTimer = 0;
+  int confusedAnimationDuration = 500;
+
+  bool laugh = false, laughToggle = true;
+  unsigned long laughAnimationTimer = 0;
+  int laughAnimationDuration = 500;
+
+  void begin(int width, int height, byte frameRate) {
+    screenWidth = width;
+    screenHeight = height;
+    display.clearDisplay();
+    display.display();
+    eyeLheightCurrent = 1;
+    eyeRheightCurrent = 1;
+    setFramerate(frameRate);
+    eyeLx = eyeLxNext = (screenWidth - (eyeLwidthDefault + spaceBetweenDefault + eyeRwidthDefault)) / 2;
+    eyeLy = eyeLyNext = (screenHeight - eyeLheightDefault) / 2;
+    placeRightEye();
+  }
+
+  void update() {
+    if (millis() - fpsTimer >= (unsigned long)frameInterval) {
+      drawEyes();
+      fpsTimer = millis();
+    }
+  }
+
+  void setFramerate(byte fps) { frameInterval = 1000 / max<byte>(fps, 1); }
+
+  void setWidth(byte left, byte right) {
+    eyeLwidthDefault = eyeLwidthNext = left;
+    eyeRwidthDefault = eyeRwidthNext = right;
+  }
+
+  void setHeight(byte left, byte right) {
+    eyeLheightDefault = eyeLheightNext = left;
+    eyeRheightDefault = eyeRheightNext = right;
+  }
+
+  void setBorderradius(byte left, byte right) {
+    eyeLborderRadiusDefault = eyeLborderRadiusNext = left;
+    eyeRborderRadiusDefault = eyeRborderRadiusNext = right;
+  }
+
+  void setAutoblinker(bool active, int interval, int variation) {
+    autoblinker = active;
+    blinkInterval = interval;
+    blinkIntervalVariation = variation;
+  }
+
+  void setIdleMode(bool active, int interval, int variation) {
+    idle = active;
+    idleInterval = interval;
+    idleIntervalVariation = variation;
+  }
+
+  void setMood(unsigned char mood) {
+    tired = mood == TIRED;
+    angry = mood == ANGRY;
+    happy = mood == HAPPY;
+  }
+
+  void setCuriosity(bool curiousBit) { curious = curiousBit; }
+
+  void open() {
+    eyeL_open = true;
+    eyeR_open = true;
+  }
+
+  void close() {
+    eyeLheightNext = 1;
+    eyeRheightNext = 1;
+    eyeL_open = false;
+    eyeR_open = false;
+  }
+
+  void blink() {
+    close();
+    open();
+  }
+
+  void anim_confused() { confused = true; }
+  void anim_laugh() { laugh = true; }
+
+  void drawEyes() {
+    runAnimations();
+
+    eyeLheightCurrent = (eyeLheightCurrent + eyeLheightNext) / 2;
+    eyeRheightCurrent = (eyeRheightCurrent + eyeRheightNext) / 2;
+    if (eyeL_open && eyeLheightCurrent <= 1) {
+      eyeLheightNext = eyeLheightDefault;
+    }
+    if (eyeR_open && eyeRheightCurrent <= 1) {
+      eyeRheightNext = eyeRheightDefault;
+    }
+    eyeLwidthCurrent = (eyeLwidthCurrent + eyeLwidthNext) / 2;
+    eyeRwidthCurrent = (eyeRwidthCurrent + eyeRwidthNext) / 2;
+    eyeLborderRadiusCurrent = (eyeLborderRadiusCurrent + eyeLborderRadiusNext) / 2;
+    eyeRborderRadiusCurrent = (eyeRborderRadiusCurrent + eyeRborderRadiusNext) / 2;
+    eyeLx = (eyeLx + eyeLxNext) / 2;
+    eyeLy = (eyeLy + eyeLyNext) / 2;
+    placeRightEye();
+
+    eyelidsTiredHeightNext = tired ? eyeLheightCurrent / 2 : 0;
+    eyelidsAngryHeightNext = angry ? eyeLheightCurrent / 2 : 0;
+    eyelidsHappyBottomOffsetNext = happy ? eyeLheightCurrent / 2 : 0;
+    eyelidsTiredHeight = (eyelidsTiredHeight + eyelidsTiredHeightNext) / 2;
+    eyelidsAngryHeight = (eyelidsAngryHeight + eyelidsAngryHeightNext) / 2;
+    eyelidsHappyBottomOffset = (eyelidsHappyBottomOffset + eyelidsHappyBottomOffsetNext) / 2;
+
+    int dx = hFlicker ? (hFlickerAlternate ? 2 : -2) : 0;
+    int dy = vFlicker ? (vFlickerAlternate ? 2 : -2) : 0;
+    hFlickerAlternate = !hFlickerAlternate;
+    vFlickerAlternate = !vFlickerAlternate;
+
+    display.clearDisplay();
+    display.fillRoundRect(eyeLx + dx, eyeLy + dy, eyeLwidthCurrent, eyeLheightCurrent, eyeLborderRadiusCurrent,
+                          SSD1306_WHITE);
+    display.fillRoundRect(eyeRx + dx, eyeRy + dy, eyeRwidthCurrent, eyeRheightCurrent, eyeRborderRadiusCurrent,
+                          SSD1306_WHITE);
+    if (eyelidsTiredHeight > 0 || eyelidsAngryHeight > 0) {
+      int lid = max(eyelidsTiredHeight, eyelidsAngryHeight);
+      display.fillRect(eyeLx + dx, eyeLy + dy - 1, eyeLwidthCurrent, lid, SSD1306_BLACK);
+      display.fillRect(eyeRx + dx, eyeRy + dy - 1, eyeRwidthCurrent, lid, SSD1306_BLACK);
+    }
+    if (eyelidsHappyBottomOffset > 0) {
+      display.fillRect(eyeLx + dx, eyeLy + dy + eyeLheightCurrent - eyelidsHappyBottomOffset, eyeLwidthCurrent,
+                       eyelidsHappyBottomOffset + 1, SSD1306_BLACK);
+      display.fillRect(eyeRx + dx, eyeRy + dy + eyeRheightCurrent - eyelidsHappyBottomOffset, eyeRwidthCurrent,
+                       eyelidsHappyBottomOffset + 1, SSD1306_BLACK);
+    }
+    display.display();
+  }
+
+private:
+  void placeRightEye() {
+    eyeRx = eyeRxNext = eyeLx + eyeLwidthCurrent + spaceBetweenDefault;
+    eyeRy = eyeRyNext = eyeLy;
+  }
+
+  // Blinks, idle glances and the confused and laugh shakes, on the library's timers
+  void runAnimations() {
+    unsigned long now = millis();
+    if (autoblinker && now >= blinktimer) {
+      blink();
+      blinktimer = now + blinkInterval * 1000UL + random(blinkIntervalVariation) * 1000UL;
+    }
+    if (idle && now >= idleAnimationTimer) {
+      int maxX = screenWidth - eyeLwidthCurrent - spaceBetweenDefault - eyeRwidthCurrent;
+      eyeLxNext = random(max(maxX, 1));
+      eyeLyNext = random(max(screenHeight - eyeLheightDefault, 1));
+      idleAnimationTimer = now + idleInterval * 1000UL + random(idleIntervalVariation) * 1000UL;
+    }
+    if (confused) {
+      if (confusedToggle) {
+        hFlicker = true;
+        confusedAnimationTimer = now;
+        confusedToggle = false;
+      } else if (now >= confusedAnimationTimer + confusedAnimationDuration) {
+        hFlicker = false;
+        confusedToggle = true;
+        confused = false;
+      }
+    }
+    if (laugh) {
+      if (laughToggle) {
+        vFlicker = true;
+        laughAnimationTimer = now;
+        laughToggle = false;
+      } else if (now >= laughAnimationTimer + laughAnimationDuration) {
+        vFlicker = false;
+        laughToggle = true;
+        laugh = false;
+      }
+    }
+  }
+};
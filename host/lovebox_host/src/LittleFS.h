@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+  Host stand-in for the core's FS API with LittleFS in RAM
+
+  Files live in a map for the life of the test program; hostWriteFile()
+  and hostReadFile() in host.h reach them from a test. A File keeps its
+  content alive, so a file removed while open reads on as on LittleFS.
+*/
+
+namespace fs {
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+typedef std::shared_ptr<std::vector<uint8_t>> FileData;
+
+class File : public Stream {
+public:
+  File() {}
+  File(const std::string& path, FileData data, bool writable, bool append);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t length) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  int read(uint8_t* buffer, size_t length);
+  void flush() override {}
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const { return pos; }
+  size_t size() const;
+  bool truncate(uint32_t size);
+  void close();
+  operator bool() const { return data != nullptr; }
+  const char* name() const;
+  const char* fullName() const { return path.c_str(); }
+  bool isDirectory() const { return false; }
+
+private:
+  std::string path;
+  FileData data;
+  size_t pos = 0;
+  bool writable = false;
+};
+
+class Dir {
+public:
+  Dir() {}
+  Dir(std::vector<std::string> names, std::string prefix) : names(names), prefix(prefix) {}
+
+  bool next();
+  String fileName();
+  size_t fileSize();
+  bool isFile() { return true; }
+  bool isDirectory() { return false; }
+
+private:
+  std::vector<std::string> names;  // full paths, in order
+  std::string prefix;
+  size_t index = 0;  // one past the current entry
+};
+
+struct FSInfo {
+  size_t totalBytes;
+  size_t usedBytes;
+  size_t blockSize;
+  size_t pageSize;
+  size_t maxOpenFiles;
+  size_t maxPathLength;
+};
+
+class FS {
+public:
+  bool begin() { return true; }
+  void end() {}
+  bool format();
+  bool info(FSInfo& info);
+  File open(const char* path, const char* mode);
+  File open(const String& path, const char* mode) { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+  Dir openDir(const char* path);
+  bool mkdir(const char* path) { return true; }
+
+  std::map<std::string, FileData> files;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::Dir;
+using fs::FS;
+using fs::FSInfo;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+extern fs::FS LittleFS;
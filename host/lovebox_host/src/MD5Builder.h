@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Arduino.h>
+
+class MD5Builder {
+public:
+  void begin();
+  void add(const uint8_t* data, size_t length);
+  bool addStream(Stream& stream, size_t maxLength);
+  void calculate();
+  void getBytes(uint8_t* output);
+  String toString();
+
+private:
+  void block(const uint8_t* data);
+
+  uint32_t state[4];
+  uint64_t total;
+  uint8_t pending[64];
+  uint8_t digest[16];
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+#include <MD5Builder.h>
+#include <vector>
+
+// The spare flash slot: what was written is kept in image and checked against setMD5() at end(),
+// which then leaves the eboot command in RTC memory as the core does
+class UpdaterClass {
+public:
+  bool begin(size_t size, int command = 0, int ledPin = -1, uint8_t ledOn = LOW);
+  bool setMD5(const char* expected);
+  size_t write(uint8_t* data, size_t length);
+  size_t writeStream(Stream& data);
+  bool end(bool evenIfRemaining = false);
+  bool isRunning() { return running; }
+  bool isFinished() { return running && image.size() == size; }
+  bool hasError() { return false; }
+  uint8_t getError() { return 0; }
+
+  std::vector<uint8_t> image;
+
+private:
+  bool running = false;
+  size_t size = 0;
+  char expectedMd5[33] = "";
+};
+
+extern UpdaterClass Update;
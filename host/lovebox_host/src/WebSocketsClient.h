@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+/*
+  A client with no server behind it. isConnected() is what the test set
+  with hostSetWebSocketConnected(); while connected, every frame sent is
+  kept in hostSentFrames(). Events reach the firmware from the trace, not
+  from here, so loop() does nothing.
+*/
+class WebSocketsClient {
+public:
+  typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+  void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino") {}
+  void loop() {}
+  void onEvent(WebSocketClientEvent event) {}
+  void setReconnectInterval(unsigned long time) {}
+  void disconnect();
+  bool isConnected();
+
+  bool sendTXT(const char* payload, size_t length = 0);
+  bool sendTXT(const String& payload) { return sendTXT(payload.c_str()); }
+  bool sendBIN(const uint8_t* payload, size_t length);
+  bool sendPing() { return isConnected(); }
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 128
+
+// The I2C bus with an SSD1306 on it: what the firmware sends lands in hostPanel()
+class TwoWire : public Stream {
+public:
+  void begin(int sda, int scl) {}
+  void begin() {}
+  void setClock(uint32_t frequency) {}
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t length) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+private:
+  uint8_t transmission[BUFFER_LENGTH];
+  size_t transmitted = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,330 @@
+#include <Arduino.h>
+#include <coredecls.h>
+#include <host.h>
+#include <MD5Builder.h>
+
+#define HOST_RTC_BYTES 512
+#define HOST_FREE_HEAP 40000
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static unsigned long nowMs = 0;
+static uint32_t nowUsOffset = 0;  // delayMicroseconds() below a millisecond
+static uint32_t pullups = 0;    // bit per pin
+static uint32_t pinsSet = 0;    // pins a test or the firmware drove
+static uint32_t pinLevels = 0;
+static uint32_t randomState = 1;
+static std::string serialIn;
+static std::string serialOut;
+static uint32_t rtcMemory[HOST_RTC_BYTES / 4];
+static rst_info resetInfo;
+static std::vector<uint8_t> sketch;
+
+void hostAdvance(unsigned long ms) {
+  nowMs += ms;
+}
+
+void hostSetPin(uint8_t pin, int level) {
+  if (pin < 32) {
+    pinsSet |= 1UL << pin;
+    pinLevels = level == HIGH ? pinLevels | 1UL << pin : pinLevels & ~(1UL << pin);
+  }
+}
+
+void hostSetResetReason(uint32_t reason) {
+  resetInfo.reason = reason;
+}
+
+void hostSetSketch(const std::vector<uint8_t>& image) {
+  sketch = image;
+}
+
+void hostSerialInput(const char* text) {
+  serialIn += text;
+}
+
+std::string& hostSerialOutput() {
+  return serialOut;
+}
+
+unsigned long millis() {
+  return nowMs;
+}
+
+unsigned long micros() {
+  return nowMs * 1000UL + nowUsOffset;
+}
+
+void delay(unsigned long ms) {
+  nowMs += ms;
+}
+
+void delayMicroseconds(unsigned int us) {
+  nowUsOffset += us;
+  nowMs += nowUsOffset / 1000;
+  nowUsOffset %= 1000;
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < 32) {
+    pullups = mode == INPUT_PULLUP ? pullups | 1UL << pin : pullups & ~(1UL << pin);
+  }
+}
+
+// A pin nobody drove reads as idle: pulled up HIGH, otherwise LOW
+int digitalRead(uint8_t pin) {
+  if (pin >= 32) {
+    return LOW;
+  }
+  uint32_t bit = 1UL << pin;
+  return (pinsSet & bit ? pinLevels : pullups) & bit ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  hostSetPin(pin, level);
+}
+
+// The same sequence on every host, unlike rand()
+long random(long howbig) {
+  if (howbig <= 0) {
+    return 0;
+  }
+  randomState = randomState * 1103515245UL + 12345UL;
+  return (randomState >> 1) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) {
+    return howsmall;
+  }
+  return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    randomState = seed;
+  }
+}
+
+// The clock is whatever the trace says; nothing to sync with
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2,
+                const char* server3) {}
+
+int snprintf_P(char* buffer, size_t size, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int length = vsnprintf(buffer, size, fmt, args);
+  va_end(args);
+  return length;
+}
+
+#if defined(__GLIBC__) && !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dest, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = min(length, size - 1);
+    memcpy(dest, src, n);
+    dest[n] = '\0';
+  }
+  return length;
+}
+#endif
+
+size_t Print::write(const uint8_t* data, size_t length) {
+  size_t n = 0;
+  while (length-- > 0) {
+    n += write(*data++);
+  }
+  return n;
+}
+
+size_t Print::printf(const char* fmt, ...) {
+  char line[512];
+  va_list args;
+  va_start(args, fmt);
+  int length = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  return write((const uint8_t*)line, min<size_t>(max(length, 0), sizeof(line) - 1));
+}
+
+size_t Print::printf_P(PGM_P fmt, ...) {
+  char line[512];
+  va_list args;
+  va_start(args, fmt);
+  int length = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  return write((const uint8_t*)line, min<size_t>(max(length, 0), sizeof(line) - 1));
+}
+
+// Streams on the host never wait for more input
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+  size_t n = 0;
+  int c;
+  while (n < length && (c = read()) >= 0) {
+    buffer[n++] = c;
+  }
+  return n;
+}
+
+long Stream::parseInt() {
+  while (available() > 0 && peek() != '-' && (peek() < '0' || peek() > '9')) {
+    read();
+  }
+  bool negative = available() > 0 && peek() == '-';
+  if (negative) {
+    read();
+  }
+  long value = 0;
+  while (available() > 0 && peek() >= '0' && peek() <= '9') {
+    value = value * 10 + (read() - '0');
+  }
+  return negative ? -value : value;
+}
+
+String Stream::readStringUntil(char terminator) {
+  std::string text;
+  int c;
+  while ((c = read()) >= 0 && c != terminator) {
+    text += (char)c;
+  }
+  return String(text.c_str());
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  serialOut += (char)c;
+  return 1;
+}
+
+int HardwareSerial::available() {
+  return serialIn.size();
+}
+
+int HardwareSerial::read() {
+  if (serialIn.empty()) {
+    return -1;
+  }
+  uint8_t c = serialIn[0];
+  serialIn.erase(0, 1);
+  return c;
+}
+
+int HardwareSerial::peek() {
+  return serialIn.empty() ? -1 : (uint8_t)serialIn[0];
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return HOST_FREE_HEAP;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() {
+  return HOST_FREE_HEAP;
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+  return 0;
+}
+
+void EspClass::getHeapStats(uint32_t* free, uint16_t* max, uint8_t* frag) {
+  uint32_t maxBlock;
+  getHeapStats(free, &maxBlock, frag);
+  if (max) {
+    *max = maxBlock;
+  }
+}
+
+void EspClass::getHeapStats(uint32_t* free, uint32_t* max, uint8_t* frag) {
+  if (free) {
+    *free = HOST_FREE_HEAP;
+  }
+  if (max) {
+    *max = HOST_FREE_HEAP;
+  }
+  if (frag) {
+    *frag = 0;
+  }
+}
+
+// The hardware generator on the device; a fixed sequence of its own here
+uint32_t EspClass::random() {
+  static uint32_t state = 0x2545F491;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// offset counts 4 byte blocks, size bytes, as on the device
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset * 4 + size > HOST_RTC_BYTES) {
+    return false;
+  }
+  memcpy(data, (uint8_t*)rtcMemory + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+  if (offset * 4 + size > HOST_RTC_BYTES) {
+    return false;
+  }
+  memcpy((uint8_t*)rtcMemory + offset * 4, data, size);
+  return true;
+}
+
+rst_info* EspClass::getResetInfoPtr() {
+  return &resetInfo;
+}
+
+void EspClass::restart() {
+  throw HostRestart();
+}
+
+uint32_t EspClass::getSketchSize() {
+  return sketch.size();
+}
+
+String EspClass::getSketchMD5() {
+  MD5Builder md5;
+  md5.begin();
+  md5.add(sketch.data(), sketch.size());
+  md5.calculate();
+  return md5.toString();
+}
+
+bool EspClass::flashRead(uint32_t address, uint8_t* data, size_t size) {
+  if (address > sketch.size() || size > sketch.size() - address) {
+    return false;
+  }
+  memcpy(data, sketch.data() + address, size);
+  return true;
+}
+
+// Kept by umm_malloc on the device; the host heap has no low watermark to report
+extern "C" size_t umm_free_heap_size_min(void) {
+  return HOST_FREE_HEAP;
+}
+
+extern "C" size_t umm_free_heap_size_min_reset(void) {
+  return HOST_FREE_HEAP;
+}
+
+// The core's CRC-32 (polynomial 0x04C11DB7, MSB first, no final inversion)
+uint32_t crc32(const void* data, size_t length, uint32_t crc) {
+  const uint8_t* p = (const uint8_t*)data;
+  while (length--) {
+    uint8_t c = *p++;
+    for (uint32_t i = 0x80; i > 0; i >>= 1) {
+      bool bit = crc & 0x80000000;
+      if (c & i) {
+        bit = !bit;
+      }
+      crc <<= 1;
+      if (bit) {
+        crc ^= 0x04c11db7;
+      }
+    }
+  }
+  return crc;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0xffffffff);
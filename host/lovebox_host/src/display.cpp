@@ -0,0 +1,370 @@
+#include <Adafruit_SSD1306.h>
+#include <host.h>
+#include <math.h>
+
+#define PANEL_WIDTH 128
+#define PANEL_PAGES 8
+
+TwoWire Wire;
+
+// SSD1306 RAM as the controller holds it, written by the I2C traffic
+static uint8_t panel[PANEL_WIDTH * PANEL_PAGES];
+static uint8_t columnStart = 0, columnEnd = PANEL_WIDTH - 1, column = 0;
+static uint8_t pageStart = 0, pageEnd = PANEL_PAGES - 1, page = 0;
+
+const uint8_t* hostPanel() {
+  return panel;
+}
+
+// Argument bytes that follow each SSD1306 command the Adafruit driver sends
+static uint8_t commandArguments(uint8_t command) {
+  switch (command) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+    case 0x21: case 0x22: case 0xA3:
+      return 2;
+    case 0x29: case 0x2A:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+    default:
+      return 0;
+  }
+}
+
+static void panelCommands(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    uint8_t command = *data;
+    uint8_t arguments = commandArguments(command);
+    if (length < 1U + arguments) {
+      return;
+    }
+    if (command == SSD1306_COLUMNADDR) {
+      columnStart = column = min<uint8_t>(data[1], PANEL_WIDTH - 1);
+      columnEnd = min<uint8_t>(data[2], PANEL_WIDTH - 1);
+    } else if (command == SSD1306_PAGEADDR) {
+      pageStart = page = min<uint8_t>(data[1], PANEL_PAGES - 1);
+      pageEnd = min<uint8_t>(data[2], PANEL_PAGES - 1);
+    }
+    data += 1 + arguments;
+    length -= 1 + arguments;
+  }
+}
+
+// Horizontal addressing: along the column window, then on to the next page
+static void panelData(const uint8_t* data, size_t length) {
+  while (length-- > 0) {
+    panel[page * PANEL_WIDTH + column] = *data++;
+    if (column < columnEnd) {
+      column++;
+      continue;
+    }
+    column = columnStart;
+    page = page < pageEnd ? page + 1 : pageStart;
+  }
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  transmitted = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  if (transmitted > 0 && transmission[0] == 0x00) {
+    panelCommands(transmission + 1, transmitted - 1);
+  } else if (transmitted > 0 && transmission[0] == 0x40) {
+    panelData(transmission + 1, transmitted - 1);
+  }
+  transmitted = 0;
+  return 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (transmitted == sizeof(transmission)) {
+    return 0;
+  }
+  transmission[transmitted++] = c;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+  size_t n = 0;
+  while (n < length && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  for (int16_t i = 0; i < h; i++) {
+    drawPixel(x, y + i, color);
+  }
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  for (int16_t i = 0; i < w; i++) {
+    drawPixel(x + i, y, color);
+  }
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t i = x; i < x + w; i++) {
+    drawFastVLine(i, y, h, color);
+  }
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+  int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int16_t err = dx + dy;
+  while (true) {
+    drawPixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1) {
+      return;
+    }
+    int16_t e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+  int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+  drawPixel(x0, y0 + r, color);
+  drawPixel(x0, y0 - r, color);
+  drawPixel(x0 + r, y0, color);
+  drawPixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    drawPixel(x0 + x, y0 + y, color);
+    drawPixel(x0 - x, y0 + y, color);
+    drawPixel(x0 + x, y0 - y, color);
+    drawPixel(x0 - x, y0 - y, color);
+    drawPixel(x0 + y, y0 + x, color);
+    drawPixel(x0 - y, y0 + x, color);
+    drawPixel(x0 + y, y0 - x, color);
+    drawPixel(x0 - y, y0 - x, color);
+  }
+}
+
+// Vertical spans of the right (corners & 1) and left (corners & 2) halves of a circle
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta,
+                                    uint16_t color) {
+  int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+  int16_t px = x, py = y;
+  delta++;
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < y + 1) {
+      if (corners & 1) drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      if (corners & 2) drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+    }
+    if (y != py) {
+      if (corners & 1) drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      if (corners & 2) drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+  drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+  if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+  if (y0 == y2) {
+    int16_t a = min(x0, min(x1, x2)), b = max(x0, max(x1, x2));
+    drawFastHLine(a, y0, b - a + 1, color);
+    return;
+  }
+  for (int16_t y = y0; y <= y2; y++) {
+    // x on the long edge, and on whichever short edge spans this row
+    int16_t a = x0 + (int32_t)(x2 - x0) * (y - y0) / (y2 - y0);
+    int16_t b = y < y1 || y1 == y2 ? (y1 == y0 ? x1 : x0 + (int32_t)(x1 - x0) * (y - y0) / (y1 - y0))
+                                   : x1 + (int32_t)(x2 - x1) * (y - y1) / (y2 - y1);
+    if (a > b) {
+      std::swap(a, b);
+    }
+    drawFastHLine(a, y, b - a + 1, color);
+  }
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  r = min<int16_t>(r, min(w, h) / 2);
+  drawFastHLine(x + r, y, w - 2 * r, color);
+  drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  drawFastVLine(x, y + r, h - 2 * r, color);
+  drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+  for (int16_t i = 0; i <= r; i++) {
+    // a quarter circle per corner, one pixel per row is close enough for tests
+    int16_t dx = r - (int16_t)sqrt((double)(r * r - (r - i) * (r - i)));
+    drawPixel(x + dx, y + i, color);
+    drawPixel(x + w - 1 - dx, y + i, color);
+    drawPixel(x + dx, y + h - 1 - i, color);
+    drawPixel(x + w - 1 - dx, y + h - 1 - i, color);
+  }
+}
+
+void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  r = min<int16_t>(r, min(w, h) / 2);
+  fillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h,
+                              uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8;
+  for (int16_t j = 0; j < h; j++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (pgm_read_byte(&bitmap[j * byteWidth + i / 8]) & (0x80 >> (i & 7))) {
+        drawPixel(x + i, y + j, color);
+      }
+    }
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char* string, int16_t x, int16_t y, int16_t* x1, int16_t* y1,
+                                 uint16_t* w, uint16_t* h) {
+  *x1 = x;
+  *y1 = y;
+  *w = strlen(string) * 6 * textsize_x;
+  *h = 8 * textsize_y;
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += 8 * textsize_y;
+  } else if (c != '\r') {
+    if (wrap && cursor_x + 6 * textsize_x > _width) {
+      cursor_x = 0;
+      cursor_y += 8 * textsize_y;
+    }
+    cursor_x += 6 * textsize_x;
+  }
+  return 1;
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+  : Adafruit_GFX(w, h), wire(twi), wireClk(clkDuring), restoreClk(clkAfter) {}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t addr, bool reset, bool periphBegin) {
+  if (!buffer && !(buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8)))) {
+    return false;
+  }
+  clearDisplay();
+  i2caddr = addr ? addr : (HEIGHT == 32 ? 0x3C : 0x3D);
+  static const uint8_t init[] = { 0xAE, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D, 0x14, 0x20, 0x00,
+                                  0xA1, 0xC8, 0xDA, 0x12, 0x81, 0xCF, 0xD9, 0xF1, 0xDB, 0x40, 0xA4, 0xA6,
+                                  0x2E, 0xAF };
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  wire->write(init, sizeof(init));
+  wire->endTransmission();
+  return true;
+}
+
+// The whole buffer, a page per transaction as the library sends it
+void Adafruit_SSD1306::display() {
+  static const uint8_t window[] = { SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, 127 };
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  wire->write(window, sizeof(window));
+  wire->endTransmission();
+  size_t size = WIDTH * ((HEIGHT + 7) / 8);
+  for (size_t sent = 0; sent < size;) {
+    size_t chunk = min<size_t>(BUFFER_LENGTH - 1, size - sent);
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);
+    wire->write(buffer + sent, chunk);
+    wire->endTransmission();
+    sent += chunk;
+  }
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= _width || y < 0 || y >= _height) {
+    return;
+  }
+  uint8_t* b = &buffer[x + (y / 8) * WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+    case SSD1306_WHITE: *b |= bit; break;
+    case SSD1306_BLACK: *b &= ~bit; break;
+    case SSD1306_INVERSE: *b ^= bit; break;
+  }
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  Adafruit_GFX::drawFastHLine(x, y, w, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  Adafruit_GFX::drawFastVLine(x, y, h, color);
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  wire->write(c);
+  wire->endTransmission();
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (x < 0 || x >= _width || y < 0 || y >= _height) {
+    return false;
+  }
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
+
+uint8_t* Adafruit_SSD1306::getBuffer() {
+  return buffer;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+/*
+  What a native test steers and reads back
+
+  The firmware runs unchanged against the stand-ins in this library; a
+  test drives it through these. The clock starts at 0 and only moves
+  with hostAdvance() and delay(). Nothing is reset between tests, the
+  firmware's statics could not be anyway: one test program is one boot.
+*/
+
+// Thrown by ESP.restart(), which ends the run
+struct HostRestart {};
+
+struct HostFrame {
+  bool binary;
+  std::string payload;
+};
+
+void hostAdvance(unsigned long ms);
+
+void hostSetPin(uint8_t pin, int level);
+void hostSetResetReason(uint32_t reason);
+void hostSetSketch(const std::vector<uint8_t>& image);
+void hostSerialInput(const char* text);
+std::string& hostSerialOutput();
+
+void hostSetWifiStatus(uint8_t status);
+void hostSetWebSocketConnected(bool connected);
+std::vector<HostFrame>& hostSentFrames();
+
+void hostFormatFs();
+bool hostWriteFile(const char* path, const void* data, size_t length);
+bool hostReadFile(const char* path, std::string& data);
+
+const uint8_t* hostPanel();
+
+// True while RTC user words 0-31 hold the eboot command Update.end() left there
+bool hostEbootCommandValid();
@@ -0,0 +1,196 @@
+#include <LittleFS.h>
+#include <host.h>
+
+#define HOST_FS_BYTES 1024000
+#define HOST_FS_BLOCK 8192
+
+fs::FS LittleFS;
+
+namespace fs {
+
+File::File(const std::string& path, FileData data, bool writable, bool append)
+  : path(path), data(data), pos(append ? data->size() : 0), writable(writable) {}
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+  if (!data || !writable) {
+    return 0;
+  }
+  if (data->size() < pos + length) {
+    data->resize(pos + length);
+  }
+  memcpy(data->data() + pos, buffer, length);
+  pos += length;
+  return length;
+}
+
+int File::available() {
+  return data ? data->size() - pos : 0;
+}
+
+int File::read() {
+  if (!data || pos >= data->size()) {
+    return -1;
+  }
+  return (*data)[pos++];
+}
+
+int File::peek() {
+  if (!data || pos >= data->size()) {
+    return -1;
+  }
+  return (*data)[pos];
+}
+
+int File::read(uint8_t* buffer, size_t length) {
+  if (!data) {
+    return -1;
+  }
+  size_t n = min(length, data->size() - min(pos, data->size()));
+  memcpy(buffer, data->data() + pos, n);
+  pos += n;
+  return n;
+}
+
+bool File::seek(uint32_t offset, SeekMode mode) {
+  if (!data) {
+    return false;
+  }
+  size_t target = mode == SeekSet ? offset : mode == SeekCur ? pos + offset : data->size() + offset;
+  if (target > data->size()) {
+    return false;
+  }
+  pos = target;
+  return true;
+}
+
+size_t File::size() const {
+  return data ? data->size() : 0;
+}
+
+bool File::truncate(uint32_t length) {
+  if (!data || !writable || length > data->size()) {
+    return false;
+  }
+  data->resize(length);
+  pos = min<size_t>(pos, length);
+  return true;
+}
+
+void File::close() {
+  data.reset();
+}
+
+const char* File::name() const {
+  size_t slash = path.rfind('/');
+  return path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+bool Dir::next() {
+  return ++index <= names.size();
+}
+
+String Dir::fileName() {
+  return String(names[index - 1].c_str() + prefix.size());
+}
+
+size_t Dir::fileSize() {
+  auto file = LittleFS.files.find(names[index - 1]);
+  return file == LittleFS.files.end() ? 0 : file->second->size();
+}
+
+bool FS::format() {
+  files.clear();
+  return true;
+}
+
+// Every file takes whole blocks, plus two for the superblocks
+bool FS::info(FSInfo& info) {
+  info.totalBytes = HOST_FS_BYTES;
+  info.usedBytes = 2 * HOST_FS_BLOCK;
+  for (auto& file : files) {
+    info.usedBytes += (file.second->size() + HOST_FS_BLOCK - 1) / HOST_FS_BLOCK * HOST_FS_BLOCK;
+  }
+  info.blockSize = HOST_FS_BLOCK;
+  info.pageSize = 256;
+  info.maxOpenFiles = 5;
+  info.maxPathLength = 32;
+  return true;
+}
+
+// "r", "w", "a" and their "+" forms, as fopen() takes them
+File FS::open(const char* path, const char* mode) {
+  auto found = files.find(path);
+  bool plus = strchr(mode, '+') != nullptr;
+  if (mode[0] == 'r') {
+    if (found == files.end()) {
+      return File();
+    }
+    return File(path, found->second, plus, false);
+  }
+  if (mode[0] != 'w' && mode[0] != 'a') {
+    return File();
+  }
+  if (found == files.end() || mode[0] == 'w') {
+    // a fresh vector: a File still open on the old content keeps it
+    found = files.insert_or_assign(path, std::make_shared<std::vector<uint8_t>>()).first;
+  }
+  return File(path, found->second, true, mode[0] == 'a');
+}
+
+bool FS::exists(const char* path) {
+  return files.count(path) > 0;
+}
+
+bool FS::remove(const char* path) {
+  return files.erase(path) > 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  auto found = files.find(from);
+  if (found == files.end()) {
+    return false;
+  }
+  FileData data = found->second;
+  files.erase(found);
+  files[to] = data;
+  return true;
+}
+
+// The files directly in path; LittleFS lists them by name too
+Dir FS::openDir(const char* path) {
+  std::string prefix = path;
+  if (prefix.empty() || prefix.back() != '/') {
+    prefix += '/';
+  }
+  std::vector<std::string> names;
+  for (auto& file : files) {
+    if (file.first.compare(0, prefix.size(), prefix) == 0 && file.first.find('/', prefix.size()) == std::string::npos) {
+      names.push_back(file.first);
+    }
+  }
+  return Dir(names, prefix);
+}
+
+}  // namespace fs
+
+void hostFormatFs() {
+  LittleFS.format();
+}
+
+bool hostWriteFile(const char* path, const void* data, size_t length) {
+  File file = LittleFS.open(path, "w");
+  return file && file.write((const uint8_t*)data, length) == length;
+}
+
+bool hostReadFile(const char* path, std::string& data) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    return false;
+  }
+  data.assign(file.size(), '\0');
+  return file.read((uint8_t*)&data[0], data.size()) == (int)data.size();
+}
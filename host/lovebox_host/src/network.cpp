@@ -0,0 +1,88 @@
+#include <ESP8266WiFi.h>
+#include <ESPAsyncWebServer.h>
+#include <WebSocketsClient.h>
+#include <host.h>
+
+ESP8266WiFiClass WiFi;
+
+static wl_status_t wifiStatus = WL_DISCONNECTED;
+static uint8_t bssid[6];
+static bool webSocketConnected = false;
+static std::vector<HostFrame> sentFrames;
+
+void hostSetWifiStatus(uint8_t status) {
+  wifiStatus = (wl_status_t)status;
+}
+
+void hostSetWebSocketConnected(bool connected) {
+  webSocketConnected = connected;
+}
+
+std::vector<HostFrame>& hostSentFrames() {
+  return sentFrames;
+}
+
+String IPAddress::toString() const {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+  return String(text);
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel,
+                                    const uint8_t* bssid, bool connect) {
+  return wifiStatus;
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  return wifiStatus;
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+  return wifiStatus == WL_CONNECTED ? IPAddress(192, 168, 1, 2) : IPAddress();
+}
+
+int32_t ESP8266WiFiClass::RSSI() {
+  return wifiStatus == WL_CONNECTED ? -60 : 31;  // 31 is what the SDK reports with no connection
+}
+
+uint8_t* ESP8266WiFiClass::BSSID() {
+  return bssid;
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)> handler) {
+  return std::make_shared<WiFiEventHandlerOpaque>();
+}
+
+WiFiEventHandler ESP8266WiFiClass::onStationModeDisconnected(
+    std::function<void(const WiFiEventStationModeDisconnected&)> handler) {
+  return std::make_shared<WiFiEventHandlerOpaque>();
+}
+
+void WebSocketsClient::disconnect() {
+  webSocketConnected = false;
+}
+
+bool WebSocketsClient::isConnected() {
+  return webSocketConnected;
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+  if (!webSocketConnected) {
+    return false;
+  }
+  sentFrames.push_back({ false, std::string(payload, length ? length : strlen(payload)) });
+  return true;
+}
+
+bool WebSocketsClient::sendBIN(const uint8_t* payload, size_t length) {
+  if (!webSocketConnected) {
+    return false;
+  }
+  sentFrames.push_back({ true, std::string((const char*)payload, length) });
+  return true;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) const {
+  static AsyncWebParameter none;
+  return &none;
+}
@@ -0,0 +1,214 @@
+#include <Updater.h>
+#include <MD5Builder.h>
+#include <coredecls.h>
+#include <host.h>
+#include <stddef.h>
+
+#define EBOOT_MAGIC 0xeb001000UL
+#define EBOOT_MAGIC_MASK 0xfffff000UL
+#define EBOOT_ACTION_COPY_RAW 0x00000002UL
+#define EBOOT_SPARE_SLOT 0x100000UL  // where the host pretends the new image was written
+
+UpdaterClass Update;
+
+// The core's eboot_command, 32 words at the start of user RTC memory
+struct EbootCommand {
+  uint32_t magic;
+  uint32_t action;
+  uint32_t args[29];
+  uint32_t crc32;
+};
+
+static_assert(sizeof(EbootCommand) == 128, "eboot_command is 32 words");
+
+// As eboot_command_write(): copy the spare slot over the running image on the next boot
+static void writeEbootCommand(uint32_t imageSize) {
+  EbootCommand command = {};
+  command.magic = EBOOT_MAGIC;
+  command.action = EBOOT_ACTION_COPY_RAW;
+  command.args[0] = EBOOT_SPARE_SLOT;
+  command.args[1] = 0;
+  command.args[2] = imageSize;
+  command.crc32 = crc32(&command, offsetof(EbootCommand, crc32));
+  ESP.rtcUserMemoryWrite(0, (uint32_t*)&command, sizeof(command));
+}
+
+bool hostEbootCommandValid() {
+  EbootCommand command;
+  ESP.rtcUserMemoryRead(0, (uint32_t*)&command, sizeof(command));
+  return (command.magic & EBOOT_MAGIC_MASK) == EBOOT_MAGIC && command.action == EBOOT_ACTION_COPY_RAW &&
+         command.crc32 == crc32(&command, offsetof(EbootCommand, crc32));
+}
+
+static const uint32_t shifts[64] = {
+  7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+  5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+  4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+  6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+};
+
+static const uint32_t sines[64] = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+void MD5Builder::begin() {
+  state[0] = 0x67452301;
+  state[1] = 0xefcdab89;
+  state[2] = 0x98badcfe;
+  state[3] = 0x10325476;
+  total = 0;
+}
+
+// RFC 1321, one 64 byte block
+void MD5Builder::block(const uint8_t* data) {
+  uint32_t m[16];
+  for (int i = 0; i < 16; i++) {
+    m[i] = data[i * 4] | data[i * 4 + 1] << 8 | data[i * 4 + 2] << 16 | (uint32_t)data[i * 4 + 3] << 24;
+  }
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  for (int i = 0; i < 64; i++) {
+    uint32_t f, g;
+    if (i < 16) {
+      f = (b & c) | (~b & d);
+      g = i;
+    } else if (i < 32) {
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) % 16;
+    } else if (i < 48) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) % 16;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * i) % 16;
+    }
+    f += a + sines[i] + m[g];
+    a = d;
+    d = c;
+    c = b;
+    b += f << shifts[i] | f >> (32 - shifts[i]);
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+}
+
+void MD5Builder::add(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    size_t used = total % 64;
+    size_t n = min<size_t>(64 - used, length);
+    memcpy(pending + used, data, n);
+    total += n;
+    data += n;
+    length -= n;
+    if (total % 64 == 0) {
+      block(pending);
+    }
+  }
+}
+
+bool MD5Builder::addStream(Stream& stream, size_t maxLength) {
+  uint8_t buffer[256];
+  while (maxLength > 0) {
+    size_t n = stream.readBytes(buffer, min(maxLength, sizeof(buffer)));
+    if (n == 0) {
+      return false;
+    }
+    add(buffer, n);
+    maxLength -= n;
+  }
+  return true;
+}
+
+void MD5Builder::calculate() {
+  uint64_t bits = total * 8;
+  uint8_t padding[72] = { 0x80 };
+  size_t used = total % 64;
+  add(padding, used < 56 ? 56 - used : 120 - used);
+  uint8_t length[8];
+  for (int i = 0; i < 8; i++) {
+    length[i] = bits >> (8 * i);
+  }
+  add(length, 8);
+  for (int i = 0; i < 16; i++) {
+    digest[i] = state[i / 4] >> (8 * (i % 4));
+  }
+}
+
+void MD5Builder::getBytes(uint8_t* output) {
+  memcpy(output, digest, 16);
+}
+
+String MD5Builder::toString() {
+  char hex[33];
+  for (int i = 0; i < 16; i++) {
+    snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+  }
+  return String(hex);
+}
+
+bool UpdaterClass::begin(size_t imageSize, int command, int ledPin, uint8_t ledOn) {
+  if (running || imageSize == 0) {
+    return false;
+  }
+  running = true;
+  size = imageSize;
+  image.clear();
+  expectedMd5[0] = '\0';
+  return true;
+}
+
+bool UpdaterClass::setMD5(const char* expected) {
+  if (strlen(expected) != 32) {
+    return false;
+  }
+  strcpy(expectedMd5, expected);
+  return true;
+}
+
+size_t UpdaterClass::write(uint8_t* data, size_t length) {
+  if (!running || length > size - image.size()) {
+    return 0;
+  }
+  image.insert(image.end(), data, data + length);
+  return length;
+}
+
+size_t UpdaterClass::writeStream(Stream& data) {
+  uint8_t buffer[256];
+  size_t written = 0;
+  size_t n;
+  while (running && (n = data.readBytes(buffer, min(sizeof(buffer), size - image.size()))) > 0) {
+    written += write(buffer, n);
+  }
+  return written;
+}
+
+// Unfinished, or with the wrong MD5, the update is dropped as on the device
+bool UpdaterClass::end(bool evenIfRemaining) {
+  if (!running) {
+    return false;
+  }
+  running = false;
+  if (image.size() != size && !evenIfRemaining) {
+    return false;
+  }
+  if (expectedMd5[0] != '\0') {
+    MD5Builder md5;
+    md5.begin();
+    md5.add(image.data(), image.size());
+    md5.calculate();
+    if (md5.toString() != expectedMd5) {
+      return false;
+    }
+  }
+  writeEbootCommand(image.size());
+  return true;
+}
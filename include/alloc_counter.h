@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Allocation-counting test hook
+
+  Built with LOVEBOX_ALLOC_HOOK and the linker wrapping malloc, calloc and
+  realloc (see platformio.ini), every heap allocation made through them is
+  counted, including String growth and operator new. allocCheckTick() runs
+  at the top of loop(), attributes the allocations since its previous call
+  to the loop() pass that just ended, and once a minute reports how many
+  passes allocated at all. A steady-state device should report 0.
+
+  Without the flag the hook compiles out completely.
+*/
+
+#define ALLOC_REPORT_INTERVAL_MS 60000
+
+#ifdef LOVEBOX_ALLOC_HOOK
+uint32_t allocationCount();
+void allocCheckTick();
+#else
+inline uint32_t allocationCount() { return 0; }
+inline void allocCheckTick() {}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Timeline animation engine
+
+  An Animation is plain data: a PROGMEM table of (bitmap, duration) frames,
+  a playback mode, a pass count and an eased position offset. Playback is
+  ticked from loop() instead of blocking in delay(), and every frame is
+  scheduled against an absolute deadline (start + sum of durations), so slow
+  draws or bus flushes never make the animation drift. If a tick arrives
+  late by more than a frame, the missed frames are skipped rather than
+  played back slowly.
+*/
+
+enum AnimationPlayback : uint8_t {
+  PLAY_ONCE,      // frames 0..n-1, then stop
+  PLAY_LOOP,      // 0..n-1, 0..n-1, ...
+  PLAY_PINGPONG   // 0..n-1..1, 0..n-1..1, ...
+};
+
+enum AnimationEasing : uint8_t {
+  EASE_LINEAR,
+  EASE_IN_QUAD,
+  EASE_OUT_QUAD,
+  EASE_IN_OUT_QUAD
+};
+
+enum AnimationLayout : uint8_t {
+  LAYOUT_ROWS,    // drawBitmap() format, row after row
+  LAYOUT_PAGES    // SSD1306 page layout, drawn with blitPages()
+};
+
+struct AnimationFrame {
+  const unsigned char* bitmap;  // PROGMEM, width x height, 1 bit per pixel
+  uint16_t durationMs;
+};
+
+struct Animation {
+  const AnimationFrame* frames;  // PROGMEM
+  uint8_t frameCount;
+  uint8_t width;
+  uint8_t height;
+  AnimationLayout layout;
+  AnimationPlayback playback;
+  uint8_t passes;                // PLAY_LOOP / PLAY_PINGPONG: 0 plays until stopped
+  // Offset eased from "from" to "to" over every pass; PLAY_PINGPONG runs
+  // every other pass backwards
+  int8_t fromX, fromY;
+  int8_t toX, toY;
+  AnimationEasing easing;
+};
+
+struct AnimationStats {
+  uint32_t framesShown;
+  uint32_t framesSkipped;
+  uint32_t maxLateMs;
+};
+
+extern AnimationStats animationStats;
+
+extern const Animation messageRevealAnimation;
+
+void startAnimation(const Animation* animation);
+bool animationTick();
+void stopAnimation();
+bool isAnimationPlaying();
+void showAnimationFrame(const Animation* animation, uint8_t frameIndex);
+#ifdef LOVEBOX_BENCH
+void benchmarkAnimationDraw();
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  LittleFS asset sync
+
+  The server owns a set of assets (index.html, the glyph atlas, ...) and
+  describes them in a manifest, sent as a BINARY_MANIFEST frame:
+
+    count (u8), then count * { path length (u8), path, size (u32), MD5 (16 bytes) }
+
+  The last manifest fully applied is kept as ASSET_MANIFEST_PATH and its
+  MD5 is reported on every connection ({"type": "assets", "manifest": ...}),
+  so the server only sends a manifest when something changed.
+
+  A new manifest is stored as ASSET_NEXT_PATH and walked one entry per
+  loop() pass. An asset whose size and MD5 already match is left alone;
+  only changed ones are requested, ASSET_CHUNK_SIZE bytes at a time:
+
+    {"type": "asset", "path": "/index.html", "offset": N, "length": ASSET_CHUNK_SIZE}
+
+  answered by BINARY_ASSET frames: the first 4 bytes of the asset's MD5,
+  offset (u32), data. Chunks are appended to ASSET_PART_PREFIX<md5>, which
+  survives disconnects and reboots, so a transfer resumes where it
+  stopped. A complete file is checked against its MD5 and renamed over the
+  old one, which LittleFS does atomically. Assets dropped from the
+  manifest are deleted once every file is in place. Device state (the
+  message, stats, credentials, delivery and update state) is never
+  touched.
+*/
+
+#define ASSET_MANIFEST_PATH "/assets.manifest"
+#define ASSET_NEXT_PATH "/assets.next"
+#define ASSET_PART_PREFIX "/part-"
+#define ASSET_MANIFEST_MAX 1024
+#define ASSET_PATH_MAX 31  // LittleFS name limit
+#define ASSET_CHUNK_SIZE 1024
+#define ASSET_REQUEST_TIMEOUT_MS 5000
+
+struct AssetSyncStats {
+  uint32_t syncs;
+  uint32_t filesChecked;
+  uint32_t filesUpdated;
+  uint32_t filesDeleted;
+  uint32_t bytesDownloaded;
+  uint32_t resumedBytes;   // already on flash from an interrupted transfer
+  uint32_t hashFailures;
+};
+
+extern AssetSyncStats assetSyncStats;
+
+void beginAssetSync();
+void assetSyncConnected();
+void receiveManifest(const uint8_t* payload, size_t length);
+void receiveAssetChunk(const uint8_t* payload, size_t length);
+void assetSyncTick();
+bool isAssetSyncRunning();
+void printAssetReport();
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+  Binary WebSocket messages
+
+  Text frames carry the JSON messages handled by processJson(). Binary
+  frames carry content the server has already rendered, so the device only
+  copies it into place. Every binary frame starts with two bytes:
+
+    [type] [flags] [payload ...]
+
+  Multi-byte fields are little endian.
+
+  BINARY_IMAGE   seq (u32), then a full 128x64 frame in the SSD1306 page
+                 layout: 1024 bytes, or PackBits compressed when
+                 BINARY_FLAG_PACKBITS is set. Stored and acknowledged like
+                 a text message.
+
+  BINARY_STREAM  stream (u8), frame (u16), duration in ms (u16), then
+                 with BINARY_FLAG_KEYFRAME a full frame as for BINARY_IMAGE,
+                 otherwise an XOR delta against the previous frame of the
+                 stream: repeated [skip (u8)] [count (u8)] [count bytes],
+                 i.e. leave skip bytes of the frame as they are and XOR the
+                 next count bytes. A run of more than 255 unchanged bytes
+                 is written as 255, 0. BINARY_FLAG_STREAM_END marks the
+                 last frame. Live content, neither stored nor acknowledged.
+
+  BINARY_DOODLE  seq (u32), then stroke commands (see doodle.h). Stored
+                 and acknowledged like a text message.
+
+  BINARY_OTA     offset (u32) into a firmware delta file, then the next
+                 bytes of it. Answered with the offset expected next, see
+                 ota_update.h.
+
+  BINARY_MANIFEST  the server's asset manifest, see asset_sync.h.
+
+  BINARY_ASSET   first 4 bytes of the asset's MD5, offset (u32), then a
+                 chunk of the asset the device asked for.
+
+  No Arduino dependency: tools/fleet_emulator.cpp reads the seq of stored
+  messages with it.
+*/
+
+#define BINARY_HEADER_SIZE 2
+
+enum BinaryMessageType : uint8_t {
+  BINARY_IMAGE = 0x01,
+  BINARY_STREAM = 0x02,
+  BINARY_DOODLE = 0x03,
+  BINARY_OTA = 0x04,
+  BINARY_MANIFEST = 0x05,
+  BINARY_ASSET = 0x06
+};
+
+#define BINARY_FLAG_PACKBITS 0x01
+#define BINARY_FLAG_KEYFRAME 0x02
+#define BINARY_FLAG_STREAM_END 0x04
+
+static inline uint16_t readLe16(const uint8_t* p) {
+  return p[0] | p[1] << 8;
+}
+
+static inline uint32_t readLe32(const uint8_t* p) {
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_RESET -1
+#define SCREEN_ADDRESS 0x3C
+
+#define DISPLAY_PAGES (SCREEN_HEIGHT / 8)
+#define DISPLAY_BUFFER_SIZE (SCREEN_WIDTH * DISPLAY_PAGES)
+
+// 400 kHz is safe at 80 MHz; 800 kHz needs the CPU at 160 MHz (see platformio.ini)
+#ifndef DISPLAY_I2C_CLOCK
+#define DISPLAY_I2C_CLOCK 400000UL
+#endif
+
+// Data bytes per I2C transaction; the control byte has to fit in the Wire buffer too
+#define DISPLAY_I2C_CHUNK 64
+
+struct DisplayFlushStats {
+  uint32_t framesCommitted;  // display() calls that changed at least one byte
+  uint32_t framesFlushed;    // committed frames that fully reached the panel
+  uint32_t lastFlushUs;      // bus time spent on the last flushed frame
+  uint32_t maxFlushUs;
+  uint32_t bytesSent;
+  uint16_t fps;              // frames flushed during the last full second
+};
+
+/*
+  SSD1306 driver with a double-buffered, incremental flush
+
+  Drawing goes to the Adafruit buffer as before (the back buffer). display()
+  no longer blocks on the bus: it diffs the back buffer against the front
+  buffer, copies it over and records the changed column span of every page.
+  pump() then sends at most one dirty page per call, so a frame is spread
+  over several loop() passes and unchanged pages are never resent.
+
+  display() hides the non-virtual Adafruit_SSD1306::display(), which is what
+  FluxGarage_RoboEyes calls on the global `display` object, so the eyes get
+  the incremental flush without changes to the library. fillRoundRect() and
+  fillTriangle() are hidden the same way and draw from the eye sprite cache
+  (see eye_sprites.h).
+*/
+class BufferedDisplay : public Adafruit_SSD1306 {
+public:
+  BufferedDisplay(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin);
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0);
+  void display();
+  bool pump();
+  void flushNow();
+  void invalidate();
+  bool isFlushing() const;
+  void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+
+#ifdef LOVEBOX_BENCH
+  void benchmark();
+#endif
+
+  DisplayFlushStats stats;
+
+private:
+  uint8_t front[DISPLAY_BUFFER_SIZE];
+  uint8_t dirtyFrom[DISPLAY_PAGES];  // first changed column, SCREEN_WIDTH if clean
+  uint8_t dirtyTo[DISPLAY_PAGES];    // last changed column
+  uint8_t nextPage = 0;
+  uint32_t frameBusUs = 0;
+  uint32_t fpsWindowStart = 0;
+  uint16_t fpsFrames = 0;
+
+  void sendPage(uint8_t page);
+  void frameDone();
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Device configuration
+
+  One binary record, CONFIG_PATH, read once at boot into `config`:
+
+    magic "CFG1", version (u16), size of the Config that follows (u16),
+    CRC32 of it (u32), then the Config struct itself
+
+  Fields are only ever appended, so a record written by an older version
+  is read as a prefix and the newer fields keep their defaults. A record
+  that is missing or fails its CRC falls back to the defaults. Changes go
+  through saveConfig(), which writes a temporary file and renames it over
+  the record, so a reset mid-write leaves the previous configuration.
+
+  On the first boot with this firmware, /wifi.json is migrated into the
+  record and removed.
+
+  Version 2 keeps up to CONFIG_WIFI_PROFILES networks in wifi[]; the
+  version 1 single network is moved there on upgrade.
+*/
+
+#define CONFIG_PATH "/config.bin"
+#define CONFIG_TEMP_PATH "/config.tmp"  // written in full, then renamed over CONFIG_PATH
+#define CONFIG_VERSION 2
+#define CONFIG_SSID_MAX 32
+#define CONFIG_PASSWORD_MAX 64
+#define CONFIG_HOST_MAX 63
+#define CONFIG_WIFI_PROFILES 4
+
+struct WifiProfile {
+  char ssid[CONFIG_SSID_MAX + 1];  // empty for a free slot
+  char password[CONFIG_PASSWORD_MAX + 1];
+  uint16_t connectMs;  // time to connect the last time it worked
+  uint32_t lastUsed;   // Config::wifiConnects at that time, 0 if never
+};
+
+struct Config {
+  char ssid[CONFIG_SSID_MAX + 1];  // version 1 network, empty once moved to wifi[]
+  char password[CONFIG_PASSWORD_MAX + 1];
+  char serverHost[CONFIG_HOST_MAX + 1];
+  uint16_t serverPort;
+  int32_t utcOffsetSeconds;
+  uint32_t moodIntervalMs;
+  uint32_t debounceMs;
+  // version 2
+  WifiProfile wifi[CONFIG_WIFI_PROFILES];
+  uint32_t wifiConnects;  // successful connections, orders the profiles by recency
+};
+
+extern Config config;
+
+void loadConfig();
+bool saveConfig();
+bool saveWifiProfile(const char* ssid, const char* password);
+void printConfigReport();
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include <connection_timing.h>
+
+/*
+  WebSocket connection health
+
+  Sends our own ping every WS_HEARTBEAT_INTERVAL_MS and times the pong, so a
+  dead connection (e.g. a NAT mapping that silently expired) is dropped after
+  WS_MAX_MISSED_PONGS unanswered pings instead of going unnoticed.
+
+  While disconnected the reconnect interval grows exponentially with jitter
+  up to WS_RECONNECT_MAX_MS. Getting an IP from the access point resets the
+  backoff and reconnects right away. The timing constants and the backoff
+  are in connection_timing.h.
+*/
+
+#define RTT_HISTOGRAM_BUCKETS 8
+
+struct ConnectionStats {
+  uint32_t rttEwmaMs;       // smoothed RTT, 0 until the first pong
+  uint32_t rttLastMs;
+  uint32_t rttMaxMs;
+  uint32_t rttHistogram[RTT_HISTOGRAM_BUCKETS];
+  uint32_t pingsSent;
+  uint32_t pongsReceived;
+  uint32_t reconnects;      // connections established after the first one
+  uint32_t connectedSince;  // millis() of the current connection, 0 while down
+  uint32_t backoffMs;       // current reconnect interval
+};
+
+extern ConnectionStats connectionStats;
+// Upper bound (exclusive) of each histogram bucket in ms; the last is open ended
+extern const uint16_t rttBucketLimitsMs[RTT_HISTOGRAM_BUCKETS - 1];
+
+void beginConnectionHealth();
+void connectionHealthTick();
+void onConnectionEstablished();
+void onConnectionLost();
+void onHeartbeatPong();
+void printConnectionReport();
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+  Heartbeat and reconnect timing of connection_health.h
+
+  Plain C++ with no Arduino dependency, so tools/fleet_emulator.cpp pings
+  and backs off exactly as the firmware does.
+*/
+
+#define WS_HEARTBEAT_INTERVAL_MS 15000
+#define WS_PONG_TIMEOUT_MS 5000
+#define WS_MAX_MISSED_PONGS 2
+#define WS_RECONNECT_BASE_MS 2000
+#define WS_RECONNECT_MAX_MS 120000
+
+uint32_t backoffInterval(uint8_t attempt, uint32_t randomValue);
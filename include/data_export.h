@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+/*
+  Data export over HTTP
+
+  Endpoints on the device's web server, in station and AP mode:
+
+    /export/stats.csv         counter,period,start,count
+                              lifetime totals (period "total"), then every
+                              hourly and daily bucket of the stats history,
+                              oldest first, start in local time
+    /export/messages.ndjson   the stored message, then the scheduled ones:
+                              {"state": "current" | "scheduled", "seq",
+                               "revealAt", "message": <stored JSON>}
+                              image and doodle messages give their type and
+                              size instead of the message
+    /export/log.ndjson        the lines kept in RTC memory, from the boot
+                              before the last reset and from this one:
+                              {"boot", "ms", "level", "tag", "text"}
+
+  Responses are chunked. Each chunk is produced from the records on
+  flash as the client reads it: one row or line at a time through a
+  EXPORT_LINE_MAX buffer, stored messages copied straight from their
+  files, and at most one stats series (STATS_DAILY_SLOTS values) in RAM.
+  An export holds under 512 bytes whatever the size of the data, at most
+  EXPORT_MAX_ACTIVE run at once, and none start while the heap is low.
+
+  Data that changes during an export (a new event, a revealed message)
+  may or may not be in it.
+*/
+
+#define EXPORT_LINE_MAX 192
+#define EXPORT_MAX_ACTIVE 2
+
+void beginDataExport(AsyncWebServer& server);
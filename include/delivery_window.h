@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+  The delivery window of message_delivery.h, without the storage
+
+  A cumulative ACK (every seq <= ackedSeq has been received) plus a 64-bit
+  bitmap of the out-of-order sequences above it. Plain C++ with no Arduino
+  dependency, so tools/fleet_emulator.cpp tracks its emulated devices with
+  the same code as the firmware.
+*/
+
+#define DELIVERY_WINDOW_SIZE 64
+
+struct DeliveryWindow {
+  uint32_t ackedSeq;       // every seq <= ackedSeq has been received
+  uint64_t pendingWindow;  // bit i set => seq ackedSeq + 1 + i received
+};
+
+bool isDuplicateInWindow(const DeliveryWindow& window, uint32_t seq);
+bool isBeyondWindow(const DeliveryWindow& window, uint32_t seq);
+bool recordInWindow(DeliveryWindow& window, uint32_t seq);
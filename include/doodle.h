@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Vector doodle messages
+
+  A doodle is a list of stroke commands instead of pixels: one opcode byte
+  followed by its operands, all single bytes in screen coordinates.
+
+    DOODLE_MOVE      x y          move the pen
+    DOODLE_LINE      x y          line from the pen, the pen follows
+    DOODLE_POLYLINE  n, n * (x y) n lines from the pen
+    DOODLE_CIRCLE    x y r
+    DOODLE_DISC      x y r        filled circle
+    DOODLE_HEART     x y s        filled heart centred on x, y, s wide each side
+    DOODLE_BOX       x y w h      filled rectangle
+    DOODLE_INK       c            0 erases, 1 draws (the default), 2 inverts
+    DOODLE_PAUSE     t            hold the replay for t * 10 ms
+
+  A typical doodle is a few hundred bytes. It is stored as is in
+  DOODLE_MESSAGE_PATH and rasterized at reveal time by doodleTick(), at most
+  DOODLE_SEGMENTS_PER_PASS segments per loop() pass and one segment per
+  DOODLE_MS_PER_SEGMENT, so the message appears to be drawn by hand.
+*/
+
+#define DOODLE_MESSAGE_PATH "/message.doodle"
+#define DOODLE_MAX_BYTES 512
+#define DOODLE_SEGMENTS_PER_PASS 8
+#define DOODLE_MS_PER_SEGMENT 15
+
+enum DoodleOp : uint8_t {
+  DOODLE_MOVE = 0x01,
+  DOODLE_LINE = 0x02,
+  DOODLE_POLYLINE = 0x03,
+  DOODLE_CIRCLE = 0x04,
+  DOODLE_DISC = 0x05,
+  DOODLE_HEART = 0x06,
+  DOODLE_BOX = 0x07,
+  DOODLE_INK = 0x08,
+  DOODLE_PAUSE = 0x09
+};
+
+bool isValidDoodle(const uint8_t* commands, size_t length);
+bool saveDoodleMessage(const uint8_t* commands, size_t length);
+bool loadDoodleMessage();
+void startDoodle();
+bool doodleTick();
+bool isDoodlePlaying();
+void stopDoodle();
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Sprite cache for the robot eye shapes
+
+  FluxGarage_RoboEyes draws every frame from fillRoundRect() and
+  fillTriangle(). The eye geometry is fixed in setup() and a blink or mood
+  change only walks through a handful of sizes, so each distinct shape is
+  rasterized once into a small sprite in the SSD1306 page layout (one byte
+  per column per 8 rows) and afterwards copied into the frame buffer with a
+  shift for its y offset, OR-ed, masked out or XOR-ed depending on the color.
+
+  BufferedDisplay routes its fillRoundRect()/fillTriangle() here and falls
+  back to the GFX primitives for shapes larger than a slot.
+  prerenderEyeSprites() fills the cache with the blink sizes up front.
+*/
+
+#define EYE_SPRITE_SLOTS 20
+#define EYE_SPRITE_MAX_W 32
+#define EYE_SPRITE_MAX_H 32
+#define EYE_SPRITE_PAGES ((EYE_SPRITE_MAX_H + 7) / 8)
+
+struct EyeSpriteStats {
+  uint32_t hits;
+  uint32_t misses;     // rasterized into a free or evicted slot
+  uint32_t evictions;
+  uint32_t fallbacks;  // drawn with the primitive, too large for a slot
+  uint8_t slotsUsed;
+};
+
+extern EyeSpriteStats eyeSpriteStats;
+extern bool eyeSpritesEnabled;
+
+bool drawSpriteRoundRect(uint8_t* buffer, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+bool drawSpriteTriangle(uint8_t* buffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        int16_t x2, int16_t y2, uint16_t color);
+void prerenderEyeSprites(int16_t w, int16_t h, int16_t r);
+#ifdef LOVEBOX_BENCH
+void benchmarkEyeSprites();
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Adaptive frame rate governor for the robot eyes
+
+  eyesGovernorUpdate() replaces roboEyes.update() in loop(). It measures
+  what a frame costs and how much of the frame interval the rest of loop()
+  leaves over, and once per window moves the target fps between the
+  configured bounds: down by a quarter when frames were late or headroom is
+  short, up by EYES_FPS_STEP when there is plenty. While the eyes are tired
+  the target is capped at EYES_FPS_TIRED.
+
+  When two frames in a row come out identical, the eyes are static and
+  redraws pause until the next blink or idle move is due, or until some
+  caller changes the eye state (mood, animation, position).
+*/
+
+#ifndef EYES_FPS_MIN
+#define EYES_FPS_MIN 10
+#endif
+#ifndef EYES_FPS_MAX
+#define EYES_FPS_MAX 60
+#endif
+#define EYES_FPS_TIRED 20
+#define EYES_FPS_STEP 5
+#define EYES_GOVERNOR_WINDOW_MS 1000
+
+// Headroom is the share of the frame interval not used by the frame and the rest of loop()
+#define EYES_HEADROOM_LOW_PERCENT 25
+#define EYES_HEADROOM_HIGH_PERCENT 50
+
+struct EyesGovernorStats {
+  uint8_t targetFps;
+  uint8_t headroomPercent;   // during the last window
+  uint32_t avgFrameUs;       // EWMA of drawn frames, including the display diff
+  uint32_t framesDrawn;
+  uint32_t framesPaused;     // frame slots skipped because the eyes were static
+  uint32_t framesDropped;    // frame slots missed because loop() was busy
+  uint32_t cpuSavedMs;       // frame time not spent compared to always drawing at maxFps
+};
+
+extern EyesGovernorStats eyesStats;
+
+void beginEyesGovernor(uint8_t minFps = EYES_FPS_MIN, uint8_t maxFps = EYES_FPS_MAX);
+void eyesGovernorUpdate();
+void wakeEyes();
+void printEyesReport();
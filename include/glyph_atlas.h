@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  UTF-8 text from a glyph atlas in LittleFS
+
+  The built-in 5x7 font only covers ASCII. Text with any other character is
+  decoded from UTF-8 and drawn from GLYPH_ATLAS_PATH instead, an atlas built
+  from a BDF font by tools/make_glyph_atlas.py (little endian):
+
+    header  "GLY1", glyph count (u16), cell height (u8), reserved (u8)
+    index   count * { codepoint (u32), glyph offset (u32) }, sorted by codepoint
+    glyphs  width (u8), x offset (s8), advance (u8), then the bitmap in the
+            SSD1306 page layout, width bytes per 8 rows of the cell
+
+  A codepoint is found by binary search over the index with a few seeks, so
+  the atlas can hold whole scripts without any of it living in PROGMEM.
+  The most recently drawn glyphs, and the codepoints the atlas lacks, stay
+  in a small LRU cache in RAM; a message redrawn after a mode switch never
+  touches flash. Codepoints are drawn one after the other: combining marks
+  (advance 0) overlay the previous glyph, but there is no shaping, so
+  scripts that need conjunct forms show their nominal letters.
+*/
+
+#define GLYPH_ATLAS_PATH "/glyphs.bin"
+#define GLYPH_CACHE_SLOTS 48
+#define GLYPH_MAX_W 16
+#define GLYPH_MAX_H 16
+#define GLYPH_MAX_BYTES (GLYPH_MAX_W * ((GLYPH_MAX_H + 7) / 8))
+
+struct GlyphCacheStats {
+  uint32_t hits;
+  uint32_t misses;      // looked up in the atlas
+  uint32_t missing;     // of those, not in the atlas
+  uint32_t evictions;
+  uint32_t maxMissUs;   // slowest atlas lookup
+};
+
+extern GlyphCacheStats glyphCacheStats;
+
+bool beginGlyphAtlas();
+bool needsGlyphAtlas(const char* text);
+bool drawUtf8Text(const char* text, int16_t x, int16_t y);
+void printGlyphReport();
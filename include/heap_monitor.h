@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Heap fragmentation tracker
+
+  Samples free heap, largest free block and fragmentation every
+  HEAP_SAMPLE_INTERVAL_MS into a ring, so a slow decline over hours of
+  uptime is visible before it turns into an allocation failure.
+
+  Code that allocates can be attributed to a subsystem with a scope:
+
+    {
+      HeapScope scope(HEAP_TAG_JSON);
+      ... deserializeJson(...) ...
+    }
+
+  Each tag accumulates the bytes still held when its scopes end (retained)
+  and the deepest heap dip seen inside one of them (peak). Scopes nest.
+
+  A warning is raised while the largest free block is within 25% of what a
+  WebSocket frame or a TLS session needs, and again once it drops below.
+*/
+
+#define HEAP_SAMPLE_INTERVAL_MS 10000
+#define HEAP_HISTORY_SIZE 60            // 10 minutes at one sample per 10 s
+#define HEAP_SCOPE_MAX_DEPTH 4
+
+// Largest contiguous block needed by the memory hungry operations
+#define HEAP_BLOCK_NEEDED_WS 2048       // incoming frame buffer plus JSON document
+#define HEAP_BLOCK_NEEDED_TLS 6144      // BearSSL with 512 byte fragments
+
+enum HeapTag : uint8_t {
+  HEAP_TAG_WS,
+  HEAP_TAG_JSON,
+  HEAP_TAG_DISPLAY,
+  HEAP_TAG_FS,
+  HEAP_TAG_COUNT
+};
+
+enum HeapWarning : uint8_t {
+  HEAP_OK,
+  HEAP_LOW,        // largest block within 25% of a need
+  HEAP_CRITICAL    // largest block smaller than a need
+};
+
+struct HeapSample {
+  uint32_t uptimeS;
+  uint32_t freeHeap;
+  uint16_t maxBlock;
+  uint8_t fragmentation;  // percent, as reported by ESP.getHeapFragmentation()
+};
+
+struct HeapTagStats {
+  uint32_t scopes;
+  int32_t retainedBytes;  // sum of (free at entry - free at exit)
+  uint32_t peakBytes;     // deepest dip below the free heap at entry
+};
+
+class HeapScope {
+public:
+  explicit HeapScope(HeapTag tag);
+  ~HeapScope();
+};
+
+extern HeapTagStats heapTagStats[HEAP_TAG_COUNT];
+
+void heapMonitorTick();
+HeapSample currentHeapSample();
+HeapWarning heapWarning();
+uint32_t minFreeHeapSeen();
+uint8_t heapHistory(HeapSample* out, uint8_t maxSamples);
+void printHeapReport();
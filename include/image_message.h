@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Pre-rendered image messages
+
+  A BINARY_IMAGE message (see binary_protocol.h) is unpacked straight into
+  the display buffer and the buffer is written to IMAGE_MESSAGE_PATH as is,
+  1024 raw bytes, so showing it later is a single file read.
+*/
+
+#define IMAGE_MESSAGE_PATH "/message.bin"
+#define IMAGE_MESSAGE_HEADER_SIZE 4  // seq
+
+bool unpackImage(const uint8_t* data, size_t length, bool packed, uint8_t* image);
+bool saveImageMessage(const uint8_t* image);
+bool loadImageMessage(uint8_t* image);
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Leveled, deferred logging
+
+    LOG_INFO(WS, "Connected to %s", host);
+
+  Each tag has a compile-time level (LOG_LEVEL_<TAG>, defaulting to
+  LOG_LEVEL_DEFAULT); messages above it compile to nothing, format string
+  included. Defining LOG_DISABLE removes all logging.
+
+  Lines are formatted into a RAM ring and drained to Serial from idle time
+  by logDrain(), only as much as the UART FIFO takes without blocking. When
+  the ring is full the oldest lines are dropped (and counted).
+
+  Every line is also appended to a small ring in RTC memory, which survives
+  soft, watchdog and exception resets. logBegin() recovers it, so the last
+  lines before a crash are printed on the next boot and with the 'l'
+  Serial command.
+*/
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#define LOG_RING_SIZE 2048
+#define LOG_LINE_MAX 128
+
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#endif
+
+// Per tag levels, override with e.g. -DLOG_LEVEL_WS=LOG_LEVEL_DEBUG
+#ifndef LOG_LEVEL_WS
+#define LOG_LEVEL_WS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_JSON
+#define LOG_LEVEL_JSON LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_STATS
+#define LOG_LEVEL_STATS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOOD
+#define LOG_LEVEL_MOOD LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_DISPLAY
+#define LOG_LEVEL_DISPLAY LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SETUP
+#define LOG_LEVEL_SETUP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_TIME
+#define LOG_LEVEL_TIME LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_WIFI
+#define LOG_LEVEL_WIFI LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_TOUCH
+#define LOG_LEVEL_TOUCH LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_BUTTON
+#define LOG_LEVEL_BUTTON LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_LOOP
+#define LOG_LEVEL_LOOP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_ANIMATION
+#define LOG_LEVEL_ANIMATION LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_DELIVERY
+#define LOG_LEVEL_DELIVERY LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_HEAP
+#define LOG_LEVEL_HEAP LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_ALLOC
+#define LOG_LEVEL_ALLOC LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_BENCH
+#define LOG_LEVEL_BENCH LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_FS
+#define LOG_LEVEL_FS LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_STREAM
+#define LOG_LEVEL_STREAM LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_GLYPH
+#define LOG_LEVEL_GLYPH LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_SCHEDULE
+#define LOG_LEVEL_SCHEDULE LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_OTA
+#define LOG_LEVEL_OTA LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_CONFIG
+#define LOG_LEVEL_CONFIG LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_TRACE
+#define LOG_LEVEL_TRACE LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_EXPORT
+#define LOG_LEVEL_EXPORT LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_STALL
+#define LOG_LEVEL_STALL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_LOG
+#define LOG_LEVEL_LOG LOG_LEVEL_DEFAULT
+#endif
+
+#ifdef LOG_DISABLE
+#define LOG_AT(tag, level, fmt, ...) do {} while (0)
+#else
+#define LOG_AT(tag, level, fmt, ...) \
+  do { \
+    if (LOG_LEVEL_##tag >= (level)) { \
+      logWrite((level), #tag, PSTR(fmt), ##__VA_ARGS__); \
+    } \
+  } while (0)
+#endif
+
+#define LOG_ERROR(tag, fmt, ...) LOG_AT(tag, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(tag, fmt, ...) LOG_AT(tag, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(tag, fmt, ...) LOG_AT(tag, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(tag, fmt, ...) LOG_AT(tag, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+
+void logBegin();
+void logWrite(uint8_t level, const char* tag, PGM_P fmt, ...) __attribute__((format(printf, 3, 4)));
+void logDrain();
+void logFlush();
+void printRecoveredLog();
+bool readKeptLogLine(bool previousBoot, uint32_t& position, char* line, size_t size);
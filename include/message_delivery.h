@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+#include <delivery_window.h>
+
+/*
+  Sequenced, acknowledged message delivery
+
+  Every message from the server may carry a "seq" field (starting at 1).
+  The device keeps a cumulative ACK (every seq <= ack has been received) plus
+  a 64-bit bitmap of out-of-order sequences above it, so duplicate detection
+  is a compare and a bit test. The state is persisted in /delivery.json so a
+  reboot does not replay already stored messages. The window itself is in
+  delivery_window.h; this module keeps the device's one and persists it.
+
+  The ACK never moves past a sequence that did not arrive. A message more
+  than DELIVERY_WINDOW_SIZE above it is dropped unstored and answered with
+  the unchanged ACK, so the server resends the gap before it.
+*/
+
+#define MESSAGE_JSON_MAX 384  // largest stored text message that fits the 256 byte document, with its NUL
+
+void loadDeliveryState();
+bool isDuplicateMessage(uint32_t seq);
+bool isBeyondDeliveryWindow(uint32_t seq);
+bool markMessageReceived(uint32_t seq);
+uint32_t lastAckedSequence();
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Delta body decoder
+
+  Turns the LZSS body of a delta file (format in ota_update.h) back into
+  the new image, a slice at a time as frames arrive. It only depends on
+  the two functions given to beginOtaDelta(), which read the running
+  image and take the next piece of the new one, so it builds on the host
+  as is (test/test_ota_delta). ota_update.cpp passes ESP.flashRead() and
+  Update.write().
+
+  Output is handed over OTA_OUTPUT_CHUNK bytes at a time, never past the
+  target size; the running image is read OTA_SOURCE_CHUNK bytes at a
+  time for ADD and straight into the output buffer for COPY.
+*/
+
+#define OTA_WINDOW_SIZE 1024
+#define OTA_OUTPUT_CHUNK 256
+#define OTA_SOURCE_CHUNK 64
+
+enum OtaOp : uint8_t {
+  OTA_OP_END = 0x00,
+  OTA_OP_COPY = 0x01,
+  OTA_OP_ADD = 0x02,
+  OTA_OP_INSERT = 0x03
+};
+
+typedef bool (*OtaSourceReader)(uint32_t address, uint8_t* data, size_t length);
+typedef bool (*OtaTargetWriter)(const uint8_t* data, size_t length);
+
+void beginOtaDelta(uint32_t sourceSize, uint32_t targetSize, OtaSourceReader readSource,
+                   OtaTargetWriter writeTarget);
+bool applyOtaDelta(const uint8_t* data, size_t length);
+bool isOtaDeltaDone();
+uint32_t otaDeltaOutput();
+const char* otaDeltaFailure();
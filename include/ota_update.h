@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ota_delta.h>
+
+/*
+  Delta firmware updates
+
+  The server streams a delta file (tools/make_delta.py) in BINARY_OTA
+  frames, and it is applied byte by byte as it arrives:
+
+    header  "LBD1", source size (u32), source MD5 (16 bytes),
+            target size (u32), target MD5 (16 bytes)
+    body    LZSS with a OTA_WINDOW_SIZE byte window: a flag byte announces
+            the next 8 items, bit set for a literal byte, clear for a
+            2 byte back reference (distance - 1 in the top 10 bits,
+            length - 3 in the low 6). It decodes to the patch:
+
+      OTA_OP_COPY    src (u32), n (u32)          n bytes of the running image
+      OTA_OP_ADD     src (u32), n (u32), n bytes each added to the running image's byte
+      OTA_OP_INSERT  n (u32), n bytes            new bytes
+      OTA_OP_END
+
+  The body is decoded by ota_delta.cpp. The source is read from the
+  running image in flash and the output goes straight to the spare slot
+  through Updater, so RAM use is the window plus two small buffers
+  whatever the image size. A delta is only applied to the image it was
+  made from (size and MD5), and Updater checks the target MD5 before the
+  new image is committed; a full image is a delta with source size 0 and
+  a single insert.
+
+  Before writing, the running image is copied to OTA_ROLLBACK_PATH by
+  otaTick(), OTA_SAVE_STEP bytes per loop() pass, so the heartbeat and
+  the display keep running through the copy. The new image is on trial
+  until confirmFirmware() (the first WebSocket connection); if it crashes
+  or trips a watchdog OTA_TRIAL_BOOTS times first, otaBootCheck() flashes
+  the saved image back.
+*/
+
+#define OTA_HEADER_SIZE 44
+#define OTA_TRIAL_BOOTS 3
+#define OTA_STATE_PATH "/ota.json"
+#define OTA_ROLLBACK_PATH "/ota_previous.bin"
+#define OTA_SAVE_STEP 4096  // bytes of the running image saved per otaTick()
+
+void otaBootCheck();
+void confirmFirmware();
+void receiveOtaChunk(const uint8_t* payload, size_t length);
+void otaTick();
+bool isOtaRunning();
+void printOtaReport();
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Page-native bitmap blitter
+
+  Bitmaps in the SSD1306 page layout (for every band of 8 rows one byte
+  per column, bit 0 at the top; see tools/pagify_bitmaps.py) are copied
+  straight into the frame buffer instead of going pixel by pixel through
+  drawBitmap()/drawPixel():
+
+  - a full-screen frame at 0,0 is a single memcpy_P,
+  - any other frame on a page boundary is a memcpy_P per page,
+  - everything else (a y offset inside a page, OR/XOR/erase compositing)
+    goes 4 columns at a time with aligned 32-bit flash reads, each byte
+    split over two pages by SWAR shifts and masks, and falls back to
+    bytes where the bitmap or the x offset is not word aligned.
+
+  Bitmaps are clipped to the screen.
+*/
+
+enum BlitMode : uint8_t {
+  BLIT_COPY,   // replace the covered pixels
+  BLIT_OR,     // set the bitmap's pixels
+  BLIT_XOR,    // invert the bitmap's pixels
+  BLIT_ERASE   // clear the bitmap's pixels
+};
+
+void blitPages(uint8_t* buffer, const uint8_t* bitmap, uint8_t width, uint8_t height,
+               int16_t x, int16_t y, BlitMode mode);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  The JSON text frames the device sends about delivery
+
+    {"type": "hello", "last_ack": N}   on connect, where to resume
+    {"type": "ack", "ack": N}          every seq <= N is stored
+    {"type": "displayed", "seq": N}    the message was shown
+    {"type": "miss_you_button"}        the second button was pressed
+
+  Plain C++ with no Arduino dependency, so tools/fleet_emulator.cpp sends
+  byte for byte the frames the firmware does. The format functions return
+  the length as snprintf() does; PROTOCOL_MESSAGE_MAX fits any of them.
+*/
+
+#define PROTOCOL_MESSAGE_MAX 48
+#define MISS_YOU_BUTTON_MESSAGE "{\"type\": \"miss_you_button\"}"
+
+int formatHelloMessage(char* out, size_t size, uint32_t lastAck);
+int formatAckMessage(char* out, size_t size, uint32_t ack);
+int formatDisplayedMessage(char* out, size_t size, uint32_t seq);
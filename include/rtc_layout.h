@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+  ESP8266 user RTC memory: 128 words (512 bytes) that survive software,
+  watchdog and exception resets, but not a power cycle.
+  Offsets and sizes are in 4-byte words, as ESP.rtcUserMemoryRead/Write take them.
+
+  Words 0-31 are the core's: Update.end() leaves the eboot command there
+  (magic, action, args, CRC) and the bootloader reads it after the restart
+  to copy the new image into place. Nothing else may write them, or a
+  verified update or a rollback silently boots the old image.
+*/
+
+#define RTC_USER_WORDS 128
+
+#define RTC_EBOOT_OFFSET 0   // eboot_command, see Updater
+#define RTC_EBOOT_WORDS 32
+
+#define RTC_LOG_OFFSET 32    // crash log ring, see log.cpp
+#define RTC_LOG_WORDS 64
+
+#define RTC_STALL_OFFSET 96  // loop stall records, see stall_watchdog.cpp
+#define RTC_STALL_WORDS 32
+
+static_assert(RTC_EBOOT_WORDS <= RTC_LOG_OFFSET && RTC_LOG_OFFSET + RTC_LOG_WORDS <= RTC_STALL_OFFSET &&
+              RTC_STALL_OFFSET + RTC_STALL_WORDS <= RTC_USER_WORDS, "RTC regions overlap");
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Arduino.h>
+#include <message_delivery.h>
+
+/*
+  Scheduled delivery
+
+  A text message with "revealAt" (Unix seconds) in the future is
+  acknowledged on arrival but kept back until then. Pending messages are
+  ordered by reveal time in a binary min-heap stored in SCHEDULE_PATH:
+
+    header  "SCH1", count (u16), reserved (u16), next id (u32)
+    entries count * { revealAt (u32), seq (u32), id (u32) }
+
+  Insert and pop walk one root-to-leaf path, O(log n) entry reads and
+  writes. Each message body lives in SCHEDULE_DIR/<id>.json and only the
+  head entry is cached in RAM, so checking for a due message every loop()
+  pass touches neither flash nor the network. Reveal times are compared
+  with the NTP clock, so nothing is revealed before it has been set once
+  since boot.
+
+  A body is the re-serialized message document, at most SCHEDULE_MAX_BYTES
+  so it loads back from /message.json once revealed. A due message is only
+  removed from the heap once it has been saved there; a failed save is
+  retried SCHEDULE_RETRY_S later.
+*/
+
+#define SCHEDULE_PATH "/schedule.heap"
+#define SCHEDULE_DIR "/scheduled"
+#define SCHEDULE_MAX_ENTRIES 64
+#define SCHEDULE_MAX_BYTES (MESSAGE_JSON_MAX - 1)
+#define SCHEDULE_RETRY_S 60
+
+struct ScheduledMessage {
+  uint32_t revealAt;
+  uint32_t seq;
+  uint32_t id;  // names the body file, ties on revealAt go in arrival order
+};
+
+void loadSchedule();
+bool scheduleMessage(uint32_t revealAt, uint32_t seq, const char* json, size_t length);
+bool readDueMessage(uint32_t now, ScheduledMessage& due, char* json, size_t& length);
+void removeDueMessage();
+uint16_t scheduledCount();
+bool readScheduledEntry(uint16_t index, ScheduledMessage& entry);
+void scheduledBodyPath(uint32_t id, char* path, size_t size);
+void printScheduleReport();
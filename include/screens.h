@@ -0,0 +1,9 @@
+#pragma once
+
+#include <widgets.h>
+
+// Screens built from widgets, defined in screens.cpp
+extern const Screen statsScreen;
+extern const Screen historyScreen;
+extern const Screen debugScreen;
+extern const Screen apScreen;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Loop stall watchdog
+
+  Code that can block is wrapped in a span naming the subsystem:
+
+    {
+      StallSpan span(SPAN_FS);
+      ... LittleFS.open(...) ...
+    }
+
+  Spans nest; time is charged to the innermost open span, everything else
+  in a pass counts as SPAN_LOOP. stallLoopTick() at the top of loop() closes
+  the previous pass, and when it took longer than STALL_BUDGET_MS a record
+  naming the subsystem that used most of it is kept.
+
+  The last STALL_RECORDS records and the span open right now live in RTC
+  memory. A hardware watchdog reset therefore still leaves the span that
+  never returned, and on exceptions and software watchdog resets the crash
+  callback adds the time of the crash. stallWatchdogBegin() turns that into
+  a postmortem, printed at boot and with the 's' Serial command.
+*/
+
+#ifndef STALL_BUDGET_MS
+#define STALL_BUDGET_MS 50  // one loop() pass
+#endif
+
+#define STALL_RECORDS 14
+
+enum StallSpanId : uint8_t {
+  SPAN_LOOP,       // loop() code outside any span
+  SPAN_SETUP,
+  SPAN_WIFI,
+  SPAN_NTP,
+  SPAN_WS,
+  SPAN_REPLAY,     // offline events sent after reconnecting
+  SPAN_JSON,
+  SPAN_FS,
+  SPAN_DISPLAY,
+  SPAN_ANIMATION,
+  SPAN_EYES,
+  SPAN_SCREEN,
+  SPAN_WEB,
+  SPAN_OTA,
+  SPAN_COUNT
+};
+
+struct StallRecord {
+  StallSpanId span;     // subsystem that used most of the pass
+  uint16_t spanMs;      // its share of the pass
+  uint16_t passMs;      // whole pass
+  uint32_t uptimeS;
+};
+
+struct StallStats {
+  uint32_t passes;
+  uint32_t stalls;
+  uint32_t worstPassMs;
+  StallSpanId worstSpan;
+};
+
+class StallSpan {
+public:
+  explicit StallSpan(StallSpanId id);
+  ~StallSpan();
+
+private:
+  StallSpanId previous;
+};
+
+extern StallStats stallStats;
+
+void stallWatchdogBegin();
+void stallLoopTick();
+const char* stallSpanName(StallSpanId id);
+void printStallReport();
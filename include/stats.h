@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+struct Stats {
+  int headpats;
+  int missYouPresses;
+  int moodSwings;
+  int messagesReceived;
+};
+
+extern Stats stats;
+
+void loadStats();
+void saveStats();
+void incrementHeadpats();
+void incrementMissYouPresses();
+void incrementMoodSwings();
+void incrementMessagesReceived();
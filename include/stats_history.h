@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Stats history
+
+  Next to the lifetime totals in stats.json, every counter keeps two
+  fixed-size circular series in STATS_HISTORY_PATH: events per hour for
+  the last STATS_HOURLY_SLOTS hours and per day for the last
+  STATS_DAILY_SLOTS days, in local time (config.utcOffsetSeconds).
+
+    header  "HST1", hourly slots (u8), daily slots (u8), counters (u8),
+            reserved (u8), newest hour (u32), newest day (u32)
+    series  for each counter: hourly slots * u16, then daily slots * u16
+
+  Hour h is kept in slot h % STATS_HOURLY_SLOTS, day d likewise, so an
+  event is one read and one write of its two slots. When the clock
+  passes into a new hour or day, the slots it skipped are zeroed and
+  become the newest ones. Counts saturate at 65535.
+
+  Only the header stays in RAM. Events before NTP has set the clock are
+  held back and added to the hour the clock is first known in.
+  readStatsSeries() reads one series, oldest bucket first.
+*/
+
+#define STATS_HISTORY_PATH "/stats.history"
+#define STATS_HOURLY_SLOTS 48
+#define STATS_DAILY_SLOTS 90
+#define STATS_HISTORY_TICK_MS 60000
+
+enum StatsCounter : uint8_t {
+  STATS_HEADPATS,
+  STATS_MISS_YOU,
+  STATS_MOOD_SWINGS,
+  STATS_MESSAGES,
+  STATS_COUNTER_COUNT
+};
+
+enum StatsResolution : uint8_t {
+  STATS_HOURLY,
+  STATS_DAILY
+};
+
+extern uint32_t statsHistoryVersion;  // bumped whenever a stored bucket changes
+
+void loadStatsHistory();
+void countStatsEvent(StatsCounter counter);
+void statsHistoryTick();
+uint8_t readStatsSeries(StatsCounter counter, StatsResolution resolution, uint16_t* values);
+uint32_t newestStatsBucket(StatsResolution resolution);
+void printStatsHistoryReport();
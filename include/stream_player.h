@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  Live animation streams
+
+  BINARY_STREAM frames (see binary_protocol.h) are queued as they arrive,
+  still encoded, in a small jitter buffer. Playback starts once
+  STREAM_PREBUFFER_MS worth of arrival time has passed and then follows the
+  frame durations against absolute deadlines, like the animation engine.
+
+  Deltas only make sense applied in order, so when the device falls behind
+  the late frames are still decoded into the stream canvas but not shown:
+  of several frames due at once only the newest is shown, and when the
+  buffer overflows the whole backlog is skipped to the arriving frame.
+  A delta that does not follow the previous frame is rejected and a
+  keyframe requested from the server.
+
+  Decoding touches only the bytes a delta changes, so its cost grows with
+  the pixels that changed, like the bandwidth.
+*/
+
+#define STREAM_BUFFER_SIZE 1536      // encoded frames waiting to be shown, fits one raw keyframe
+#define STREAM_QUEUE_FRAMES 8
+#define STREAM_PREBUFFER_MS 100
+#define STREAM_IDLE_TIMEOUT_MS 1000  // a stream without STREAM_END ends after this much silence
+#define STREAM_KEYFRAME_RETRY_MS 500
+#define STREAM_FRAME_HEADER_SIZE 5   // stream, frame, duration
+
+struct StreamStats {
+  uint32_t framesReceived;
+  uint32_t framesShown;
+  uint32_t framesDropped;   // decoded but never shown, because a newer one was due
+  uint32_t framesRejected;  // out of sequence or undecodable, waiting for a keyframe
+  uint32_t bytesReceived;
+  uint32_t maxDecodeUs;
+  uint8_t maxQueued;
+};
+
+extern StreamStats streamStats;
+
+void queueStreamFrame(uint8_t flags, const uint8_t* payload, size_t length);
+bool streamTick();
+bool isStreamPlaying();
+void stopStream();
+void printStreamReport();
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+/*
+  Input trace recording and replay
+
+  loop() reads its inputs through the trace* functions below instead of
+  millis(), digitalRead(), WiFi.status() and time(). While recording
+  (Serial 'r'), every change of an input and every WebSocket event and
+  Serial command is appended to TRACE_PATH:
+
+    "TRC1", then records of
+      type (u8), milliseconds since the previous record (varint), payload
+
+    TRACE_START      random seed (u32), clock (u32), millis() (u32)
+    TRACE_GPIO       pin, level
+    TRACE_WIFI       wl_status_t
+    TRACE_CLOCK      epoch seconds (u32), when NTP set or moved the clock
+    TRACE_WS_EVENT   WStype_t of a connect or disconnect
+    TRACE_WS_TEXT    length (varint), frame
+    TRACE_WS_BINARY  length (varint), frame
+    TRACE_SERIAL     command
+    TRACE_WS_DROPPED WStype_t, length (varint) of a frame too big to keep
+    TRACE_END        recording stopped
+
+  Records are buffered in RAM and written every TRACE_FLUSH_MS; the trace
+  stops at TRACE_MAX_BYTES. Frames over TRACE_FRAME_MAX are only noted
+  (TRACE_WS_DROPPED) and skipped on replay. tools/trace_tool.py prints a trace.
+
+  A build with LOVEBOX_REPLAY skips WiFi and the WebSocket and plays the
+  trace into the same loop(): each pass advances a virtual clock by
+  TRACE_REPLAY_STEP_MS, GPIO, WiFi and clock reads return the recorded
+  values, and due frames and commands are handed to the WebSocket and
+  Serial handlers. random() is seeded from the trace, so mood changes
+  repeat. Animations, doodles, streams, screens and the connection and
+  stats timers read traceMillis() too; only the eyes (RoboEyes reads
+  millis() itself, and the governor with it) and the timing diagnostics
+  (watchdog, display flush, log stamps) stay on the real clock.
+  Replay changes stored state (messages, stats) the way the recorded run
+  did, so start from the same filesystem image.
+
+  The native env builds with LOVEBOX_REPLAY against the stand-ins in
+  host/, where millis() is a virtual clock too: test/test_replay steps
+  both clocks together, so a trace replays the same way every run.
+*/
+
+#define TRACE_PATH "/trace.bin"
+#define TRACE_MAX_BYTES 65536
+#define TRACE_BUFFER_SIZE 256
+#define TRACE_FRAME_MAX 1024
+#define TRACE_FLUSH_MS 1000
+#define TRACE_REPLAY_STEP_MS 10
+
+enum TraceRecordType : uint8_t {
+  TRACE_START = 0x00,
+  TRACE_GPIO = 0x01,
+  TRACE_WIFI = 0x02,
+  TRACE_CLOCK = 0x03,
+  TRACE_WS_EVENT = 0x04,
+  TRACE_WS_TEXT = 0x05,
+  TRACE_WS_BINARY = 0x06,
+  TRACE_SERIAL = 0x07,
+  TRACE_WS_DROPPED = 0x08,
+  TRACE_END = 0x09
+};
+
+typedef void (*TraceFrameHandler)(uint8_t type, uint8_t* payload, size_t length);
+typedef void (*TraceCommandHandler)(char command);
+
+void startTraceRecording();
+void stopTraceRecording();
+bool isTraceRecording();
+void traceTick();
+void printTraceReport();
+
+uint32_t traceMillis();
+int traceDigitalRead(uint8_t pin);
+uint8_t traceWifiStatus();
+time_t traceTime();
+bool traceLocalTime(struct tm* info);
+void traceWebSocketEvent(uint8_t type, const uint8_t* payload, size_t length);
+void traceSerialCommand(char command);
+
+bool isTraceReplaying();
+#ifdef LOVEBOX_REPLAY
+bool beginTraceReplay();
+bool traceReplayTick(TraceFrameHandler onFrame, TraceCommandHandler onCommand);
+#endif
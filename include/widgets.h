@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+/*
+  Retained-mode widget layer
+
+  A Screen is a fixed list of widgets. showScreen() draws all of them once;
+  after that refreshScreen() only polls the bound values and redraws the
+  widgets whose value changed, clearing just their own box. Static widgets
+  (frames, lines, labels, bitmaps) never change, so an idle screen costs a
+  few compares and no drawing or bus time at all.
+*/
+
+#define TEXT_WIDGET_MAX_CHARS 22  // one line at text size 1, plus the terminator
+#define CHART_WIDGET_MAX_POINTS 96
+
+class Widget {
+public:
+  Widget(int16_t x, int16_t y, int16_t w, int16_t h) : x(x), y(y), w(w), h(h) {}
+  virtual ~Widget() {}
+
+  // Polls the bound value; returns true if the widget needs to be redrawn
+  virtual bool changed() { return false; }
+  virtual void draw(Adafruit_GFX& gfx) = 0;
+
+  int16_t x, y, w, h;
+  bool dynamic = false;  // redrawn on change, its box is cleared first
+};
+
+class FrameWidget : public Widget {
+public:
+  FrameWidget(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t cornerDotRadius = 0)
+    : Widget(x, y, w, h), cornerDotRadius(cornerDotRadius) {}
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  uint8_t cornerDotRadius;
+};
+
+class LineWidget : public Widget {
+public:
+  LineWidget(int16_t x0, int16_t y0, int16_t x1, int16_t y1) : Widget(x0, y0, x1 - x0, y1 - y0) {}
+  void draw(Adafruit_GFX& gfx) override;
+};
+
+class LabelWidget : public Widget {
+public:
+  LabelWidget(int16_t x, int16_t y, const char* text, uint8_t size = 1)
+    : Widget(x, y, 0, 8 * size), text(text), size(size) {}
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  const char* text;
+  uint8_t size;
+};
+
+class BitmapWidget : public Widget {
+public:
+  BitmapWidget(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* bitmap)
+    : Widget(x, y, w, h), bitmap(bitmap) {}
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  const uint8_t* bitmap;  // PROGMEM
+};
+
+// "<prefix><value>", redrawn when *value changes
+class NumberWidget : public Widget {
+public:
+  NumberWidget(int16_t x, int16_t y, int16_t w, const char* prefix, const int* value)
+    : Widget(x, y, w, 8), prefix(prefix), value(value) { dynamic = true; }
+  bool changed() override;
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  const char* prefix;
+  const int* value;
+  int shown = 0;
+  bool drawn = false;
+};
+
+// Text produced by a formatter, redrawn when the formatted text changes
+class TextWidget : public Widget {
+public:
+  typedef void (*Formatter)(char* buf, size_t len);
+
+  TextWidget(int16_t x, int16_t y, int16_t w, Formatter format)
+    : Widget(x, y, w, 8), format(format) { dynamic = true; }
+  bool changed() override;
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  Formatter format;
+  char text[TEXT_WIDGET_MAX_CHARS] = "";
+  bool drawn = false;
+};
+
+/*
+  Sparkline or bar chart of a series that is read on demand, only when
+  *version changes, into a buffer on the stack. Bars sum `group` points
+  each, the newest bar ending at the newest point. Scaled to the largest
+  value shown.
+*/
+class ChartWidget : public Widget {
+public:
+  enum Style : uint8_t { SPARKLINE, BARS };
+  // Fills values, at most CHART_WIDGET_MAX_POINTS, oldest first; returns how many
+  typedef uint8_t (*Reader)(uint8_t series, uint16_t* values);
+
+  ChartWidget(int16_t x, int16_t y, int16_t w, int16_t h, Style style, Reader read, uint8_t series,
+              const uint32_t* version, uint8_t group = 1)
+    : Widget(x, y, w, h), style(style), read(read), series(series), version(version), group(group) {
+    dynamic = true;
+  }
+  bool changed() override;
+  void draw(Adafruit_GFX& gfx) override;
+
+private:
+  void drawSparkline(Adafruit_GFX& gfx, const uint16_t* values, uint8_t count);
+  void drawBars(Adafruit_GFX& gfx, const uint16_t* values, uint8_t count);
+
+  Style style;
+  Reader read;
+  uint8_t series;
+  const uint32_t* version;
+  uint8_t group;
+  uint32_t shown = 0;
+  bool drawn = false;
+};
+
+struct Screen {
+  Widget* const* widgets;
+  uint8_t count;
+};
+
+struct ScreenStats {
+  uint32_t fullDraws;      // showScreen() calls
+  uint32_t widgetRedraws;  // widgets redrawn by refreshScreen()
+  uint32_t idleRefreshes;  // refreshScreen() calls that drew nothing
+};
+
+extern ScreenStats screenStats;
+
+void showScreen(const Screen* screen);
+void hideScreen();
+bool refreshScreen();
+bool isScreenActive(const Screen* screen);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+
+/*
+  WiFi network selection and roaming
+
+  At boot one scan ranks the stored networks (config.wifi): a network the
+  scan saw scores its RSSI, plus WIFI_RECENT_BONUS_DB for the one that
+  connected most recently, so the usual network wins unless another is
+  clearly stronger. Networks the scan missed (hidden, or out of range)
+  follow in order of recency. Each candidate gets WIFI_PROFILE_TIMEOUT_MS,
+  and one the scan saw is joined on its channel and BSSID, which skips the
+  SDK's own scan.
+
+  While running, an RSSI below WIFI_ROAM_RSSI on two checks in a row, or
+  WIFI_LOST_MS without a connection, starts a background scan; a stored
+  network at least WIFI_ROAM_MARGIN_DB stronger than the current one is
+  joined. The time to connect is logged and kept per network.
+*/
+
+#define WIFI_PROFILE_TIMEOUT_MS 6000
+#define WIFI_RECENT_BONUS_DB 10
+#define WIFI_ROAM_CHECK_MS 10000
+#define WIFI_ROAM_RSSI -75
+#define WIFI_ROAM_MARGIN_DB 8
+#define WIFI_LOST_MS 20000
+#define WIFI_RSSI_UNSEEN -128  // not in the scan
+
+struct WifiCandidate {
+  uint8_t profile;  // index into config.wifi
+  int8_t rssi;
+  uint8_t channel;
+  uint8_t bssid[6];
+};
+
+uint8_t rankWifiCandidates(WifiCandidate* candidates);
+void beginWifiCandidate(const WifiCandidate& candidate);
+void wifiConnected(uint8_t profile, uint32_t elapsedMs);
+void wifiRoamTick();
+void printWifiReport();
@@ -0,0 +1,71 @@
+#include <alloc_counter.h>
+#include <log.h>
+
+#ifdef LOVEBOX_ALLOC_HOOK
+
+static volatile uint32_t allocations = 0;
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  allocations++;
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  allocations++;
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  allocations++;
+  return __real_realloc(ptr, size);
+}
+}
+
+uint32_t allocationCount() {
+  return allocations;
+}
+
+/*
+  Reports (at most once a minute):
+    ... I [ALLOC] 0 of 61234 loop passes allocated, 0 allocations, max 0 in one pass
+*/
+void allocCheckTick() {
+  static uint32_t lastCount = 0;
+  static uint32_t passes = 0;
+  static uint32_t allocatingPasses = 0;
+  static uint32_t total = 0;
+  static uint32_t maxInPass = 0;
+  static unsigned long lastReport = 0;
+
+  uint32_t count = allocations;
+  uint32_t inPass = count - lastCount;
+  passes++;
+  if (inPass > 0) {
+    allocatingPasses++;
+    total += inPass;
+    if (inPass > maxInPass) {
+      maxInPass = inPass;
+    }
+  }
+
+  unsigned long now = millis();
+  if (now - lastReport >= ALLOC_REPORT_INTERVAL_MS) {
+    LOG_INFO(ALLOC, "%u of %u loop passes allocated, %u allocations, max %u in one pass",
+             allocatingPasses, passes, total, maxInPass);
+    passes = 0;
+    allocatingPasses = 0;
+    total = 0;
+    maxInPass = 0;
+    lastReport = now;
+  }
+
+  // The report itself may allocate; don't charge that to the next pass
+  lastCount = allocations;
+}
+
+#endif
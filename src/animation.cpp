@@ -0,0 +1,238 @@
+#include <animation.h>
+#include <buffered_display.h>
+#include <page_blit.h>
+#include <trace.h>
+#include <log.h>
+
+extern BufferedDisplay display;
+
+AnimationStats animationStats;
+
+static const Animation* current = nullptr;
+static uint16_t step = 0;           // position within the current pass
+static uint16_t steps = 0;          // steps per pass
+static uint16_t pass = 0;           // completed passes
+static uint32_t stepDeadline = 0;   // absolute traceMillis() at which the current step ends
+static uint32_t passStart = 0;
+static uint32_t passDuration = 0;
+static int16_t drawnX = 0;
+static int16_t drawnY = 0;
+
+static AnimationFrame readFrame(const Animation* animation, uint8_t index) {
+  AnimationFrame frame;
+  memcpy_P(&frame, &animation->frames[index], sizeof(frame));
+  return frame;
+}
+
+static uint8_t frameAtStep(const Animation* animation, uint16_t s) {
+  if (s < animation->frameCount) {
+    return s;
+  }
+  return 2 * (animation->frameCount - 1) - s;
+}
+
+static uint16_t stepDuration(uint16_t s) {
+  return readFrame(current, frameAtStep(current, s)).durationMs;
+}
+
+// t and the result are fixed point, 0..1024
+static uint32_t ease(AnimationEasing easing, uint32_t t) {
+  switch (easing) {
+    case EASE_IN_QUAD:
+      return t * t / 1024;
+    case EASE_OUT_QUAD:
+      return 1024 - (1024 - t) * (1024 - t) / 1024;
+    case EASE_IN_OUT_QUAD:
+      if (t < 512) {
+        return 2 * t * t / 1024;
+      }
+      return 1024 - 2 * (1024 - t) * (1024 - t) / 1024;
+    case EASE_LINEAR:
+    default:
+      return t;
+  }
+}
+
+static void currentOffset(uint32_t now, int16_t* x, int16_t* y) {
+  int16_t fromX = current->fromX, fromY = current->fromY;
+  int16_t toX = current->toX, toY = current->toY;
+  if (current->playback == PLAY_PINGPONG && (pass & 1)) {
+    fromX = current->toX; fromY = current->toY;
+    toX = current->fromX; toY = current->fromY;
+  }
+
+  uint32_t elapsed = now - passStart;
+  uint32_t t = passDuration == 0 || elapsed >= passDuration ? 1024 : elapsed * 1024 / passDuration;
+  int32_t e = ease(current->easing, t);
+  *x = fromX + (int32_t)(toX - fromX) * e / 1024;
+  *y = fromY + (int32_t)(toY - fromY) * e / 1024;
+}
+
+static void drawFrame(const Animation* animation, uint8_t index, int16_t x, int16_t y) {
+  AnimationFrame frame = readFrame(animation, index);
+  if (animation->layout == LAYOUT_PAGES) {
+    // A frame covering the whole screen overwrites every byte, no need to clear first
+    if (x != 0 || y != 0 || animation->width < SCREEN_WIDTH || animation->height < SCREEN_HEIGHT) {
+      display.clearDisplay();
+    }
+    blitPages(display.getBuffer(), frame.bitmap, animation->width, animation->height, x, y, BLIT_COPY);
+  } else {
+    display.clearDisplay();
+    display.drawBitmap(x, y, frame.bitmap, animation->width, animation->height, SSD1306_WHITE);
+  }
+  display.display();
+}
+
+/*
+  Starts playing an animation from its first frame; replaces any animation
+  that is still running. The first frame is drawn immediately.
+*/
+void startAnimation(const Animation* animation) {
+  if (animation->frameCount == 0) {
+    return;
+  }
+
+  current = animation;
+  step = 0;
+  pass = 0;
+  steps = animation->frameCount;
+  if (animation->playback == PLAY_PINGPONG && animation->frameCount > 1) {
+    steps = 2 * animation->frameCount - 2;
+  }
+
+  passDuration = 0;
+  for (uint16_t s = 0; s < steps; s++) {
+    passDuration += stepDuration(s);
+  }
+
+  uint32_t now = traceMillis();
+  passStart = now;
+  stepDeadline = now + stepDuration(0);
+  animationStats.framesShown = 1;
+  animationStats.framesSkipped = 0;
+  animationStats.maxLateMs = 0;
+
+  currentOffset(now, &drawnX, &drawnY);
+  drawFrame(current, 0, drawnX, drawnY);
+}
+
+/*
+  Advances the running animation; call once per loop() pass.
+  Draws only when the frame or the eased offset changed.
+  Returns false once the animation has finished (or if none is running).
+*/
+bool animationTick() {
+  if (current == nullptr) {
+    return false;
+  }
+
+  uint32_t now = traceMillis();
+  bool advanced = false;
+
+  while ((int32_t)(now - stepDeadline) >= 0) {
+    if (advanced) {
+      animationStats.framesSkipped++;  // the step we are leaving was never drawn
+    }
+    advanced = true;
+
+    step++;
+    if (step >= steps) {
+      step = 0;
+      pass++;
+      passStart = stepDeadline;
+      uint16_t passes = current->playback == PLAY_ONCE ? 1 : current->passes;
+      if (passes != 0 && pass >= passes) {
+        LOG_INFO(ANIMATION, "Done: %u frames shown, %u skipped, max %u ms late",
+                 animationStats.framesShown, animationStats.framesSkipped, animationStats.maxLateMs);
+        current = nullptr;
+        return false;
+      }
+    }
+    stepDeadline += stepDuration(step);
+  }
+
+  int16_t x, y;
+  currentOffset(now, &x, &y);
+  if (!advanced && x == drawnX && y == drawnY) {
+    return true;
+  }
+
+  if (advanced) {
+    uint32_t late = now - (stepDeadline - stepDuration(step));
+    if (late > animationStats.maxLateMs) {
+      animationStats.maxLateMs = late;
+    }
+    animationStats.framesShown++;
+  }
+
+  drawnX = x;
+  drawnY = y;
+  drawFrame(current, frameAtStep(current, step), x, y);
+  return true;
+}
+
+void stopAnimation() {
+  current = nullptr;
+}
+
+bool isAnimationPlaying() {
+  return current != nullptr;
+}
+
+// Draws a single frame of an animation without starting playback
+void showAnimationFrame(const Animation* animation, uint8_t frameIndex) {
+  if (frameIndex < animation->frameCount) {
+    drawFrame(animation, frameIndex, animation->fromX, animation->fromY);
+  }
+}
+
+#ifdef LOVEBOX_BENCH
+/*
+  Times a full-screen message frame drawn with drawBitmap() from the row
+  layout against blitPages() from the page layout, at 0,0 and at an offset
+  inside a page, and checks the pixels match.
+*/
+void benchmarkAnimationDraw() {
+  const uint8_t runs = 20;
+  static uint8_t rows[DISPLAY_BUFFER_SIZE];       // the frame in drawBitmap()'s layout
+  static uint8_t reference[DISPLAY_BUFFER_SIZE];
+  const Animation* animation = &messageRevealAnimation;
+  AnimationFrame frame = readFrame(animation, animation->frameCount / 2);
+
+  memset(rows, 0, sizeof(rows));
+  for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+    for (uint8_t x = 0; x < SCREEN_WIDTH; x++) {
+      if (pgm_read_byte(frame.bitmap + (y / 8) * SCREEN_WIDTH + x) & (1 << (y & 7))) {
+        rows[y * (SCREEN_WIDTH / 8) + x / 8] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+
+  uint32_t timings[4];
+  const int8_t offsets[2] = { 0, 3 };
+  for (uint8_t i = 0; i < 2; i++) {
+    int8_t offset = offsets[i];
+
+    uint32_t start = micros();
+    for (uint8_t r = 0; r < runs; r++) {
+      display.clearDisplay();
+      display.drawBitmap(offset, offset, rows, SCREEN_WIDTH, SCREEN_HEIGHT, SSD1306_WHITE);
+    }
+    timings[i * 2] = (micros() - start) / runs;
+    memcpy(reference, display.getBuffer(), sizeof(reference));
+
+    start = micros();
+    for (uint8_t r = 0; r < runs; r++) {
+      display.clearDisplay();
+      blitPages(display.getBuffer(), frame.bitmap, SCREEN_WIDTH, SCREEN_HEIGHT, offset, offset, BLIT_COPY);
+    }
+    timings[i * 2 + 1] = (micros() - start) / runs;
+
+    bool identical = memcmp(reference, display.getBuffer(), sizeof(reference)) == 0;
+    LOG_INFO(BENCH, "frame at %d,%d: drawBitmap() %u us, blitPages() %u us (%s)", offset, offset,
+             timings[i * 2], timings[i * 2 + 1], identical ? "identical" : "PIXELS DIFFER");
+  }
+
+  display.clearDisplay();
+}
+#endif
@@ -0,0 +1,26 @@
+#include <animation.h>
+#include <message_animaiton_frames.h>
+
+/*
+  Animation definitions
+
+  Only this file may include message_animaiton_frames.h, the bitmaps are
+  defined (not just declared) there. They are stored in the SSD1306 page
+  layout; to add frames exported from image2cpp, run them through
+  tools/pagify_bitmaps.py.
+*/
+
+// Played when an unread message is touched; the last frame is held before the message appears
+static const AnimationFrame messageRevealFrames[] PROGMEM = {
+  { frame0, 250 },  { frame1, 250 },  { frame2, 250 },  { frame3, 250 },
+  { frame4, 250 },  { frame5, 250 },  { frame6, 250 },  { frame7, 250 },
+  { frame8, 250 },  { frame9, 250 },  { frame10, 250 }, { frame11, 250 },
+  { frame12, 250 }, { frame13, 250 }, { frame14, 250 }, { frame15, 250 },
+  { frame16, 250 }, { frame17, 250 }, { frame18, 750 }
+};
+
+const Animation messageRevealAnimation = {
+  messageRevealFrames, sizeof(messageRevealFrames) / sizeof(messageRevealFrames[0]),
+  128, 64, LAYOUT_PAGES, PLAY_ONCE, 1,
+  0, 0, 0, 0, EASE_LINEAR
+};
@@ -0,0 +1,432 @@
+#include <asset_sync.h>
+#include <binary_protocol.h>
+#include <config.h>
+#include <connection_health.h>
+#include <doodle.h>
+#include <glyph_atlas.h>
+#include <image_message.h>
+#include <ota_update.h>
+#include <schedule.h>
+#include <stats_history.h>
+#include <trace.h>
+#include <LittleFS.h>
+#include <MD5Builder.h>
+#include <WebSocketsClient.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+extern WebSocketsClient webSocket;
+
+struct AssetEntry {
+  char path[ASSET_PATH_MAX + 1];
+  uint32_t size;
+  uint8_t md5[16];
+};
+
+enum SyncStep : uint8_t {
+  STEP_CHECK,     // is the asset at cursor current?
+  STEP_DOWNLOAD   // waiting for chunks of it
+};
+
+AssetSyncStats assetSyncStats;
+
+static bool syncing = false;
+static bool syncFailed = false;
+static SyncStep step = STEP_CHECK;
+static uint8_t cursor = 0;
+static uint8_t entryCount = 0;
+static AssetEntry current;
+static char partPath[ASSET_PATH_MAX + 1];
+static uint32_t partSize = 0;
+static bool waiting = false;
+static uint32_t requestedAt = 0;
+
+// Files that belong to the device, whatever a manifest says
+static const char* const statePaths[] = {
+  "/message.json", IMAGE_MESSAGE_PATH, DOODLE_MESSAGE_PATH, "/stats.json", STATS_HISTORY_PATH, "/wifi.json",
+  CONFIG_PATH, CONFIG_TEMP_PATH, "/delivery.json", "/missed_presses.txt", SCHEDULE_PATH, OTA_STATE_PATH,
+  OTA_ROLLBACK_PATH, ASSET_MANIFEST_PATH, ASSET_NEXT_PATH, TRACE_PATH
+};
+
+static bool isDeviceState(const char* path) {
+  for (const char* state : statePaths) {
+    if (strcmp(path, state) == 0) {
+      return true;
+    }
+  }
+  return strncmp(path, SCHEDULE_DIR "/", strlen(SCHEDULE_DIR) + 1) == 0 ||
+         strncmp(path, ASSET_PART_PREFIX, strlen(ASSET_PART_PREFIX)) == 0;
+}
+
+// Reads the entry at the file's position; false at the end or on a malformed entry
+static bool readEntry(File& file, AssetEntry& entry) {
+  int length = file.read();
+  if (length <= 0 || length > ASSET_PATH_MAX) {
+    return false;
+  }
+  uint8_t sizeBytes[4];
+  if (file.read((uint8_t*)entry.path, length) != length || file.read(sizeBytes, 4) != 4 ||
+      file.read(entry.md5, 16) != 16) {
+    return false;
+  }
+  entry.path[length] = '\0';
+  entry.size = readLe32(sizeBytes);
+  return true;
+}
+
+// Looks up entry index (or, with a path, the entry for it) in a stored manifest
+static bool findEntry(const char* manifestPath, int index, const char* path, AssetEntry& entry) {
+  File file = LittleFS.open(manifestPath, "r");
+  if (!file) {
+    return false;
+  }
+  int count = file.read();
+  for (int i = 0; i < count && readEntry(file, entry); i++) {
+    if (path ? strcmp(entry.path, path) == 0 : i == index) {
+      file.close();
+      return true;
+    }
+  }
+  file.close();
+  return false;
+}
+
+static bool fileMd5(const char* path, uint8_t md5[16]) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    return false;
+  }
+  MD5Builder builder;
+  builder.begin();
+  builder.addStream(file, file.size());
+  builder.calculate();
+  builder.getBytes(md5);
+  file.close();
+  return true;
+}
+
+static void toHex(const uint8_t* md5, char* hex) {
+  for (uint8_t i = 0; i < 16; i++) {
+    sprintf(hex + 2 * i, "%02x", md5[i]);
+  }
+}
+
+// True if the asset on flash already has the entry's size and content
+static bool isCurrent(const AssetEntry& entry) {
+  File file = LittleFS.open(entry.path, "r");
+  if (!file) {
+    return false;
+  }
+  size_t size = file.size();
+  file.close();
+  if (size != entry.size) {
+    return false;
+  }
+
+  // Applied by an earlier sync, nothing to hash
+  AssetEntry known;
+  if (findEntry(ASSET_MANIFEST_PATH, -1, entry.path, known) && known.size == entry.size &&
+      memcmp(known.md5, entry.md5, 16) == 0) {
+    return true;
+  }
+  uint8_t md5[16];
+  return fileMd5(entry.path, md5) && memcmp(md5, entry.md5, 16) == 0;
+}
+
+static void requestChunk() {
+  char request[128];
+  snprintf(request, sizeof(request), "{\"type\": \"asset\", \"path\": \"%s\", \"offset\": %u, \"length\": %u}",
+           current.path, partSize, ASSET_CHUNK_SIZE);
+  webSocket.sendTXT(request);
+  waiting = true;
+  requestedAt = traceMillis();
+}
+
+// Removes partial downloads other than the one in progress; the listing restarts after each removal
+static void removeStaleParts(const char* keep) {
+  bool removed = true;
+  while (removed) {
+    removed = false;
+    Dir dir = LittleFS.openDir("/");
+    while (dir.next()) {
+      String path = String("/") + dir.fileName();
+      if (path.startsWith(ASSET_PART_PREFIX) && (!keep || path != keep)) {
+        removed = LittleFS.remove(path);
+        break;
+      }
+    }
+  }
+}
+
+// Verifies the finished download and swaps it in
+static void completeFile() {
+  uint8_t md5[16];
+  if (!fileMd5(partPath, md5) || memcmp(md5, current.md5, 16) != 0) {
+    LOG_ERROR(FS, "%s failed its hash check", current.path);
+    assetSyncStats.hashFailures++;
+    syncFailed = true;
+    LittleFS.remove(partPath);
+  } else if (!LittleFS.rename(partPath, current.path)) {
+    LOG_ERROR(FS, "Failed to move %s into place", current.path);
+    syncFailed = true;
+  } else {
+    LOG_INFO(FS, "Updated %s (%u bytes)", current.path, current.size);
+    assetSyncStats.filesUpdated++;
+    if (strcmp(current.path, GLYPH_ATLAS_PATH) == 0) {
+      beginGlyphAtlas();
+    }
+  }
+  cursor++;
+  step = STEP_CHECK;
+}
+
+static void startDownload() {
+  char hex[33];
+  toHex(current.md5, hex);
+  snprintf(partPath, sizeof(partPath), ASSET_PART_PREFIX "%.16s", hex);
+  removeStaleParts(partPath);
+
+  File part = LittleFS.open(partPath, "r");
+  partSize = part ? part.size() : 0;
+  part.close();
+  if (partSize > current.size) {
+    LittleFS.remove(partPath);
+    partSize = 0;
+  }
+  if (partSize > 0) {
+    LOG_INFO(FS, "Resuming %s at %u of %u bytes", current.path, partSize, current.size);
+    assetSyncStats.resumedBytes += partSize;
+  }
+
+  step = STEP_DOWNLOAD;
+  if (partSize == current.size) {
+    completeFile();
+  } else {
+    requestChunk();
+  }
+}
+
+// Deletes assets the new manifest dropped and makes it the applied one
+static void finishSync() {
+  syncing = false;
+  removeStaleParts(nullptr);
+  if (syncFailed) {
+    LOG_WARN(FS, "Asset sync incomplete, retrying on the next connection");
+    return;
+  }
+
+  File previous = LittleFS.open(ASSET_MANIFEST_PATH, "r");
+  if (previous) {
+    int count = previous.read();
+    AssetEntry old;
+    AssetEntry kept;
+    for (int i = 0; i < count && readEntry(previous, old); i++) {
+      if (!findEntry(ASSET_NEXT_PATH, -1, old.path, kept) && !isDeviceState(old.path)) {
+        LittleFS.remove(old.path);
+        assetSyncStats.filesDeleted++;
+        LOG_INFO(FS, "Removed %s", old.path);
+      }
+    }
+    previous.close();
+  }
+
+  LittleFS.rename(ASSET_NEXT_PATH, ASSET_MANIFEST_PATH);
+  assetSyncStats.syncs++;
+  LOG_INFO(FS, "Assets in sync, %u files", entryCount);
+  assetSyncConnected();  // report the new manifest
+}
+
+static void startSync() {
+  File file = LittleFS.open(ASSET_NEXT_PATH, "r");
+  if (!file) {
+    return;
+  }
+  entryCount = file.read();
+  file.close();
+  syncing = true;
+  syncFailed = false;
+  step = STEP_CHECK;
+  cursor = 0;
+  waiting = false;
+}
+
+// Resumes a sync a reset interrupted. Call in setup() once LittleFS is mounted.
+void beginAssetSync() {
+  if (LittleFS.exists(ASSET_NEXT_PATH)) {
+    LOG_INFO(FS, "Resuming asset sync");
+    startSync();
+  }
+}
+
+// Reports the applied manifest to the server and picks up a transfer the disconnect cut off
+void assetSyncConnected() {
+  char hex[33] = "";
+  uint8_t md5[16];
+  if (fileMd5(ASSET_MANIFEST_PATH, md5)) {
+    toHex(md5, hex);
+  }
+  char report[80];
+  snprintf(report, sizeof(report), "{\"type\": \"assets\", \"manifest\": \"%s\"}", hex);
+  webSocket.sendTXT(report);
+
+  if (syncing && step == STEP_DOWNLOAD) {
+    requestChunk();
+  }
+}
+
+static bool isStoredManifest(const char* path, const uint8_t* payload, size_t length) {
+  File file = LittleFS.open(path, "r");
+  bool same = file && file.size() == length;
+  uint8_t chunk[64];
+  for (size_t at = 0; same && at < length; at += sizeof(chunk)) {
+    size_t n = min(sizeof(chunk), length - at);
+    same = file.read(chunk, n) == (int)n && memcmp(chunk, payload + at, n) == 0;
+  }
+  file.close();
+  return same;
+}
+
+/*
+  Handles a BINARY_MANIFEST frame: checks every entry, stores it and
+  starts walking it. A manifest equal to the applied one is a no-op.
+*/
+void receiveManifest(const uint8_t* payload, size_t length) {
+  StallSpan span(SPAN_FS);
+  if (length == 0 || length > ASSET_MANIFEST_MAX) {
+    LOG_ERROR(FS, "Manifest of %u bytes rejected", (unsigned)length);
+    return;
+  }
+
+  size_t at = 1;
+  for (uint8_t i = 0; i < payload[0]; i++) {
+    uint8_t pathLength = at < length ? payload[at] : 0;
+    if (pathLength == 0 || pathLength > ASSET_PATH_MAX || at + 1 + pathLength + 20 > length ||
+        payload[at + 1] != '/') {
+      LOG_ERROR(FS, "Manifest entry %u is malformed", i);
+      return;
+    }
+    char path[ASSET_PATH_MAX + 1];
+    memcpy(path, payload + at + 1, pathLength);
+    path[pathLength] = '\0';
+    if (isDeviceState(path)) {
+      LOG_ERROR(FS, "Manifest lists device state %s", path);
+      return;
+    }
+    at += 1 + pathLength + 20;
+  }
+  if (at != length) {
+    LOG_ERROR(FS, "Manifest has trailing bytes");
+    return;
+  }
+
+  if (isStoredManifest(ASSET_MANIFEST_PATH, payload, length)) {
+    LOG_INFO(FS, "Assets already up to date");
+    return;
+  }
+  if (syncing && isStoredManifest(ASSET_NEXT_PATH, payload, length)) {
+    return;  // already working on it
+  }
+
+  File file = LittleFS.open(ASSET_NEXT_PATH, "w");
+  if (!file) {
+    LOG_ERROR(FS, "Failed to open %s for writing", ASSET_NEXT_PATH);
+    return;
+  }
+  file.write(payload, length);
+  file.close();
+  LOG_INFO(FS, "New asset manifest with %u files", payload[0]);
+  startSync();
+}
+
+// Handles a BINARY_ASSET frame: appends it to the partial file if it is the chunk asked for
+void receiveAssetChunk(const uint8_t* payload, size_t length) {
+  if (length < 8 || !syncing || step != STEP_DOWNLOAD) {
+    return;
+  }
+  uint32_t id = readLe32(payload);
+  uint32_t offset = readLe32(payload + 4);
+  payload += 8;
+  length -= 8;
+  if (id != readLe32(current.md5) || offset != partSize || partSize + length > current.size) {
+    LOG_DEBUG(FS, "Ignoring asset chunk at %u", offset);
+    return;
+  }
+
+  StallSpan span(SPAN_FS);
+  File part = LittleFS.open(partPath, "a");
+  size_t written = part ? part.write(payload, length) : 0;
+  part.close();
+  if (written != length) {
+    LOG_ERROR(FS, "Failed to append to %s", partPath);
+    LittleFS.remove(partPath);
+    partSize = 0;
+    syncFailed = true;
+    cursor++;
+    step = STEP_CHECK;
+    return;
+  }
+
+  partSize += length;
+  assetSyncStats.bytesDownloaded += length;
+  waiting = false;
+  if (partSize == current.size) {
+    completeFile();
+  } else {
+    requestChunk();
+  }
+}
+
+/*
+  Checks one manifest entry per call, and asks again for a chunk that did
+  not arrive. Call once per loop() pass.
+*/
+void assetSyncTick() {
+  if (!syncing) {
+    return;
+  }
+
+  if (step == STEP_DOWNLOAD) {
+    if (waiting && connectionStats.connectedSince != 0 && traceMillis() - requestedAt > ASSET_REQUEST_TIMEOUT_MS) {
+      requestChunk();
+    }
+    return;
+  }
+
+  StallSpan span(SPAN_FS);
+  if (cursor >= entryCount) {
+    finishSync();
+    return;
+  }
+  if (!findEntry(ASSET_NEXT_PATH, cursor, nullptr, current)) {
+    LOG_ERROR(FS, "Stored manifest is damaged");
+    LittleFS.remove(ASSET_NEXT_PATH);
+    syncing = false;
+    return;
+  }
+
+  assetSyncStats.filesChecked++;
+  if (isCurrent(current)) {
+    cursor++;
+  } else {
+    startDownload();
+  }
+}
+
+bool isAssetSyncRunning() {
+  return syncing;
+}
+
+void printAssetReport() {
+  if (syncing) {
+    LOG_INFO(FS, "Asset sync at file %u of %u%s", cursor + 1, entryCount,
+             step == STEP_DOWNLOAD ? ", downloading" : "");
+    if (step == STEP_DOWNLOAD) {
+      LOG_INFO(FS, "  %s: %u of %u bytes", current.path, partSize, current.size);
+    }
+  }
+  LOG_INFO(FS, "%u syncs, %u files checked, %u updated, %u deleted, %u hash failures",
+           assetSyncStats.syncs, assetSyncStats.filesChecked, assetSyncStats.filesUpdated,
+           assetSyncStats.filesDeleted, assetSyncStats.hashFailures);
+  LOG_INFO(FS, "  %u bytes downloaded, %u resumed from flash",
+           assetSyncStats.bytesDownloaded, assetSyncStats.resumedBytes);
+}
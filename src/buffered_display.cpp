@@ -0,0 +1,219 @@
+#include <buffered_display.h>
+#include <eye_sprites.h>
+#include <log.h>
+
+BufferedDisplay::BufferedDisplay(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin)
+  : Adafruit_SSD1306(w, h, twi, rst_pin, DISPLAY_I2C_CLOCK, DISPLAY_I2C_CLOCK) {
+  memset(front, 0, sizeof(front));
+  memset(&stats, 0, sizeof(stats));
+  invalidate();
+}
+
+/*
+  Initializes the panel like Adafruit_SSD1306::begin() and leaves the bus
+  at DISPLAY_I2C_CLOCK. The panel RAM content is unknown after reset, so the
+  first frame is sent in full.
+*/
+bool BufferedDisplay::begin(uint8_t switchvcc, uint8_t i2caddr) {
+  if (!Adafruit_SSD1306::begin(switchvcc, i2caddr)) {
+    return false;
+  }
+  wire->setClock(DISPLAY_I2C_CLOCK);
+  invalidate();
+  return true;
+}
+
+/*
+  Commits the back buffer. Only the column span that differs from the front
+  buffer is marked dirty; spans still waiting from an earlier commit are
+  merged, so a page is always sent with its newest content.
+*/
+void BufferedDisplay::display() {
+  bool changed = false;
+
+  for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+    uint8_t *back = buffer + page * SCREEN_WIDTH;
+    uint8_t *shown = front + page * SCREEN_WIDTH;
+
+    int16_t first = 0;
+    while (first < SCREEN_WIDTH && back[first] == shown[first]) {
+      first++;
+    }
+    if (first == SCREEN_WIDTH) {
+      continue;
+    }
+    int16_t last = SCREEN_WIDTH - 1;
+    while (back[last] == shown[last]) {
+      last--;
+    }
+
+    memcpy(shown + first, back + first, last - first + 1);
+    if (first < dirtyFrom[page]) dirtyFrom[page] = first;
+    if (last > dirtyTo[page]) dirtyTo[page] = last;
+    changed = true;
+  }
+
+  if (changed) {
+    stats.framesCommitted++;
+  }
+}
+
+/*
+  Sends the next dirty page, if any. Call once per loop() pass.
+  Returns true if a page was sent.
+*/
+bool BufferedDisplay::pump() {
+  for (uint8_t i = 0; i < DISPLAY_PAGES; i++) {
+    uint8_t page = (nextPage + i) % DISPLAY_PAGES;
+    if (dirtyFrom[page] < SCREEN_WIDTH) {
+      sendPage(page);
+      nextPage = (page + 1) % DISPLAY_PAGES;
+      if (!isFlushing()) {
+        frameDone();
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+  Commits and sends everything that is dirty before returning.
+  For the few places that draw and then block (boot, AP setup, benchmarks).
+*/
+void BufferedDisplay::flushNow() {
+  display();
+  while (pump()) {
+  }
+}
+
+// Forgets what the panel shows; the next flush resends every page in full
+void BufferedDisplay::invalidate() {
+  for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+    dirtyFrom[page] = 0;
+    dirtyTo[page] = SCREEN_WIDTH - 1;
+  }
+}
+
+bool BufferedDisplay::isFlushing() const {
+  for (uint8_t page = 0; page < DISPLAY_PAGES; page++) {
+    if (dirtyFrom[page] < SCREEN_WIDTH) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Eye shapes come from the sprite cache; anything it cannot hold is drawn as before
+void BufferedDisplay::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  if (getRotation() != 0 || !drawSpriteRoundRect(buffer, x, y, w, h, r, color)) {
+    Adafruit_SSD1306::fillRoundRect(x, y, w, h, r, color);
+  }
+}
+
+void BufferedDisplay::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                                   int16_t x2, int16_t y2, uint16_t color) {
+  if (getRotation() != 0 || !drawSpriteTriangle(buffer, x0, y0, x1, y1, x2, y2, color)) {
+    Adafruit_SSD1306::fillTriangle(x0, y0, x1, y1, x2, y2, color);
+  }
+}
+
+/*
+  Sends the dirty span of one page: the column and page window are set in a
+  single batched command transaction, followed by the data in chunks that
+  fit the Wire buffer.
+*/
+void BufferedDisplay::sendPage(uint8_t page) {
+  uint32_t start = micros();
+  uint8_t x0 = dirtyFrom[page];
+  uint8_t x1 = dirtyTo[page];
+  dirtyFrom[page] = SCREEN_WIDTH;
+  dirtyTo[page] = 0;
+
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);  // Co = 0, D/C# = 0: command stream
+  wire->write((uint8_t)SSD1306_COLUMNADDR);
+  wire->write(x0);
+  wire->write(x1);
+  wire->write((uint8_t)SSD1306_PAGEADDR);
+  wire->write(page);
+  wire->write(page);
+  wire->endTransmission();
+
+  const uint8_t *src = front + page * SCREEN_WIDTH + x0;
+  uint16_t remaining = x1 - x0 + 1;
+  stats.bytesSent += remaining;
+  while (remaining > 0) {
+    uint16_t chunk = remaining < DISPLAY_I2C_CHUNK ? remaining : DISPLAY_I2C_CHUNK;
+    wire->beginTransmission(i2caddr);
+    wire->write((uint8_t)0x40);  // Co = 0, D/C# = 1: data stream
+    wire->write(src, chunk);
+    wire->endTransmission();
+    src += chunk;
+    remaining -= chunk;
+  }
+
+  frameBusUs += micros() - start;
+}
+
+void BufferedDisplay::frameDone() {
+  stats.framesFlushed++;
+  stats.lastFlushUs = frameBusUs;
+  if (frameBusUs > stats.maxFlushUs) {
+    stats.maxFlushUs = frameBusUs;
+  }
+  frameBusUs = 0;
+
+  uint32_t now = millis();
+  fpsFrames++;
+  if (now - fpsWindowStart >= 1000) {
+    stats.fps = fpsFrames * 1000UL / (now - fpsWindowStart);
+    fpsFrames = 0;
+    fpsWindowStart = now;
+  }
+}
+
+#ifdef LOVEBOX_BENCH
+/*
+  Compares a full-frame Adafruit_SSD1306::display() at the library's default
+  clocks against the incremental flush at DISPLAY_I2C_CLOCK, and the cost
+  of committing a frame that did not change. Results are logged.
+*/
+void BufferedDisplay::benchmark() {
+  const uint8_t runs = 10;
+  for (uint16_t i = 0; i < DISPLAY_BUFFER_SIZE; i++) {
+    buffer[i] = (uint8_t)(i * 37);
+  }
+
+  wireClk = 400000UL;
+  restoreClk = 100000UL;
+  uint32_t start = micros();
+  for (uint8_t i = 0; i < runs; i++) {
+    Adafruit_SSD1306::display();
+  }
+  uint32_t before = (micros() - start) / runs;
+  wireClk = DISPLAY_I2C_CLOCK;
+  restoreClk = DISPLAY_I2C_CLOCK;
+  wire->setClock(DISPLAY_I2C_CLOCK);
+
+  start = micros();
+  for (uint8_t i = 0; i < runs; i++) {
+    invalidate();
+    flushNow();
+  }
+  uint32_t after = (micros() - start) / runs;
+
+  start = micros();
+  for (uint8_t i = 0; i < runs; i++) {
+    flushNow();
+  }
+  uint32_t unchanged = (micros() - start) / runs;
+
+  LOG_INFO(BENCH, "display() full frame @400kHz: %u us", before);
+  LOG_INFO(BENCH, "flushNow() full frame @%lukHz: %u us", DISPLAY_I2C_CLOCK / 1000, after);
+  LOG_INFO(BENCH, "flushNow() unchanged frame: %u us", unchanged);
+
+  clearDisplay();
+  flushNow();
+}
+#endif
@@ -0,0 +1,172 @@
+#include <config.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <coredecls.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define CONFIG_MAGIC 0x31474643UL  // "CFG1"
+#define LEGACY_WIFI_PATH "/wifi.json"
+
+struct ConfigHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint32_t crc;
+};
+
+Config config;
+
+static uint32_t loadMicros = 0;  // time spent reading (and migrating) the configuration at boot
+static bool fromDefaults = false;
+
+/*
+  Puts a network in the profile list: over the profile with the same SSID,
+  else in a free slot, else over the least recently used one.
+*/
+static void addWifiProfile(const char* ssid, const char* password) {
+  WifiProfile* slot = nullptr;
+  for (WifiProfile& profile : config.wifi) {
+    if (strcmp(profile.ssid, ssid) == 0) {
+      slot = &profile;
+      break;
+    }
+    if (!slot || (slot->ssid[0] != '\0' && (profile.ssid[0] == '\0' || profile.lastUsed < slot->lastUsed))) {
+      slot = &profile;
+    }
+  }
+  if (strcmp(slot->ssid, ssid) != 0) {
+    memset(slot, 0, sizeof(*slot));
+    strlcpy(slot->ssid, ssid, sizeof(slot->ssid));
+  }
+  strlcpy(slot->password, password, sizeof(slot->password));
+}
+
+static void setDefaults() {
+  memset(&config, 0, sizeof(config));
+  strlcpy(config.serverHost, "192.168.198.155", sizeof(config.serverHost));
+  config.serverPort = 8765;
+  config.utcOffsetSeconds = 19800;  // IST, UTC+5:30
+  config.moodIntervalMs = 15000;
+  config.debounceMs = 500;
+}
+
+// Reads the record over the defaults; false if it is missing or damaged
+static bool readRecord() {
+  File file = LittleFS.open(CONFIG_PATH, "r");
+  if (!file) {
+    return false;
+  }
+  ConfigHeader header;
+  Config stored = config;
+  bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && header.magic == CONFIG_MAGIC &&
+            header.version <= CONFIG_VERSION && header.size <= sizeof(Config) &&
+            file.read((uint8_t*)&stored, header.size) == header.size &&
+            crc32(&stored, header.size) == header.crc;
+  file.close();
+  if (!ok) {
+    LOG_ERROR(CONFIG, "%s is damaged, using defaults", CONFIG_PATH);
+    return false;
+  }
+  config = stored;
+  // Strings are terminated whatever the record says
+  config.ssid[CONFIG_SSID_MAX] = '\0';
+  config.password[CONFIG_PASSWORD_MAX] = '\0';
+  config.serverHost[CONFIG_HOST_MAX] = '\0';
+  for (WifiProfile& profile : config.wifi) {
+    profile.ssid[CONFIG_SSID_MAX] = '\0';
+    profile.password[CONFIG_PASSWORD_MAX] = '\0';
+  }
+  if (header.version < CONFIG_VERSION) {
+    LOG_INFO(CONFIG, "Upgrading configuration from version %u", header.version);
+    if (header.version < 2 && config.ssid[0] != '\0') {
+      addWifiProfile(config.ssid, config.password);
+      config.ssid[0] = '\0';
+      config.password[0] = '\0';
+    }
+    saveConfig();
+  }
+  return true;
+}
+
+// Moves the credentials the setup portal used to write to /wifi.json into the record
+static bool migrateWifiJson() {
+  File file = LittleFS.open(LEGACY_WIFI_PATH, "r");
+  if (!file) {
+    return false;
+  }
+  StaticJsonDocument<256> doc;
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  if (error) {
+    LOG_ERROR(CONFIG, "Failed to parse %s: %s", LEGACY_WIFI_PATH, error.c_str());
+    return false;
+  }
+
+  if (!saveWifiProfile(doc["ssid"] | "", doc["password"] | "")) {
+    return false;
+  }
+  LittleFS.remove(LEGACY_WIFI_PATH);
+  LOG_INFO(CONFIG, "Migrated %s", LEGACY_WIFI_PATH);
+  return true;
+}
+
+/*
+  Reads the configuration into RAM. Call in setup() once LittleFS is
+  mounted and before anything reads `config`.
+*/
+void loadConfig() {
+  StallSpan span(SPAN_FS);
+  uint32_t start = micros();
+  setDefaults();
+  fromDefaults = !readRecord() && !migrateWifiJson();
+  if (fromDefaults) {
+    setDefaults();  // a failed read or migration may have left part of a record behind
+  }
+  loadMicros = micros() - start;
+  LOG_INFO(CONFIG, "Configuration %s in %u us", fromDefaults ? "defaulted" : "loaded", loadMicros);
+}
+
+// Writes `config` to flash; the old record stays in place until the new one is complete
+bool saveConfig() {
+  StallSpan span(SPAN_FS);
+  ConfigHeader header = { CONFIG_MAGIC, CONFIG_VERSION, sizeof(Config), crc32(&config, sizeof(Config)) };
+  File file = LittleFS.open(CONFIG_TEMP_PATH, "w");
+  if (!file) {
+    LOG_ERROR(CONFIG, "Failed to open %s for writing", CONFIG_TEMP_PATH);
+    return false;
+  }
+  bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            file.write((const uint8_t*)&config, sizeof(config)) == sizeof(config);
+  file.close();
+  if (!ok || !LittleFS.rename(CONFIG_TEMP_PATH, CONFIG_PATH)) {
+    LOG_ERROR(CONFIG, "Failed to write %s", CONFIG_PATH);
+    LittleFS.remove(CONFIG_TEMP_PATH);
+    return false;
+  }
+  fromDefaults = false;
+  LOG_DEBUG(CONFIG, "Saved");
+  return true;
+}
+
+// Adds a network, or updates the password of a known one, and saves the configuration
+bool saveWifiProfile(const char* ssid, const char* password) {
+  if (strlen(ssid) == 0 || strlen(ssid) > CONFIG_SSID_MAX || strlen(password) > CONFIG_PASSWORD_MAX) {
+    return false;
+  }
+  addWifiProfile(ssid, password);
+  return saveConfig();
+}
+
+void printConfigReport() {
+  LOG_INFO(CONFIG, "Version %u, %u bytes, %s at boot in %u us", CONFIG_VERSION, (unsigned)sizeof(Config),
+           fromDefaults ? "defaulted" : "loaded", loadMicros);
+  uint8_t networks = 0;
+  for (const WifiProfile& profile : config.wifi) {
+    networks += profile.ssid[0] != '\0';
+  }
+  LOG_INFO(CONFIG, "%u of %u WiFi networks, server %s:%u", networks, CONFIG_WIFI_PROFILES,
+           config.serverHost, config.serverPort);
+  LOG_INFO(CONFIG, "UTC offset %d s, mood interval %u ms, debounce %u ms", config.utcOffsetSeconds,
+           config.moodIntervalMs, config.debounceMs);
+}
@@ -0,0 +1,180 @@
+#include <connection_health.h>
+#include <ESP8266WiFi.h>
+#include <WebSocketsClient.h>
+#include <trace.h>
+#include <log.h>
+
+extern WebSocketsClient webSocket;
+
+ConnectionStats connectionStats;
+const uint16_t rttBucketLimitsMs[RTT_HISTOGRAM_BUCKETS - 1] = {25, 50, 100, 200, 400, 800, 1600};
+
+static bool everConnected = false;
+static unsigned long lastPingSent = 0;
+static bool awaitingPong = false;
+static uint8_t missedPongs = 0;
+
+static uint8_t reconnectAttempts = 0;
+static unsigned long nextBackoffStep = 0;
+static volatile bool wifiGotIP = false;
+static volatile bool wifiLost = false;
+
+static WiFiEventHandler gotIPHandler;
+static WiFiEventHandler disconnectedHandler;
+
+static void setBackoff(uint32_t intervalMs) {
+  connectionStats.backoffMs = intervalMs;
+  webSocket.setReconnectInterval(intervalMs);
+  nextBackoffStep = traceMillis() + intervalMs;
+}
+
+static void recordRtt(uint32_t rtt) {
+  connectionStats.rttLastMs = rtt;
+  if (rtt > connectionStats.rttMaxMs) {
+    connectionStats.rttMaxMs = rtt;
+  }
+  // EWMA with alpha = 1/8, same weighting as TCP's smoothed RTT
+  if (connectionStats.pongsReceived == 0) {
+    connectionStats.rttEwmaMs = rtt;
+  } else {
+    connectionStats.rttEwmaMs = (7 * connectionStats.rttEwmaMs + rtt) / 8;
+  }
+  connectionStats.pongsReceived++;
+
+  uint8_t bucket = 0;
+  while (bucket < RTT_HISTOGRAM_BUCKETS - 1 && rtt >= rttBucketLimitsMs[bucket]) {
+    bucket++;
+  }
+  connectionStats.rttHistogram[bucket]++;
+}
+
+/*
+  Registers the WiFi event handlers and sets the initial reconnect interval.
+  Call once after webSocket.begin().
+*/
+void beginConnectionHealth() {
+  gotIPHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP&) {
+    wifiGotIP = true;
+  });
+  disconnectedHandler = WiFi.onStationModeDisconnected([](const WiFiEventStationModeDisconnected&) {
+    wifiLost = true;
+  });
+  setBackoff(WS_RECONNECT_BASE_MS);
+}
+
+/*
+  Called every loop() pass. Drives the heartbeat while connected and grows
+  the reconnect interval while not.
+*/
+void connectionHealthTick() {
+  unsigned long now = traceMillis();
+
+  if (wifiLost) {
+    wifiLost = false;
+    // The socket is dead either way; don't wait for the heartbeat to notice
+    if (webSocket.isConnected()) {
+      LOG_WARN(WS, "WiFi lost, dropping the connection");
+      webSocket.disconnect();
+    }
+  }
+
+  if (wifiGotIP) {
+    wifiGotIP = false;
+    LOG_INFO(WS, "WiFi got IP, reconnecting now");
+    reconnectAttempts = 0;
+    setBackoff(1);  // the library retries on its next loop()
+    return;
+  }
+
+  if (!webSocket.isConnected()) {
+    // The library retries once per interval; each elapsed interval counts as
+    // a failed attempt and widens the next one
+    if ((long)(now - nextBackoffStep) >= 0) {
+      if (reconnectAttempts < 255) {
+        reconnectAttempts++;
+      }
+      setBackoff(backoffInterval(reconnectAttempts, random(0x7FFFFFFF)));
+    }
+    return;
+  }
+
+  if (awaitingPong) {
+    if (now - lastPingSent > WS_PONG_TIMEOUT_MS) {
+      awaitingPong = false;
+      missedPongs++;
+      LOG_WARN(WS, "Pong timeout (%u missed)", missedPongs);
+      if (missedPongs >= WS_MAX_MISSED_PONGS) {
+        LOG_WARN(WS, "Connection presumed dead, dropping it");
+        webSocket.disconnect();
+      }
+    }
+  } else if (now - lastPingSent >= WS_HEARTBEAT_INTERVAL_MS) {
+    if (webSocket.sendPing()) {
+      lastPingSent = now;
+      awaitingPong = true;
+      connectionStats.pingsSent++;
+    }
+  }
+}
+
+void onConnectionEstablished() {
+  if (everConnected) {
+    connectionStats.reconnects++;
+  }
+  everConnected = true;
+  connectionStats.connectedSince = traceMillis();
+
+  reconnectAttempts = 0;
+  missedPongs = 0;
+  awaitingPong = false;
+  lastPingSent = traceMillis();
+  setBackoff(WS_RECONNECT_BASE_MS);
+}
+
+void onConnectionLost() {
+  if (connectionStats.connectedSince != 0) {
+    printConnectionReport();
+  }
+  connectionStats.connectedSince = 0;
+  awaitingPong = false;
+  setBackoff(backoffInterval(reconnectAttempts, random(0x7FFFFFFF)));
+}
+
+void onHeartbeatPong() {
+  if (!awaitingPong) {
+    return;  // unsolicited pong, nothing to time
+  }
+  awaitingPong = false;
+  missedPongs = 0;
+  recordRtt(traceMillis() - lastPingSent);
+
+  if (connectionStats.pongsReceived % 20 == 0) {
+    printConnectionReport();
+  }
+}
+
+/*
+  Logs connection quality:
+    ... I [WS] RSSI -61 dBm, up 3600 s, reconnects 2, backoff 2000 ms
+    ... I [WS] RTT ewma 42 ms, last 38 ms, max 310 ms, 240/241 pongs
+    ... I [WS] RTT <25:10 <50:200 <100:25 <200:4 <400:1 <800:0 <1600:0 >=1600:0
+*/
+void printConnectionReport() {
+  uint32_t up = connectionStats.connectedSince ? (traceMillis() - connectionStats.connectedSince) / 1000 : 0;
+  LOG_INFO(WS, "RSSI %d dBm, up %u s, reconnects %u, backoff %u ms",
+           WiFi.RSSI(), up, connectionStats.reconnects, connectionStats.backoffMs);
+  LOG_INFO(WS, "RTT ewma %u ms, last %u ms, max %u ms, %u/%u pongs",
+           connectionStats.rttEwmaMs, connectionStats.rttLastMs, connectionStats.rttMaxMs,
+           connectionStats.pongsReceived, connectionStats.pingsSent);
+
+  char histogram[96];
+  size_t used = 0;
+  for (uint8_t i = 0; i < RTT_HISTOGRAM_BUCKETS && used < sizeof(histogram); i++) {
+    if (i < RTT_HISTOGRAM_BUCKETS - 1) {
+      used += snprintf(histogram + used, sizeof(histogram) - used, " <%u:%u", rttBucketLimitsMs[i], connectionStats.rttHistogram[i]);
+    } else {
+      used += snprintf(histogram + used, sizeof(histogram) - used, " >=%u:%u", rttBucketLimitsMs[i - 1], connectionStats.rttHistogram[i]);
+    }
+  }
+  LOG_INFO(WS, "RTT%s", histogram);
+}
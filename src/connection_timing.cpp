@@ -0,0 +1,18 @@
+#include <connection_timing.h>
+
+/*
+  Exponential backoff with "equal jitter": half of the interval is fixed,
+  the other half random, so a fleet that lost the server together does not
+  come back in lockstep. randomValue is any uniform 32-bit draw; the
+  caller brings its own generator.
+*/
+uint32_t backoffInterval(uint8_t attempt, uint32_t randomValue) {
+  uint32_t interval = WS_RECONNECT_BASE_MS;
+  while (attempt-- > 0 && interval < WS_RECONNECT_MAX_MS) {
+    interval *= 2;
+  }
+  if (interval > WS_RECONNECT_MAX_MS) {
+    interval = WS_RECONNECT_MAX_MS;
+  }
+  return interval / 2 + randomValue % (interval / 2 + 1);
+}
@@ -0,0 +1,293 @@
+#include <data_export.h>
+#include <LittleFS.h>
+#include <memory>
+#include <time.h>
+#include <doodle.h>
+#include <image_message.h>
+#include <schedule.h>
+#include <stats.h>
+#include <stats_history.h>
+#include <heap_monitor.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+enum ExportKind : uint8_t {
+  EXPORT_STATS,
+  EXPORT_MESSAGES,
+  EXPORT_LOG
+};
+
+static uint8_t activeExports = 0;
+
+static const char* const counterColumns[STATS_COUNTER_COUNT] = {
+  "headpats", "miss_you", "mood_swings", "messages"
+};
+
+#define STATS_SERIES_ROWS (STATS_HOURLY_SLOTS + STATS_DAILY_SLOTS)  // per counter
+
+// Where an export is, kept between chunks; counts itself in activeExports
+struct ExportCursor {
+  explicit ExportCursor(ExportKind kind) : kind(kind) { activeExports++; }
+  ~ExportCursor() { activeExports--; }
+
+  ExportKind kind;
+  uint16_t step = 0;         // row (stats), message (messages) or boot (log) produced next
+  uint32_t position = 0;     // log: next byte of the boot's kept log
+  char line[EXPORT_LINE_MAX];
+  uint16_t lineLength = 0;
+  uint16_t lineSent = 0;
+  char body[32] = "";        // stored message being copied, empty when none
+  uint32_t bodyOffset = 0;
+  uint16_t series[STATS_DAILY_SLOTS];
+  uint32_t seriesFirst = 0;  // bucket of series[0]
+};
+
+static void appendLine(ExportCursor& cursor, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void appendLine(ExportCursor& cursor, const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(cursor.line + cursor.lineLength, EXPORT_LINE_MAX - cursor.lineLength, format, args);
+  va_end(args);
+  cursor.lineLength = min<int>(cursor.lineLength + max(length, 0), EXPORT_LINE_MAX - 1);
+}
+
+// JSON string contents; cut short to leave room for the closing `"}` and newline
+static void appendEscaped(ExportCursor& cursor, const char* text) {
+  for (; *text; text++) {
+    if (cursor.lineLength + 6 + 3 >= EXPORT_LINE_MAX) {
+      break;
+    }
+    char c = *text;
+    if (c == '"' || c == '\\') {
+      cursor.line[cursor.lineLength++] = '\\';
+      cursor.line[cursor.lineLength++] = c;
+    } else if ((uint8_t)c < 0x20) {
+      cursor.lineLength += snprintf(cursor.line + cursor.lineLength, 7, "\\u%04x", c);
+    } else {
+      cursor.line[cursor.lineLength++] = c;
+    }
+  }
+}
+
+/*
+  stats.csv: a header, the lifetime totals, then every counter's hourly
+  and daily series. A series is read from flash when its first row is due.
+*/
+static bool nextStatsLine(ExportCursor& cursor) {
+  uint16_t step = cursor.step++;
+  if (step == 0) {
+    appendLine(cursor, "counter,period,start,count\n");
+    return true;
+  }
+  if (step <= STATS_COUNTER_COUNT) {
+    const int totals[STATS_COUNTER_COUNT] = {
+      stats.headpats, stats.missYouPresses, stats.moodSwings, stats.messagesReceived
+    };
+    appendLine(cursor, "%s,total,,%d\n", counterColumns[step - 1], totals[step - 1]);
+    return true;
+  }
+
+  uint16_t row = step - STATS_COUNTER_COUNT - 1;
+  if (row >= STATS_COUNTER_COUNT * STATS_SERIES_ROWS || newestStatsBucket(STATS_HOURLY) == 0) {
+    return false;
+  }
+  StatsCounter counter = (StatsCounter)(row / STATS_SERIES_ROWS);
+  uint16_t index = row % STATS_SERIES_ROWS;
+  StatsResolution resolution = index < STATS_HOURLY_SLOTS ? STATS_HOURLY : STATS_DAILY;
+  if (resolution == STATS_DAILY) {
+    index -= STATS_HOURLY_SLOTS;
+  }
+  if (index == 0) {
+    uint8_t length = readStatsSeries(counter, resolution, cursor.series);
+    cursor.seriesFirst = newestStatsBucket(resolution) - (length - 1);
+  }
+
+  // Buckets count local time from the epoch, so gmtime() gives the local date
+  uint32_t seconds = resolution == STATS_HOURLY ? 3600 : 86400;
+  time_t start = (time_t)(cursor.seriesFirst + index) * seconds;
+  struct tm local;
+  gmtime_r(&start, &local);
+  appendLine(cursor, "%s,%s,%04d-%02d-%02d", counterColumns[counter], resolution == STATS_HOURLY ? "hour" : "day",
+             local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+  if (resolution == STATS_HOURLY) {
+    appendLine(cursor, "T%02d:00", local.tm_hour);
+  }
+  appendLine(cursor, ",%u\n", cursor.series[index]);
+  return true;
+}
+
+static size_t fileSize(const char* path) {
+  File file = LittleFS.open(path, "r");
+  size_t size = file ? file.size() : 0;
+  file.close();
+  return size;
+}
+
+/*
+  messages.ndjson: the message on screen, then each scheduled one. The
+  line is the opening of the object; the stored JSON is copied after it
+  by fillExport().
+*/
+static bool nextMessageLine(ExportCursor& cursor) {
+  while (true) {
+    uint16_t step = cursor.step++;
+    if (step == 0) {
+      if (LittleFS.exists("/message.json")) {
+        strlcpy(cursor.body, "/message.json", sizeof(cursor.body));
+        appendLine(cursor, "{\"state\": \"current\", \"message\": ");
+      } else if (LittleFS.exists(IMAGE_MESSAGE_PATH)) {
+        appendLine(cursor, "{\"state\": \"current\", \"type\": \"image\", \"bytes\": %u}\n",
+                   (unsigned)fileSize(IMAGE_MESSAGE_PATH));
+      } else if (LittleFS.exists(DOODLE_MESSAGE_PATH)) {
+        appendLine(cursor, "{\"state\": \"current\", \"type\": \"doodle\", \"bytes\": %u}\n",
+                   (unsigned)fileSize(DOODLE_MESSAGE_PATH));
+      } else {
+        continue;
+      }
+      cursor.bodyOffset = 0;
+      return true;
+    }
+
+    ScheduledMessage entry;
+    if (!readScheduledEntry(step - 1, entry)) {
+      return false;
+    }
+    scheduledBodyPath(entry.id, cursor.body, sizeof(cursor.body));
+    cursor.bodyOffset = 0;
+    appendLine(cursor, "{\"state\": \"scheduled\", \"seq\": %u, \"revealAt\": %u, \"message\": ", entry.seq,
+               entry.revealAt);
+    return true;
+  }
+}
+
+// log.ndjson: "<millis> <level> [<tag>] <text>" lines split into fields
+static bool nextLogLine(ExportCursor& cursor) {
+  char text[LOG_LINE_MAX];
+  while (!readKeptLogLine(cursor.step == 0, cursor.position, text, sizeof(text))) {
+    if (++cursor.step > 1) {
+      return false;
+    }
+    cursor.position = 0;
+  }
+  appendLine(cursor, "{\"boot\": \"%s\", ", cursor.step == 0 ? "previous" : "current");
+
+  char* rest;
+  unsigned long ms = strtoul(text, &rest, 10);
+  char* close = rest != text && rest[0] == ' ' && rest[1] && rest[2] == ' ' && rest[3] == '[' ? strchr(rest + 4, ']')
+                                                                                              : nullptr;
+  if (close && close[1] == ' ') {
+    *close = '\0';
+    appendLine(cursor, "\"ms\": %lu, \"level\": \"%c\", \"tag\": \"", ms, rest[1]);
+    appendEscaped(cursor, rest + 4);
+    appendLine(cursor, "\", \"text\": \"");
+    appendEscaped(cursor, close + 2);
+  } else {
+    appendLine(cursor, "\"text\": \"");
+    appendEscaped(cursor, text);
+  }
+  appendLine(cursor, "\"}\n");
+  return true;
+}
+
+/*
+  Copies the next piece of the stored message into buffer, newlines
+  turned into spaces so the record stays on one line. Closes the record
+  once the file is done; a missing body exports as null.
+*/
+static size_t copyBody(ExportCursor& cursor, uint8_t* buffer, size_t maxLen) {
+  File file = LittleFS.open(cursor.body, "r");
+  size_t got = 0;
+  if (file && file.seek(cursor.bodyOffset)) {
+    got = file.read(buffer, maxLen);
+  }
+  file.close();
+
+  if (got == 0) {
+    appendLine(cursor, "%s", cursor.bodyOffset == 0 ? "null}\n" : "}\n");
+    cursor.body[0] = '\0';
+    return 0;
+  }
+  for (size_t i = 0; i < got; i++) {
+    if (buffer[i] == '\n' || buffer[i] == '\r') {
+      buffer[i] = ' ';
+    }
+  }
+  cursor.bodyOffset += got;
+  return got;
+}
+
+// Fills one chunk of the response; 0 ends it
+static size_t fillExport(ExportCursor& cursor, uint8_t* buffer, size_t maxLen) {
+  StallSpan span(SPAN_WEB);
+  size_t written = 0;
+  while (written < maxLen) {
+    if (cursor.lineSent < cursor.lineLength) {
+      size_t chunk = min<size_t>(cursor.lineLength - cursor.lineSent, maxLen - written);
+      memcpy(buffer + written, cursor.line + cursor.lineSent, chunk);
+      cursor.lineSent += chunk;
+      written += chunk;
+      continue;
+    }
+    cursor.lineLength = 0;
+    cursor.lineSent = 0;
+
+    if (cursor.body[0] != '\0') {
+      written += copyBody(cursor, buffer + written, maxLen - written);
+      continue;
+    }
+
+    bool more;
+    switch (cursor.kind) {
+      case EXPORT_STATS:
+        more = nextStatsLine(cursor);
+        break;
+      case EXPORT_MESSAGES:
+        more = nextMessageLine(cursor);
+        break;
+      default:
+        more = nextLogLine(cursor);
+        break;
+    }
+    if (!more) {
+      break;
+    }
+  }
+  return written;
+}
+
+static void sendExport(AsyncWebServerRequest* request, ExportKind kind, const char* contentType,
+                       const char* filename) {
+  if (activeExports >= EXPORT_MAX_ACTIVE || heapWarning() != HEAP_OK) {
+    LOG_WARN(EXPORT, "Refusing %s: %u exports running, heap %s", filename, activeExports,
+             heapWarning() == HEAP_OK ? "ok" : "low");
+    request->send(503, "text/plain", "Busy, try again later");
+    return;
+  }
+
+  LOG_INFO(EXPORT, "Exporting %s", filename);
+  std::shared_ptr<ExportCursor> cursor = std::make_shared<ExportCursor>(kind);
+  AsyncWebServerResponse* response = request->beginChunkedResponse(
+    contentType, [cursor](uint8_t* buffer, size_t maxLen, size_t /*index*/) -> size_t {
+      return fillExport(*cursor, buffer, maxLen);
+    });
+  response->addHeader("Content-Disposition", String("attachment; filename=") + filename);
+  request->send(response);
+}
+
+/*
+  Registers the export endpoints. Call before server.begin(); the server
+  frees a cursor with its response, when the export ends or the client
+  goes away.
+*/
+void beginDataExport(AsyncWebServer& server) {
+  server.on("/export/stats.csv", HTTP_GET, [](AsyncWebServerRequest* request) {
+    sendExport(request, EXPORT_STATS, "text/csv", "stats.csv");
+  });
+  server.on("/export/messages.ndjson", HTTP_GET, [](AsyncWebServerRequest* request) {
+    sendExport(request, EXPORT_MESSAGES, "application/x-ndjson", "messages.ndjson");
+  });
+  server.on("/export/log.ndjson", HTTP_GET, [](AsyncWebServerRequest* request) {
+    sendExport(request, EXPORT_LOG, "application/x-ndjson", "log.ndjson");
+  });
+}
@@ -0,0 +1,44 @@
+#include <delivery_window.h>
+
+bool isDuplicateInWindow(const DeliveryWindow& window, uint32_t seq) {
+  if (seq <= window.ackedSeq) {
+    return true;
+  }
+
+  uint32_t offset = seq - window.ackedSeq - 1;
+  if (offset >= DELIVERY_WINDOW_SIZE) {
+    return false;
+  }
+  return (window.pendingWindow >> offset) & 1;
+}
+
+/*
+  True if seq is too far above the cumulative ACK for the window to track.
+  Such a message must not be stored: the ACK only ever covers sequences
+  that were received, so the server resends the gap below it first.
+*/
+bool isBeyondWindow(const DeliveryWindow& window, uint32_t seq) {
+  return seq > window.ackedSeq && seq - window.ackedSeq - 1 >= DELIVERY_WINDOW_SIZE;
+}
+
+/*
+  Records seq as received and slides the cumulative ACK over any contiguous
+  run that is now complete.
+
+  Returns false, changing nothing, for seq 0, a duplicate or a seq beyond
+  the window.
+*/
+bool recordInWindow(DeliveryWindow& window, uint32_t seq) {
+  if (seq == 0 || isDuplicateInWindow(window, seq) || isBeyondWindow(window, seq)) {
+    return false;
+  }
+
+  uint32_t offset = seq - window.ackedSeq - 1;
+  window.pendingWindow |= (uint64_t)1 << offset;
+
+  // Length of the run of received sequences directly above the ACK
+  uint32_t run = (window.pendingWindow == ~(uint64_t)0) ? DELIVERY_WINDOW_SIZE : __builtin_ctzll(~window.pendingWindow);
+  window.pendingWindow = run >= DELIVERY_WINDOW_SIZE ? 0 : window.pendingWindow >> run;
+  window.ackedSeq += run;
+  return true;
+}
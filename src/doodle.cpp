@@ -0,0 +1,225 @@
+#include <doodle.h>
+#include <buffered_display.h>
+#include <trace.h>
+#include <LittleFS.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+extern BufferedDisplay display;
+
+static uint8_t commands[DOODLE_MAX_BYTES];
+static size_t commandsLength = 0;
+
+static bool playing = false;
+static size_t next = 0;               // offset of the next command
+static uint8_t polylinePoints = 0;    // points left in the current DOODLE_POLYLINE
+static int16_t penX = 0;
+static int16_t penY = 0;
+static uint16_t ink = SSD1306_WHITE;
+static uint32_t lastStep = 0;
+static uint32_t holdUntil = 0;
+
+// Operand bytes per opcode; 0xFF marks an unknown one
+static uint8_t operandCount(uint8_t op) {
+  switch (op) {
+    case DOODLE_MOVE:
+    case DOODLE_LINE: return 2;
+    case DOODLE_POLYLINE: return 1;  // plus 2 per point
+    case DOODLE_CIRCLE:
+    case DOODLE_DISC:
+    case DOODLE_HEART: return 3;
+    case DOODLE_BOX: return 4;
+    case DOODLE_INK:
+    case DOODLE_PAUSE: return 1;
+    default: return 0xFF;
+  }
+}
+
+/*
+  Walks the commands without drawing; false if an opcode is unknown or
+  its operands run past the end.
+*/
+bool isValidDoodle(const uint8_t* data, size_t length) {
+  if (length == 0 || length > DOODLE_MAX_BYTES) {
+    return false;
+  }
+  size_t at = 0;
+  while (at < length) {
+    size_t operands = operandCount(data[at]);
+    if (operands == 0xFF || at + 1 + operands > length) {
+      return false;
+    }
+    if (data[at] == DOODLE_POLYLINE) {
+      operands += 2 * data[at + 1];
+      if (at + 1 + operands > length) {
+        return false;
+      }
+    }
+    at += 1 + operands;
+  }
+  return true;
+}
+
+bool saveDoodleMessage(const uint8_t* data, size_t length) {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(DOODLE_MESSAGE_PATH, "w");
+  if (!file) {
+    LOG_ERROR(FS, "Failed to open %s for writing", DOODLE_MESSAGE_PATH);
+    return false;
+  }
+  size_t written = file.write(data, length);
+  file.close();
+  if (written != length) {
+    LittleFS.remove(DOODLE_MESSAGE_PATH);  // a cut doodle would draw half a picture
+    return false;
+  }
+  return true;
+}
+
+// Reads the saved doodle for startDoodle(); false if there is none
+bool loadDoodleMessage() {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(DOODLE_MESSAGE_PATH, "r");
+  if (!file) {
+    return false;
+  }
+  size_t length = file.size();
+  if (length > DOODLE_MAX_BYTES) {
+    file.close();
+    LOG_ERROR(FS, "%s too large", DOODLE_MESSAGE_PATH);
+    return false;
+  }
+  commandsLength = file.read(commands, length);
+  file.close();
+
+  if (!isValidDoodle(commands, commandsLength)) {
+    LOG_ERROR(FS, "%s is not a valid doodle", DOODLE_MESSAGE_PATH);
+    commandsLength = 0;
+    return false;
+  }
+  return true;
+}
+
+static void drawHeart(Adafruit_GFX& gfx, int16_t x, int16_t y, int16_t s, uint16_t color) {
+  int16_t r = (s + 1) / 2;
+  gfx.fillCircle(x - r, y - r / 2, r, color);
+  gfx.fillCircle(x + r, y - r / 2, r, color);
+  gfx.fillTriangle(x - 2 * r, y - r / 2 + 1, x + 2 * r, y - r / 2 + 1, x, y + s + r / 2, color);
+}
+
+// Draws one segment, i.e. one command or one polyline point
+static void step(Adafruit_GFX& gfx) {
+  if (polylinePoints > 0) {
+    int16_t x = commands[next];
+    int16_t y = commands[next + 1];
+    gfx.drawLine(penX, penY, x, y, ink);
+    penX = x;
+    penY = y;
+    next += 2;
+    polylinePoints--;
+    return;
+  }
+
+  const uint8_t* c = commands + next;
+  next += 1 + operandCount(c[0]);
+  switch (c[0]) {
+    case DOODLE_MOVE:
+      penX = c[1];
+      penY = c[2];
+      break;
+    case DOODLE_LINE:
+      gfx.drawLine(penX, penY, c[1], c[2], ink);
+      penX = c[1];
+      penY = c[2];
+      break;
+    case DOODLE_POLYLINE:
+      polylinePoints = c[1];
+      break;
+    case DOODLE_CIRCLE:
+      gfx.drawCircle(c[1], c[2], c[3], ink);
+      break;
+    case DOODLE_DISC:
+      gfx.fillCircle(c[1], c[2], c[3], ink);
+      break;
+    case DOODLE_HEART:
+      drawHeart(gfx, c[1], c[2], c[3], ink);
+      break;
+    case DOODLE_BOX:
+      gfx.fillRect(c[1], c[2], c[3], c[4], ink);
+      break;
+    case DOODLE_INK:
+      ink = c[1];
+      break;
+    case DOODLE_PAUSE:
+      holdUntil = traceMillis() + c[1] * 10UL;
+      break;
+  }
+}
+
+/*
+  Starts drawing the loaded doodle on a cleared screen; the strokes follow
+  from doodleTick().
+*/
+void startDoodle() {
+  if (commandsLength == 0) {
+    return;
+  }
+  next = 0;
+  polylinePoints = 0;
+  penX = 0;
+  penY = 0;
+  ink = SSD1306_WHITE;
+  lastStep = traceMillis();
+  holdUntil = 0;
+  playing = true;
+
+  display.clearDisplay();
+  display.display();
+}
+
+/*
+  Draws the segments that are due; call once per loop() pass.
+  Returns false once the doodle is complete (or if none is playing).
+*/
+bool doodleTick() {
+  if (!playing) {
+    return false;
+  }
+  uint32_t now = traceMillis();
+  if ((int32_t)(now - holdUntil) < 0) {
+    return true;
+  }
+
+  // Segments due since the last pass, bounded so one pass stays short
+  uint32_t due = (now - lastStep) / DOODLE_MS_PER_SEGMENT;
+  if (due == 0) {
+    return true;
+  }
+  if (due > DOODLE_SEGMENTS_PER_PASS) {
+    due = DOODLE_SEGMENTS_PER_PASS;
+    lastStep = now;
+  } else {
+    lastStep += due * DOODLE_MS_PER_SEGMENT;
+  }
+
+  // Through the base class, so shapes bypass the eye sprite cache
+  Adafruit_GFX& gfx = display;
+  while (due-- > 0 && next < commandsLength && (int32_t)(traceMillis() - holdUntil) >= 0) {
+    step(gfx);
+  }
+  display.display();
+
+  if (next >= commandsLength && polylinePoints == 0) {
+    playing = false;
+    return false;
+  }
+  return true;
+}
+
+bool isDoodlePlaying() {
+  return playing;
+}
+
+void stopDoodle() {
+  playing = false;
+}
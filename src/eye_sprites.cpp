@@ -0,0 +1,240 @@
+#include <eye_sprites.h>
+#include <buffered_display.h>
+#include <log.h>
+
+enum EyeShape : uint8_t {
+  SHAPE_NONE,
+  SHAPE_ROUND_RECT,
+  SHAPE_TRIANGLE
+};
+
+// A rasterized shape; bits are page-major, byte (page * w + column), bit 0 at the top
+struct EyeSprite {
+  uint8_t key[7];  // shape, then size and radius or the vertices relative to the top left
+  uint8_t w;
+  uint8_t h;
+  uint32_t lastUsed;
+  uint8_t bits[EYE_SPRITE_PAGES * EYE_SPRITE_MAX_W];
+};
+
+// Adafruit_GFX target that rasterizes straight into a sprite, so cached shapes match the primitives pixel for pixel
+class SpriteCanvas : public Adafruit_GFX {
+public:
+  explicit SpriteCanvas(EyeSprite& sprite) : Adafruit_GFX(sprite.w, sprite.h), sprite(sprite) {
+    memset(sprite.bits, 0, sizeof(sprite.bits));
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= sprite.w || y >= sprite.h || !color) {
+      return;
+    }
+    sprite.bits[(y / 8) * sprite.w + x] |= 1 << (y & 7);
+  }
+
+private:
+  EyeSprite& sprite;
+};
+
+EyeSpriteStats eyeSpriteStats;
+bool eyeSpritesEnabled = true;
+
+static EyeSprite sprites[EYE_SPRITE_SLOTS];
+static uint32_t useCounter = 0;
+
+/*
+  Returns the slot holding this shape, or claims the least recently used
+  one for it (fresh is then set and the caller rasterizes into it).
+*/
+static EyeSprite& findSprite(const uint8_t* key, uint8_t w, uint8_t h, bool& fresh) {
+  useCounter++;
+  EyeSprite* victim = &sprites[0];
+  for (uint8_t i = 0; i < EYE_SPRITE_SLOTS; i++) {
+    EyeSprite& sprite = sprites[i];
+    if (sprite.key[0] != SHAPE_NONE && memcmp(sprite.key, key, sizeof(sprite.key)) == 0) {
+      sprite.lastUsed = useCounter;
+      eyeSpriteStats.hits++;
+      fresh = false;
+      return sprite;
+    }
+    if (victim->key[0] != SHAPE_NONE && (sprite.key[0] == SHAPE_NONE || sprite.lastUsed < victim->lastUsed)) {
+      victim = &sprite;
+    }
+  }
+
+  if (victim->key[0] == SHAPE_NONE) {
+    eyeSpriteStats.slotsUsed++;
+  } else {
+    eyeSpriteStats.evictions++;
+  }
+  eyeSpriteStats.misses++;
+  memcpy(victim->key, key, sizeof(victim->key));
+  victim->w = w;
+  victim->h = h;
+  victim->lastUsed = useCounter;
+  fresh = true;
+  return *victim;
+}
+
+static inline void applyByte(uint8_t* buffer, int16_t page, int16_t x, uint8_t bits, uint16_t color) {
+  if (!bits || page < 0 || page >= DISPLAY_PAGES) {
+    return;
+  }
+  uint8_t* dst = buffer + page * SCREEN_WIDTH + x;
+  switch (color) {
+    case SSD1306_WHITE: *dst |= bits; break;
+    case SSD1306_BLACK: *dst &= ~bits; break;
+    case SSD1306_INVERSE: *dst ^= bits; break;
+  }
+}
+
+// Copies a sprite into the frame buffer with its top left corner at x, y; clipped to the screen
+static void blitSprite(uint8_t* buffer, const EyeSprite& sprite, int16_t x, int16_t y, uint16_t color) {
+  int16_t firstPage = y >> 3;  // floor, also for negative y
+  uint8_t shift = y & 7;
+  uint8_t pages = (sprite.h + 7) / 8;
+
+  int16_t from = max<int16_t>(0, -x);
+  int16_t to = min<int16_t>(sprite.w, SCREEN_WIDTH - x);
+  for (uint8_t page = 0; page < pages; page++) {
+    const uint8_t* src = sprite.bits + page * sprite.w;
+    for (int16_t column = from; column < to; column++) {
+      uint16_t bits = (uint16_t)src[column] << shift;
+      applyByte(buffer, firstPage + page, x + column, bits, color);
+      applyByte(buffer, firstPage + page + 1, x + column, bits >> 8, color);
+    }
+  }
+}
+
+static EyeSprite* roundRectSprite(int16_t w, int16_t h, int16_t r) {
+  if (w <= 0 || h <= 0 || w > EYE_SPRITE_MAX_W || h > EYE_SPRITE_MAX_H) {
+    return nullptr;
+  }
+  int16_t maxRadius = min(w, h) / 2;  // as Adafruit_GFX clamps it
+  r = constrain(r, 0, maxRadius);
+
+  const uint8_t key[7] = { SHAPE_ROUND_RECT, (uint8_t)w, (uint8_t)h, (uint8_t)r, 0, 0, 0 };
+  bool fresh;
+  EyeSprite& sprite = findSprite(key, w, h, fresh);
+  if (fresh) {
+    SpriteCanvas canvas(sprite);
+    canvas.fillRoundRect(0, 0, w, h, r, SSD1306_WHITE);
+  }
+  return &sprite;
+}
+
+/*
+  Draws a filled rounded rectangle from the cache. Returns false when the
+  caller has to draw it with the primitive instead.
+*/
+bool drawSpriteRoundRect(uint8_t* buffer, int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+  if (!eyeSpritesEnabled) {
+    return false;
+  }
+  EyeSprite* sprite = roundRectSprite(w, h, r);
+  if (!sprite) {
+    eyeSpriteStats.fallbacks++;
+    return false;
+  }
+  blitSprite(buffer, *sprite, x, y, color);
+  return true;
+}
+
+/*
+  Draws a filled triangle from the cache; shapes are keyed by their
+  vertices relative to the bounding box, so a moving eyelid still hits.
+*/
+bool drawSpriteTriangle(uint8_t* buffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        int16_t x2, int16_t y2, uint16_t color) {
+  if (!eyeSpritesEnabled) {
+    return false;
+  }
+  int16_t left = min(x0, min(x1, x2));
+  int16_t top = min(y0, min(y1, y2));
+  int16_t w = max(x0, max(x1, x2)) - left + 1;
+  int16_t h = max(y0, max(y1, y2)) - top + 1;
+  if (w > EYE_SPRITE_MAX_W || h > EYE_SPRITE_MAX_H) {
+    eyeSpriteStats.fallbacks++;
+    return false;
+  }
+
+  const uint8_t key[7] = { SHAPE_TRIANGLE,
+                           (uint8_t)(x0 - left), (uint8_t)(y0 - top),
+                           (uint8_t)(x1 - left), (uint8_t)(y1 - top),
+                           (uint8_t)(x2 - left), (uint8_t)(y2 - top) };
+  bool fresh;
+  EyeSprite& sprite = findSprite(key, w, h, fresh);
+  if (fresh) {
+    SpriteCanvas canvas(sprite);
+    canvas.fillTriangle(key[1], key[2], key[3], key[4], key[5], key[6], SSD1306_WHITE);
+  }
+  blitSprite(buffer, sprite, left, top, color);
+  return true;
+}
+
+/*
+  Rasterizes the eye at every height a blink passes through. RoboEyes
+  tweens the height halfway towards its target each frame, down to 1 and
+  back up, so that is the sequence walked here. Call in setup() with the
+  geometry given to setWidth()/setHeight()/setBorderradius().
+*/
+void prerenderEyeSprites(int16_t w, int16_t h, int16_t r) {
+  int16_t height = h;
+  while (height > 1) {
+    roundRectSprite(w, height, r);
+    height = (height + 1) / 2;
+  }
+  while (true) {
+    roundRectSprite(w, height, r);
+    int16_t next = (height + h) / 2;
+    if (next == height) {
+      break;
+    }
+    height = next;
+  }
+  roundRectSprite(w, h, r);
+  eyeSpriteStats.hits = 0;
+}
+
+#ifdef LOVEBOX_BENCH
+extern BufferedDisplay display;
+
+// Two open eyes with tired eyelids, the way RoboEyes draws them
+static void drawBenchEyes() {
+  display.fillRoundRect(22, 17, 30, 30, 15, SSD1306_WHITE);
+  display.fillRoundRect(76, 17, 30, 30, 15, SSD1306_WHITE);
+  display.fillTriangle(22, 16, 52, 16, 22, 31, SSD1306_BLACK);
+  display.fillTriangle(76, 16, 106, 16, 106, 31, SSD1306_BLACK);
+}
+
+/*
+  Times an eye frame drawn with the GFX primitives against the same frame
+  from the sprite cache, and checks both produce the same pixels.
+*/
+void benchmarkEyeSprites() {
+  const uint16_t runs = 100;
+  static uint8_t reference[DISPLAY_BUFFER_SIZE];
+  bool enabled = eyeSpritesEnabled;
+  uint32_t frameUs[2];
+
+  for (uint8_t cached = 0; cached < 2; cached++) {
+    eyeSpritesEnabled = cached;
+    uint32_t start = micros();
+    for (uint16_t i = 0; i < runs; i++) {
+      display.clearDisplay();
+      drawBenchEyes();
+    }
+    frameUs[cached] = (micros() - start) / runs;
+
+    if (!cached) {
+      memcpy(reference, display.getBuffer(), sizeof(reference));
+    }
+  }
+  bool identical = memcmp(reference, display.getBuffer(), sizeof(reference)) == 0;
+
+  LOG_INFO(BENCH, "eye frame with primitives: %u us", frameUs[0]);
+  LOG_INFO(BENCH, "eye frame from sprites: %u us (%s)", frameUs[1], identical ? "identical" : "PIXELS DIFFER");
+
+  eyeSpritesEnabled = enabled;
+  display.clearDisplay();
+}
+#endif
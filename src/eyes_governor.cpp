@@ -0,0 +1,230 @@
+#include <eyes_governor.h>
+#include <buffered_display.h>
+#include <eye_sprites.h>
+#include <log.h>
+
+extern BufferedDisplay display;
+#include <FluxGarage_RoboEyes.h>
+extern roboEyes roboEyes;
+
+EyesGovernorStats eyesStats;
+
+// Everything drawEyes() reads or tweens; equal snapshots draw equal frames
+struct EyesState {
+  int16_t values[26];
+  uint16_t flags;
+};
+
+static uint8_t minFps = EYES_FPS_MIN;
+static uint8_t maxFps = EYES_FPS_MAX;
+
+static EyesState lastState;
+static uint8_t identicalFrames = 0;
+static bool paused = false;
+static uint32_t pausedSince = 0;
+static uint32_t lastFrameMs = 0;
+static bool lastFrameContinuous = false;  // previous frame was not the first after a pause
+
+// Current window
+static uint32_t windowStart = 0;
+static uint32_t windowFrames = 0;
+static uint32_t windowDropped = 0;
+static uint32_t windowPasses = 0;
+static uint32_t windowOtherUs = 0;  // loop() time outside the eyes
+static uint32_t lastPassUs = 0;
+
+static void captureState(EyesState& state) {
+  int16_t* v = state.values;
+  *v++ = roboEyes.eyeLwidthCurrent;
+  *v++ = roboEyes.eyeLwidthNext;
+  *v++ = roboEyes.eyeLheightCurrent;
+  *v++ = roboEyes.eyeLheightNext;
+  *v++ = roboEyes.eyeLborderRadiusCurrent;
+  *v++ = roboEyes.eyeLborderRadiusNext;
+  *v++ = roboEyes.eyeLx;
+  *v++ = roboEyes.eyeLxNext;
+  *v++ = roboEyes.eyeLy;
+  *v++ = roboEyes.eyeLyNext;
+  *v++ = roboEyes.eyeRwidthCurrent;
+  *v++ = roboEyes.eyeRwidthNext;
+  *v++ = roboEyes.eyeRheightCurrent;
+  *v++ = roboEyes.eyeRheightNext;
+  *v++ = roboEyes.eyeRborderRadiusCurrent;
+  *v++ = roboEyes.eyeRborderRadiusNext;
+  *v++ = roboEyes.eyeRx;
+  *v++ = roboEyes.eyeRxNext;
+  *v++ = roboEyes.eyeRy;
+  *v++ = roboEyes.eyeRyNext;
+  *v++ = roboEyes.eyelidsTiredHeight;
+  *v++ = roboEyes.eyelidsTiredHeightNext;
+  *v++ = roboEyes.eyelidsAngryHeight;
+  *v++ = roboEyes.eyelidsAngryHeightNext;
+  *v++ = roboEyes.eyelidsHappyBottomOffset;
+  *v++ = roboEyes.eyelidsHappyBottomOffsetNext;
+
+  state.flags = roboEyes.tired | roboEyes.angry << 1 | roboEyes.happy << 2 |
+                roboEyes.eyeL_open << 3 | roboEyes.eyeR_open << 4 | roboEyes.curious << 5;
+}
+
+static bool sameState(const EyesState& a, const EyesState& b) {
+  return memcmp(&a, &b, sizeof(EyesState)) == 0;
+}
+
+// Animations that change the picture on their own clock, without touching the state above
+static bool isAnimating() {
+  return roboEyes.hFlicker || roboEyes.vFlicker || roboEyes.confused || roboEyes.laugh;
+}
+
+// The governor stays on millis(), the clock RoboEyes keeps its timers on; see trace.h
+static bool timerDue() {
+  uint32_t now = millis();
+  return (roboEyes.autoblinker && now >= roboEyes.blinktimer) ||
+         (roboEyes.idle && now >= roboEyes.idleAnimationTimer);
+}
+
+static void resetWindow(uint32_t now) {
+  windowStart = now;
+  windowFrames = 0;
+  windowDropped = 0;
+  windowPasses = 0;
+  windowOtherUs = 0;
+}
+
+static void setTarget(uint8_t fps) {
+  fps = constrain(fps, minFps, roboEyes.tired ? min(maxFps, (uint8_t)EYES_FPS_TIRED) : maxFps);
+  if (fps != eyesStats.targetFps) {
+    eyesStats.targetFps = fps;
+    roboEyes.setFramerate(fps);
+    LOG_DEBUG(DISPLAY, "Eyes target %u fps, headroom %u%%", fps, eyesStats.headroomPercent);
+  }
+}
+
+/*
+  Closes a governor window: works out the headroom the frames left and
+  moves the target fps, AIMD style, so a burst of socket or flash work
+  backs the eyes off quickly and they creep back up afterwards.
+*/
+static void closeWindow(uint32_t now) {
+  uint32_t elapsed = now - windowStart;
+  uint32_t intervalUs = 1000000UL / eyesStats.targetFps;
+
+  uint32_t otherPerPassUs = windowPasses ? windowOtherUs / windowPasses : 0;
+  uint32_t usedUs = eyesStats.avgFrameUs + otherPerPassUs;
+  eyesStats.headroomPercent = usedUs >= intervalUs ? 0 : 100 - usedUs * 100 / intervalUs;
+
+  // Frames an ungoverned 'maxFps' loop would have drawn, minus the ones we drew
+  uint32_t ungoverned = elapsed * maxFps / 1000;
+  if (ungoverned > windowFrames) {
+    eyesStats.cpuSavedMs += (ungoverned - windowFrames) * eyesStats.avgFrameUs / 1000;
+  }
+
+  if (!paused) {
+    if (windowDropped > 0 || eyesStats.headroomPercent < EYES_HEADROOM_LOW_PERCENT) {
+      setTarget(eyesStats.targetFps * 3 / 4);
+    } else if (eyesStats.headroomPercent > EYES_HEADROOM_HIGH_PERCENT) {
+      setTarget(eyesStats.targetFps + EYES_FPS_STEP);
+    } else {
+      setTarget(eyesStats.targetFps);  // re-applies the cap when the mood changed
+    }
+  }
+
+  resetWindow(now);
+}
+
+/*
+  Sets the fps bounds and starts at the top of them.
+  Call once in setup(), after roboEyes.begin().
+*/
+void beginEyesGovernor(uint8_t minimum, uint8_t maximum) {
+  minFps = max<uint8_t>(minimum, 1);
+  maxFps = max(maximum, minFps);
+  eyesStats.targetFps = 0;
+  setTarget(maxFps);
+  resetWindow(millis());
+  lastPassUs = micros();
+}
+
+/*
+  Draws the next eye frame when one is due. Call from loop() once per pass
+  while the eyes are on screen, instead of roboEyes.update().
+*/
+void eyesGovernorUpdate() {
+  uint32_t startUs = micros();
+  uint32_t now = millis();
+  if (startUs - lastPassUs > EYES_GOVERNOR_WINDOW_MS * 1000UL) {
+    resetWindow(now);  // the eyes were off screen, that time says nothing about headroom
+  } else {
+    windowOtherUs += startUs - lastPassUs;
+  }
+  windowPasses++;
+
+  if (paused) {
+    EyesState state;
+    captureState(state);
+    if (timerDue() || isAnimating() || !sameState(state, lastState)) {
+      paused = false;
+      identicalFrames = 0;
+      lastFrameContinuous = false;
+      eyesStats.framesPaused += (now - pausedSince) / roboEyes.frameInterval;
+    }
+  }
+
+  if (!paused) {
+    unsigned long previousFrame = roboEyes.fpsTimer;
+    roboEyes.update();
+
+    if (roboEyes.fpsTimer != previousFrame) {
+      uint32_t frameUs = micros() - startUs;
+      eyesStats.avgFrameUs = eyesStats.framesDrawn ? (eyesStats.avgFrameUs * 7 + frameUs) / 8 : frameUs;
+      eyesStats.framesDrawn++;
+      windowFrames++;
+
+      // A gap of two or more intervals between continuous frames means slots were missed
+      uint32_t gap = now - lastFrameMs;
+      if (lastFrameContinuous && gap >= 2U * roboEyes.frameInterval) {
+        uint32_t missed = gap / roboEyes.frameInterval - 1;
+        eyesStats.framesDropped += missed;
+        windowDropped += missed;
+      }
+      lastFrameMs = now;
+      lastFrameContinuous = true;
+
+      EyesState state;
+      captureState(state);
+      identicalFrames = sameState(state, lastState) && !isAnimating() ? identicalFrames + 1 : 0;
+      lastState = state;
+      if (identicalFrames >= 2) {
+        paused = true;
+        pausedSince = now;
+      }
+    }
+  }
+
+  if (now - windowStart >= EYES_GOVERNOR_WINDOW_MS) {
+    closeWindow(now);
+  }
+
+  lastPassUs = micros();
+}
+
+/*
+  Forces the next frame to be drawn, for when something other than the
+  eyes drew over them, e.g. returning to MODE_ROBOT_EYES from another mode.
+*/
+void wakeEyes() {
+  paused = false;
+  identicalFrames = 0;
+  lastFrameContinuous = false;
+  roboEyes.fpsTimer = millis() - roboEyes.frameInterval;
+}
+
+void printEyesReport() {
+  LOG_INFO(DISPLAY, "Eyes: %u fps (%u-%u), frame %u us, headroom %u%%%s",
+           eyesStats.targetFps, minFps, maxFps, eyesStats.avgFrameUs, eyesStats.headroomPercent,
+           paused ? ", paused" : "");
+  LOG_INFO(DISPLAY, "  drawn %u, paused %u, dropped %u, CPU saved %u ms",
+           eyesStats.framesDrawn, eyesStats.framesPaused, eyesStats.framesDropped, eyesStats.cpuSavedMs);
+  LOG_INFO(DISPLAY, "  sprites: %u hits, %u misses, %u evictions, %u fallbacks, %u/%u slots",
+           eyeSpriteStats.hits, eyeSpriteStats.misses, eyeSpriteStats.evictions,
+           eyeSpriteStats.fallbacks, eyeSpriteStats.slotsUsed, EYE_SPRITE_SLOTS);
+}
@@ -0,0 +1,250 @@
+#include <glyph_atlas.h>
+#include <binary_protocol.h>
+#include <buffered_display.h>
+#include <page_blit.h>
+#include <LittleFS.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define GLYPH_ATLAS_MAGIC 0x31594C47UL  // "GLY1"
+#define GLYPH_HEADER_SIZE 8
+#define GLYPH_INDEX_ENTRY_SIZE 8
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+extern BufferedDisplay display;
+
+// A cached lookup; bits are page-major like the atlas, byte (page * width + column)
+struct Glyph {
+  uint32_t codepoint;
+  uint32_t lastUsed;  // 0 marks a free slot
+  uint8_t width;
+  int8_t xOffset;
+  uint8_t advance;
+  bool found;         // false: the atlas lacks it, a box is drawn instead
+  uint8_t bits[GLYPH_MAX_BYTES] __attribute__((aligned(4)));
+};
+
+GlyphCacheStats glyphCacheStats;
+
+static Glyph glyphs[GLYPH_CACHE_SLOTS];
+static uint32_t useCounter = 0;
+
+static File atlas;
+static uint16_t glyphCount = 0;
+static uint8_t cellHeight = 0;
+
+/*
+  Opens the atlas and checks its header. Call in setup() once LittleFS is
+  mounted, and again when the atlas is replaced; without an atlas every
+  message is drawn with the built-in font.
+*/
+bool beginGlyphAtlas() {
+  StallSpan span(SPAN_FS);
+  if (atlas) {
+    atlas.close();
+  }
+  memset(glyphs, 0, sizeof(glyphs));  // cached lookups belong to the old atlas
+  glyphCount = 0;
+  atlas = LittleFS.open(GLYPH_ATLAS_PATH, "r");
+  if (!atlas) {
+    LOG_WARN(GLYPH, "No %s, only ASCII text can be shown", GLYPH_ATLAS_PATH);
+    return false;
+  }
+
+  uint8_t header[GLYPH_HEADER_SIZE];
+  if (atlas.read(header, sizeof(header)) != sizeof(header) || readLe32(header) != GLYPH_ATLAS_MAGIC ||
+      header[6] == 0 || header[6] > GLYPH_MAX_H) {
+    LOG_ERROR(GLYPH, "%s is not a glyph atlas", GLYPH_ATLAS_PATH);
+    atlas.close();
+    return false;
+  }
+  glyphCount = readLe16(header + 4);
+  cellHeight = header[6];
+  LOG_INFO(GLYPH, "Atlas with %u glyphs, %u px high", glyphCount, cellHeight);
+  return true;
+}
+
+// Binary search of the atlas index; false if the codepoint is not in it
+static bool readGlyph(uint32_t codepoint, Glyph& glyph) {
+  StallSpan span(SPAN_FS);
+  uint8_t entry[GLYPH_INDEX_ENTRY_SIZE];
+  uint32_t low = 0;
+  uint32_t high = glyphCount;
+  while (low < high) {
+    uint32_t middle = (low + high) / 2;
+    if (!atlas.seek(GLYPH_HEADER_SIZE + middle * GLYPH_INDEX_ENTRY_SIZE) ||
+        atlas.read(entry, sizeof(entry)) != sizeof(entry)) {
+      return false;
+    }
+
+    uint32_t entryCodepoint = readLe32(entry);
+    if (entryCodepoint < codepoint) {
+      low = middle + 1;
+    } else if (entryCodepoint > codepoint) {
+      high = middle;
+    } else {
+      uint8_t metrics[3];
+      if (!atlas.seek(readLe32(entry + 4)) || atlas.read(metrics, sizeof(metrics)) != sizeof(metrics) ||
+          metrics[0] > GLYPH_MAX_W) {
+        return false;
+      }
+      glyph.width = metrics[0];
+      glyph.xOffset = (int8_t)metrics[1];
+      glyph.advance = metrics[2];
+      size_t size = glyph.width * ((cellHeight + 7) / 8);
+      return atlas.read(glyph.bits, size) == (int)size;
+    }
+  }
+  return false;
+}
+
+/*
+  Returns the cached glyph for codepoint, reading it from the atlas into
+  the least recently used slot on a miss. Codepoints the atlas lacks are
+  cached too, so a missing emoji costs one search, not one per redraw.
+*/
+static const Glyph& findGlyph(uint32_t codepoint) {
+  useCounter++;
+  Glyph* victim = &glyphs[0];
+  for (uint8_t i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+    Glyph& glyph = glyphs[i];
+    if (glyph.lastUsed != 0 && glyph.codepoint == codepoint) {
+      glyph.lastUsed = useCounter;
+      glyphCacheStats.hits++;
+      return glyph;
+    }
+    if (victim->lastUsed != 0 && (glyph.lastUsed == 0 || glyph.lastUsed < victim->lastUsed)) {
+      victim = &glyph;
+    }
+  }
+
+  if (victim->lastUsed != 0) {
+    glyphCacheStats.evictions++;
+  }
+  glyphCacheStats.misses++;
+
+  uint32_t start = micros();
+  victim->codepoint = codepoint;
+  victim->lastUsed = useCounter;
+  victim->found = readGlyph(codepoint, *victim);
+  if (!victim->found) {
+    glyphCacheStats.missing++;
+    victim->width = 0;
+    victim->xOffset = 0;
+    victim->advance = cellHeight / 2;
+  }
+  glyphCacheStats.maxMissUs = max<uint32_t>(glyphCacheStats.maxMissUs, micros() - start);
+  return *victim;
+}
+
+// Decodes the codepoint at text and steps past it; malformed bytes decode to U+FFFD one at a time
+static uint32_t nextCodepoint(const char*& text) {
+  static const uint32_t shortest[] = { 0, 0, 0x80, 0x800, 0x10000 };
+  const uint8_t* bytes = (const uint8_t*)text;
+  uint8_t lead = bytes[0];
+  uint8_t length;
+  uint32_t codepoint;
+
+  if (lead < 0x80) {
+    text++;
+    return lead;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    codepoint = lead & 0x1F;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    codepoint = lead & 0x0F;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    codepoint = lead & 0x07;
+  } else {
+    text++;
+    return REPLACEMENT_CHARACTER;
+  }
+
+  for (uint8_t i = 1; i < length; i++) {
+    if ((bytes[i] & 0xC0) != 0x80) {  // also stops at the terminator
+      text++;
+      return REPLACEMENT_CHARACTER;
+    }
+    codepoint = codepoint << 6 | (bytes[i] & 0x3F);
+  }
+  text += length;
+
+  // Overlong forms, surrogates and values past Unicode
+  if (codepoint < shortest[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+    return REPLACEMENT_CHARACTER;
+  }
+  return codepoint;
+}
+
+// True if text has anything beyond ASCII, which the built-in font cannot show
+bool needsGlyphAtlas(const char* text) {
+  if (!text) {
+    return false;
+  }
+  for (; *text; text++) {
+    if ((uint8_t)*text >= 0x80) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+  Draws UTF-8 text from the atlas with its top left corner at x, y,
+  wrapping at the screen edge like the built-in font does. Returns false
+  if there is no atlas to draw from.
+*/
+bool drawUtf8Text(const char* text, int16_t x, int16_t y) {
+  if (!atlas || !text) {
+    return false;
+  }
+
+  uint8_t* buffer = display.getBuffer();
+  while (*text && y < SCREEN_HEIGHT) {
+    uint32_t codepoint = nextCodepoint(text);
+    if (codepoint == '\r') {
+      continue;
+    }
+    if (codepoint == '\n') {
+      x = 0;
+      y += cellHeight;
+      continue;
+    }
+
+    const Glyph& glyph = findGlyph(codepoint);
+    if (glyph.advance > 0 && x + glyph.advance > SCREEN_WIDTH) {
+      x = 0;
+      y += cellHeight;
+      if (y >= SCREEN_HEIGHT) {
+        break;
+      }
+    }
+    if (glyph.found) {
+      blitPages(buffer, glyph.bits, glyph.width, cellHeight, x + glyph.xOffset, y, BLIT_OR);
+    } else if (glyph.advance > 2) {
+      display.drawRect(x + 1, y + 1, glyph.advance - 2, cellHeight - 2, SSD1306_WHITE);
+    }
+    x += glyph.advance;
+  }
+  return true;
+}
+
+void printGlyphReport() {
+  if (!atlas) {
+    LOG_INFO(GLYPH, "No glyph atlas loaded");
+    return;
+  }
+
+  uint8_t slotsUsed = 0;
+  for (uint8_t i = 0; i < GLYPH_CACHE_SLOTS; i++) {
+    slotsUsed += glyphs[i].lastUsed != 0;
+  }
+  uint32_t lookups = glyphCacheStats.hits + glyphCacheStats.misses;
+  LOG_INFO(GLYPH, "Atlas: %u glyphs, cache: %u/%u slots, %u lookups, %u%% hits",
+           glyphCount, slotsUsed, GLYPH_CACHE_SLOTS, lookups,
+           lookups ? (unsigned)(100ULL * glyphCacheStats.hits / lookups) : 0);
+  LOG_INFO(GLYPH, "  %u misses (%u not in the atlas), %u evictions, slowest miss %u us",
+           glyphCacheStats.misses, glyphCacheStats.missing, glyphCacheStats.evictions, glyphCacheStats.maxMissUs);
+}
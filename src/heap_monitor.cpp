@@ -0,0 +1,171 @@
+#include <heap_monitor.h>
+#include <trace.h>
+#include <log.h>
+
+// Low watermark of the free heap, kept by umm_malloc when UMM_STATS is enabled
+// (the default in the ESP8266 core)
+extern "C" size_t umm_free_heap_size_min(void);
+extern "C" size_t umm_free_heap_size_min_reset(void);
+
+static const char* const heapTagNames[HEAP_TAG_COUNT] = { "WS", "JSON", "DISPLAY", "FS" };
+
+HeapTagStats heapTagStats[HEAP_TAG_COUNT];
+
+static HeapSample history[HEAP_HISTORY_SIZE];
+static uint8_t historyHead = 0;
+static uint8_t historyCount = 0;
+static unsigned long lastSample = 0;
+static uint32_t minFreeSeen = UINT32_MAX;
+static HeapWarning warning = HEAP_OK;
+
+struct ScopeFrame {
+  HeapTag tag;
+  uint32_t freeAtEntry;
+  uint32_t minFree;
+};
+static ScopeFrame scopeStack[HEAP_SCOPE_MAX_DEPTH];
+static uint8_t scopeDepth = 0;
+static uint8_t scopeOverflow = 0;
+
+HeapScope::HeapScope(HeapTag tag) {
+  if (scopeDepth >= HEAP_SCOPE_MAX_DEPTH) {
+    scopeOverflow++;
+    return;
+  }
+
+  uint32_t freeNow = ESP.getFreeHeap();
+  if (scopeDepth > 0) {
+    // Keep the parent's low watermark before restarting it for this scope
+    ScopeFrame& parent = scopeStack[scopeDepth - 1];
+    parent.minFree = min<uint32_t>(parent.minFree, umm_free_heap_size_min());
+  }
+  umm_free_heap_size_min_reset();
+
+  scopeStack[scopeDepth++] = { tag, freeNow, freeNow };
+}
+
+HeapScope::~HeapScope() {
+  if (scopeOverflow > 0) {
+    scopeOverflow--;
+    return;
+  }
+
+  ScopeFrame& frame = scopeStack[--scopeDepth];
+  uint32_t freeNow = ESP.getFreeHeap();
+  frame.minFree = min<uint32_t>(frame.minFree, umm_free_heap_size_min());
+
+  HeapTagStats& tagStats = heapTagStats[frame.tag];
+  tagStats.scopes++;
+  tagStats.retainedBytes += (int32_t)frame.freeAtEntry - (int32_t)freeNow;
+  if (frame.freeAtEntry > frame.minFree && frame.freeAtEntry - frame.minFree > tagStats.peakBytes) {
+    tagStats.peakBytes = frame.freeAtEntry - frame.minFree;
+  }
+
+  if (scopeDepth > 0) {
+    ScopeFrame& parent = scopeStack[scopeDepth - 1];
+    parent.minFree = min(parent.minFree, frame.minFree);
+  }
+  umm_free_heap_size_min_reset();
+}
+
+HeapSample currentHeapSample() {
+  HeapSample sample;
+  uint32_t freeHeap;
+  uint32_t maxBlock;
+  uint8_t fragmentation;
+  ESP.getHeapStats(&freeHeap, &maxBlock, &fragmentation);
+
+  sample.uptimeS = millis() / 1000;
+  sample.freeHeap = freeHeap;
+  sample.maxBlock = maxBlock > 0xFFFF ? 0xFFFF : maxBlock;
+  sample.fragmentation = fragmentation;
+  return sample;
+}
+
+static HeapWarning classify(uint32_t maxBlock) {
+  uint32_t needed = max(HEAP_BLOCK_NEEDED_WS, HEAP_BLOCK_NEEDED_TLS);
+  if (maxBlock < needed) {
+    return HEAP_CRITICAL;
+  }
+  if (maxBlock < needed + needed / 4) {
+    return HEAP_LOW;
+  }
+  return HEAP_OK;
+}
+
+/*
+  Takes a sample every HEAP_SAMPLE_INTERVAL_MS and reports warning level
+  changes. Call from loop().
+*/
+void heapMonitorTick() {
+  unsigned long now = traceMillis();
+  if (historyCount > 0 && now - lastSample < HEAP_SAMPLE_INTERVAL_MS) {
+    return;
+  }
+  lastSample = now;
+
+  HeapSample sample = currentHeapSample();
+  history[historyHead] = sample;
+  historyHead = (historyHead + 1) % HEAP_HISTORY_SIZE;
+  if (historyCount < HEAP_HISTORY_SIZE) {
+    historyCount++;
+  }
+  if (sample.freeHeap < minFreeSeen) {
+    minFreeSeen = sample.freeHeap;
+  }
+
+  HeapWarning level = classify(sample.maxBlock);
+  if (level != warning) {
+    warning = level;
+    if (level == HEAP_OK) {
+      LOG_INFO(HEAP, "Recovered, largest block %u bytes", sample.maxBlock);
+    } else {
+      LOG_WARN(HEAP, "%s: largest block %u bytes (WS needs %u, TLS %u), %u%% fragmented",
+               level == HEAP_CRITICAL ? "CRITICAL" : "Low", sample.maxBlock,
+               HEAP_BLOCK_NEEDED_WS, HEAP_BLOCK_NEEDED_TLS, sample.fragmentation);
+      printHeapReport();
+    }
+  }
+}
+
+HeapWarning heapWarning() {
+  return warning;
+}
+
+uint32_t minFreeHeapSeen() {
+  return minFreeSeen;
+}
+
+// Copies the history, oldest first; returns the number of samples copied
+uint8_t heapHistory(HeapSample* out, uint8_t maxSamples) {
+  uint8_t count = min(historyCount, maxSamples);
+  uint8_t start = (historyHead + HEAP_HISTORY_SIZE - count) % HEAP_HISTORY_SIZE;
+  for (uint8_t i = 0; i < count; i++) {
+    out[i] = history[(start + i) % HEAP_HISTORY_SIZE];
+  }
+  return count;
+}
+
+/*
+  Logs the current heap state, the trend over the history and the
+  per-subsystem attribution.
+*/
+void printHeapReport() {
+  HeapSample now = currentHeapSample();
+  LOG_INFO(HEAP, "free %u, largest block %u, fragmentation %u%%, min free %u",
+           now.freeHeap, now.maxBlock, now.fragmentation, minFreeSeen);
+
+  if (historyCount > 0) {
+    const HeapSample& oldest = history[(historyHead + HEAP_HISTORY_SIZE - historyCount) % HEAP_HISTORY_SIZE];
+    LOG_INFO(HEAP, "over %u s: free %d, largest block %d, fragmentation %d%%",
+             now.uptimeS - oldest.uptimeS,
+             (int)now.freeHeap - (int)oldest.freeHeap,
+             (int)now.maxBlock - (int)oldest.maxBlock,
+             (int)now.fragmentation - (int)oldest.fragmentation);
+  }
+
+  for (uint8_t i = 0; i < HEAP_TAG_COUNT; i++) {
+    LOG_INFO(HEAP, "%-8s scopes %u, retained %d, peak %u", heapTagNames[i],
+             heapTagStats[i].scopes, heapTagStats[i].retainedBytes, heapTagStats[i].peakBytes);
+  }
+}
@@ -0,0 +1,80 @@
+#include <image_message.h>
+#include <buffered_display.h>
+#include <LittleFS.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+/*
+  Fills a DISPLAY_BUFFER_SIZE image from a message payload, either raw or
+  PackBits compressed (a control byte n: 0..127 copies the next n + 1
+  bytes, -127..-1 repeats the next byte 1 - n times, -128 is skipped).
+  Returns false if the payload does not decode to exactly one frame.
+*/
+bool unpackImage(const uint8_t* data, size_t length, bool packed, uint8_t* image) {
+  if (!packed) {
+    if (length != DISPLAY_BUFFER_SIZE) {
+      return false;
+    }
+    memcpy(image, data, DISPLAY_BUFFER_SIZE);
+    return true;
+  }
+
+  size_t in = 0;
+  size_t out = 0;
+  while (in < length && out < DISPLAY_BUFFER_SIZE) {
+    int8_t control = (int8_t)data[in++];
+    if (control >= 0) {
+      size_t count = control + 1;
+      if (in + count > length || out + count > DISPLAY_BUFFER_SIZE) {
+        return false;
+      }
+      memcpy(image + out, data + in, count);
+      in += count;
+      out += count;
+    } else if (control != -128) {
+      size_t count = 1 - control;
+      if (in >= length || out + count > DISPLAY_BUFFER_SIZE) {
+        return false;
+      }
+      memset(image + out, data[in++], count);
+      out += count;
+    }
+  }
+  return out == DISPLAY_BUFFER_SIZE && in == length;
+}
+
+bool saveImageMessage(const uint8_t* image) {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(IMAGE_MESSAGE_PATH, "w");
+  if (!file) {
+    LOG_ERROR(FS, "Failed to open %s for writing", IMAGE_MESSAGE_PATH);
+    return false;
+  }
+  size_t written = file.write(image, DISPLAY_BUFFER_SIZE);
+  file.close();
+  if (written != DISPLAY_BUFFER_SIZE) {
+    LittleFS.remove(IMAGE_MESSAGE_PATH);  // loadImageMessage() would reject it anyway
+    return false;
+  }
+  return true;
+}
+
+/*
+  Reads the saved image into the given buffer, normally the display's.
+  Returns false if there is none (the buffer is then left untouched).
+*/
+bool loadImageMessage(uint8_t* image) {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(IMAGE_MESSAGE_PATH, "r");
+  if (!file) {
+    return false;
+  }
+  if (file.size() != DISPLAY_BUFFER_SIZE) {
+    file.close();
+    LOG_ERROR(FS, "%s has the wrong size", IMAGE_MESSAGE_PATH);
+    return false;
+  }
+  size_t read = file.read(image, DISPLAY_BUFFER_SIZE);
+  file.close();
+  return read == DISPLAY_BUFFER_SIZE;
+}
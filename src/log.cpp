@@ -0,0 +1,221 @@
+#include <log.h>
+#include <rtc_layout.h>
+
+#define RTC_LOG_MAGIC 0x4C4F4731UL  // "LOG1"
+#define RTC_LOG_DATA_BYTES ((RTC_LOG_WORDS - 2) * 4)
+
+struct RtcLogRing {
+  uint32_t magic;
+  uint16_t head;
+  uint16_t used;
+  char data[RTC_LOG_DATA_BYTES];
+};
+
+// RAM mirror of the RTC ring; only the words an append touched are written back
+static RtcLogRing rtcRing;
+static char recovered[RTC_LOG_DATA_BYTES];
+static uint16_t recoveredLength = 0;
+static uint32_t rtcWritten = 0;  // bytes appended to the RTC ring since boot
+
+static char ring[LOG_RING_SIZE];
+static uint16_t ringHead = 0;  // next byte to write
+static uint16_t ringTail = 0;  // next byte to drain
+static uint16_t ringUsed = 0;
+static uint32_t droppedLines = 0;
+
+static const char levelLetters[] = { '-', 'E', 'W', 'I', 'D' };
+
+static void rtcWriteWords(uint16_t firstWord, uint16_t lastWord) {
+  ESP.rtcUserMemoryWrite(RTC_LOG_OFFSET + 2 + firstWord,
+                         (uint32_t*)&rtcRing.data[firstWord * 4], (lastWord - firstWord + 1) * 4);
+}
+
+static void rtcAppend(const char* text, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  if (length > RTC_LOG_DATA_BYTES) {
+    text += length - RTC_LOG_DATA_BYTES;
+    length = RTC_LOG_DATA_BYTES;
+  }
+
+  uint16_t start = rtcRing.head;
+  for (size_t i = 0; i < length; i++) {
+    rtcRing.data[rtcRing.head] = text[i];
+    rtcRing.head = (rtcRing.head + 1) % RTC_LOG_DATA_BYTES;
+  }
+  rtcRing.used = min<uint16_t>(rtcRing.used + length, RTC_LOG_DATA_BYTES);
+  rtcWritten += length;
+
+  if (start + length <= RTC_LOG_DATA_BYTES) {
+    rtcWriteWords(start / 4, (start + length - 1) / 4);
+  } else {
+    rtcWriteWords(start / 4, RTC_LOG_DATA_BYTES / 4 - 1);
+    rtcWriteWords(0, (start + length - RTC_LOG_DATA_BYTES - 1) / 4);
+  }
+  ESP.rtcUserMemoryWrite(RTC_LOG_OFFSET, (uint32_t*)&rtcRing, 8);
+}
+
+static void ringAppend(const char* text, size_t length) {
+  if (length > LOG_RING_SIZE) {
+    return;
+  }
+
+  // Make room by dropping whole lines from the old end
+  while ((size_t)(LOG_RING_SIZE - ringUsed) < length) {
+    char c;
+    do {
+      c = ring[ringTail];
+      ringTail = (ringTail + 1) % LOG_RING_SIZE;
+      ringUsed--;
+    } while (c != '\n' && ringUsed > 0);
+    droppedLines++;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    ring[ringHead] = text[i];
+    ringHead = (ringHead + 1) % LOG_RING_SIZE;
+  }
+  ringUsed += length;
+}
+
+/*
+  Recovers the crash log the previous boot left in RTC memory and starts a
+  new one. Call first thing in setup(), right after Serial.begin().
+*/
+void logBegin() {
+  ESP.rtcUserMemoryRead(RTC_LOG_OFFSET, (uint32_t*)&rtcRing, sizeof(rtcRing));
+
+  if (rtcRing.magic == RTC_LOG_MAGIC && rtcRing.used <= RTC_LOG_DATA_BYTES && rtcRing.head < RTC_LOG_DATA_BYTES) {
+    uint16_t start = (rtcRing.head + RTC_LOG_DATA_BYTES - rtcRing.used) % RTC_LOG_DATA_BYTES;
+    uint16_t skip = 0;
+    if (rtcRing.used == RTC_LOG_DATA_BYTES) {
+      // The ring wrapped, so its oldest line is cut off; start at the next one
+      while (skip < rtcRing.used && rtcRing.data[(start + skip) % RTC_LOG_DATA_BYTES] != '\n') {
+        skip++;
+      }
+      skip++;
+    }
+    for (uint16_t i = skip; i < rtcRing.used; i++) {
+      recovered[recoveredLength++] = rtcRing.data[(start + i) % RTC_LOG_DATA_BYTES];
+    }
+  }
+
+  rtcRing.magic = RTC_LOG_MAGIC;
+  rtcRing.head = 0;
+  rtcRing.used = 0;
+  rtcWritten = 0;
+  ESP.rtcUserMemoryWrite(RTC_LOG_OFFSET, (uint32_t*)&rtcRing, 8);
+
+  if (recoveredLength > 0) {
+    printRecoveredLog();
+  }
+}
+
+/*
+  Formats one line ("<millis> <level> [<tag>] <message>") into the RAM ring
+  and the RTC crash ring. Use the LOG_* macros rather than calling this.
+*/
+void logWrite(uint8_t level, const char* tag, PGM_P fmt, ...) {
+  char line[LOG_LINE_MAX];
+  int length = snprintf(line, sizeof(line), "%lu %c [%s] ", millis(), levelLetters[level], tag);
+
+  va_list args;
+  va_start(args, fmt);
+  length += vsnprintf_P(line + length, sizeof(line) - length - 1, fmt, args);
+  va_end(args);
+
+  if (length > (int)sizeof(line) - 2) {
+    length = sizeof(line) - 2;  // truncated, keep room for the newline
+  }
+  line[length++] = '\n';
+
+  ringAppend(line, length);
+  rtcAppend(line, length);
+}
+
+/*
+  Writes as much of the ring to Serial as fits without blocking.
+  Call from idle time, once per loop() pass.
+*/
+void logDrain() {
+  if (ringUsed == 0 && droppedLines > 0) {
+    uint32_t dropped = droppedLines;
+    droppedLines = 0;
+    LOG_WARN(LOG, "%u lines dropped", dropped);
+  }
+
+  int space = Serial.availableForWrite();
+  while (space > 0 && ringUsed > 0) {
+    uint16_t contiguous = ringTail < ringHead ? ringHead - ringTail : LOG_RING_SIZE - ringTail;
+    uint16_t chunk = min<uint16_t>(contiguous, space);
+    chunk = min(chunk, ringUsed);
+    Serial.write((const uint8_t*)&ring[ringTail], chunk);
+    ringTail = (ringTail + chunk) % LOG_RING_SIZE;
+    ringUsed -= chunk;
+    space -= chunk;
+  }
+}
+
+// Blocks until everything logged so far is on the wire; for halts and restarts
+void logFlush() {
+  while (ringUsed > 0) {
+    logDrain();
+    yield();
+  }
+  Serial.flush();
+}
+
+// Queues the lines recovered from the previous boot's RTC ring for printing
+void printRecoveredLog() {
+  if (recoveredLength == 0) {
+    LOG_INFO(LOG, "No log recovered from the previous boot");
+    return;
+  }
+
+  LOG_INFO(LOG, "Last %u bytes logged before the previous reset:", recoveredLength);
+  ringAppend(recovered, recoveredLength);
+  if (recovered[recoveredLength - 1] != '\n') {
+    ringAppend("\n", 1);
+  }
+  LOG_INFO(LOG, "End of recovered log");
+}
+
+/*
+  Copies one line of the kept log into line, without its newline: the
+  lines recovered from the previous boot, or this boot's RTC ring. Start
+  with position 0; it is moved past the line. Returns false after the
+  last line. Lines the ring overwrote since the previous call are skipped.
+*/
+bool readKeptLogLine(bool previousBoot, uint32_t& position, char* line, size_t size) {
+  const char* data = previousBoot ? recovered : rtcRing.data;  // ring byte n is at n % RTC_LOG_DATA_BYTES
+  uint32_t end = previousBoot ? recoveredLength : rtcWritten;
+  uint32_t oldest = previousBoot ? 0 : rtcWritten - rtcRing.used;
+
+  if (position < oldest) {
+    // Overwritten, resume at the first whole line still in the ring
+    position = oldest;
+    if (oldest > 0) {
+      while (position < end && data[position % RTC_LOG_DATA_BYTES] != '\n') {
+        position++;
+      }
+      position++;
+    }
+  }
+  if (position >= end) {
+    return false;
+  }
+
+  size_t length = 0;
+  while (position < end) {
+    char c = data[position++ % RTC_LOG_DATA_BYTES];
+    if (c == '\n') {
+      break;
+    }
+    if (length + 1 < size) {
+      line[length++] = c;
+    }
+  }
+  line[length] = '\0';
+  return true;
+}
@@ -7,31 +7,48 @@
 #include <ESP8266WiFi.h>
 #include <ESPAsyncWebServer.h>
 #include <WebSocketsClient.h>
-#include <message_animaiton_frames.h>
+#include <animation.h>
+#include <buffered_display.h>
+#include <message_delivery.h>
+#include <protocol_messages.h>
+#include <connection_health.h>
+#include <stats.h>
+#include <stats_history.h>
+#include <screens.h>
+#include <heap_monitor.h>
+#include <alloc_counter.h>
+#include <log.h>
+#include <stall_watchdog.h>
+#include <eyes_governor.h>
+#include <eye_sprites.h>
+#include <binary_protocol.h>
+#include <image_message.h>
+#include <stream_player.h>
+#include <doodle.h>
+#include <glyph_atlas.h>
+#include <schedule.h>
+#include <ota_update.h>
+#include <asset_sync.h>
+#include <data_export.h>
+#include <config.h>
+#include <wifi_profiles.h>
+#include <trace.h>
 #include <time.h>
 
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-#define OLED_RESET -1
-#define SCREEN_ADDRESS 0x3C
-
-#define WIFI_CONNECTION_MAX_ATTEMPTS 150
 #define MODE_BUTTON_PIN 14 // D5 on NodeMCU
 #define TOUCH_PIN 12 // D6 on NodeMCU
 #define MISS_BUTTON_PIN 13  // D7 on NodeMCU
 
-// Display message feature animation settings
-#define LOGO_WIDTH 128
-#define LOGO_HEIGHT 64
-#define MAX_FRAMES 50
+// Eye geometry, also used to pre-render the eye sprites
+#define EYE_SIZE 30
+#define EYE_RADIUS 15
 
-const unsigned long frameDurationMs = 250;  // show each frame for 200ms
-const unsigned char* animationFrames[MAX_FRAMES]; // pointers to bitmaps
-uint8_t totalFrames = 0;  // how many actual frames are loaded
+// Display message feature, the animation itself is defined in animations.cpp
 bool isMessageUnread = false;  // Tracks if new message bitmap should be shown
+uint32_t unreadMessageSeq = 0;  // seq of the unread message, 0 if it had none
 
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+BufferedDisplay display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 #include <FluxGarage_RoboEyes.h>
 roboEyes roboEyes;
 
@@ -42,26 +59,19 @@ enum DisplayMode {
   MODE_ROBOT_EYES,
   MODE_MESSAGE,
   MODE_STATS,
+  MODE_HISTORY,
   MODE_DEBUG
 };
 
-struct Stats {
-  int headpats;
-  int missYouPresses;
-  int moodSwings;
-  int messagesReceived;
-} stats;
-
 DisplayMode currentMode = MODE_ROBOT_EYES;
 bool forceMessageMode = false;
 bool forceDebugMode = false;
 unsigned long lastButtonPress = 0;
-const unsigned long debounceDelay = 500;
 bool isInAPMode = false;
+unsigned long restartRequestedAt = 0;  // set by the /save handler, loop() restarts once the reply is out
 
 // Mood system
 unsigned long lastMoodChange = 0;
-unsigned long moodInterval = 15000; // 15 seconds
 unsigned long happyUntil = 0;
 int currentMood = DEFAULT;
 bool isBeingPetted = false;
@@ -71,9 +81,16 @@ void onWebSocketEvent(WStype_t type, uint8_t * payload, size_t length);
 void connectWebSocket();
 void startAPMode();
 bool connectToWifi();
-int pickBestFontSize(String text);
-void processJson(String jsonStr, bool forceAndSave = true);
-void displayMessageLines(const std::vector<String>& lines, int size = 1, int x = 0, int y = 0);
+int pickBestFontSize(const char* text);
+void processJson(const char* json, size_t length, bool saveAndForce = true);
+void processBinary(const uint8_t* payload, size_t length);
+bool rejectMessage(uint32_t seq);
+void acceptMessage(uint32_t seq);
+void acknowledgeMessage(uint32_t seq);
+void revealMessage(uint32_t seq);
+void revealScheduledMessage();
+void removeOtherMessages(const char* keep);
+void displayMessageLines(std::initializer_list<const char*> lines, int size = 1, int x = 0, int y = 0);
 void loadSavedMessage();
 void updateDisplay();
 void changeMood(int mood);
@@ -82,12 +99,9 @@ void playFullAnimation();
 void handleSecondButtonPress();
 int readMissedPresses();
 void writeMissedPresses(int count);
-void loadStats();
-void saveStats();
-void incrementHeadpats();
-void incrementMissYouPresses();
-void incrementMoodSwings();
-void incrementMessagesReceived();
+void sendDeliveryAck();
+void sendDisplayedReceipt(uint32_t seq);
+void handleSerialCommand(char command);
 
 void setup() {
   pinMode(MODE_BUTTON_PIN, INPUT_PULLUP);
@@ -97,31 +111,56 @@ void setup() {
   Wire.begin(D2, D1);
   Serial.begin(115200);
   while (!Serial) delay(10);
+  logBegin();
+  stallWatchdogBegin();
+  otaBootCheck();
 
   if (!display.begin(SSD1306_SWITCHCAPVCC, SCREEN_ADDRESS)) {
-    Serial.println(F("SSD1306 init failed"));
+    LOG_ERROR(DISPLAY, "SSD1306 init failed");
+    logFlush();
     while (true);
   }
-  roboEyes.begin(SCREEN_WIDTH, SCREEN_HEIGHT, 60);  // 60 fps
-  roboEyes.setWidth(30, 30);
-  roboEyes.setHeight(30, 30);
-  roboEyes.setBorderradius(15, 15);
+#ifdef LOVEBOX_BENCH
+  display.benchmark();
+  benchmarkAnimationDraw();
+#endif
+  roboEyes.begin(SCREEN_WIDTH, SCREEN_HEIGHT, EYES_FPS_MAX);  // the governor lowers it when there is no headroom
+  roboEyes.setWidth(EYE_SIZE, EYE_SIZE);
+  roboEyes.setHeight(EYE_SIZE, EYE_SIZE);
+  roboEyes.setBorderradius(EYE_RADIUS, EYE_RADIUS);
   roboEyes.setAutoblinker(ON, 1, 0.5);               
   roboEyes.setIdleMode(ON, 1.5, 0.5);   
   // roboEyes.setCuriosity(ON);      
   roboEyes.open();
   roboEyes.anim_confused();
+  beginEyesGovernor();
+  prerenderEyeSprites(EYE_SIZE, EYE_SIZE, EYE_RADIUS);
+#ifdef LOVEBOX_BENCH
+  benchmarkEyeSprites();
+#endif
 
   if (!LittleFS.begin()) {
-    Serial.println(F("Failed to mount LittleFS"));
+    LOG_ERROR(FS, "Failed to mount LittleFS");
     return;
   }
+  loadConfig();
   loadStats();
-
+  loadStatsHistory();
+  loadDeliveryState();
+  loadSchedule();
+  beginGlyphAtlas();
+  beginAssetSync();
+  beginDataExport(server);
+
+#ifdef LOVEBOX_REPLAY
+  if (beginTraceReplay()) {
+    return;  // the trace stands in for WiFi, the server and the clock
+  }
+#endif
   if (!connectToWifi()) {
     currentMode = MODE_DEBUG;
     forceDebugMode = false;
-    Serial.println("[SETUP] WiFi failed, entering DEBUG mode");
+    LOG_WARN(SETUP, "WiFi failed, entering DEBUG mode");
 
     roboEyes.open();
     roboEyes.setMood(TIRED);
@@ -130,7 +169,7 @@ void setup() {
     updateDisplay();
     startAPMode();
   } else {
-    Serial.println("[SETUP] WiFi connected, switching to happy face");
+    LOG_INFO(SETUP, "WiFi connected, switching to happy face");
 
     roboEyes.open();
     roboEyes.setMood(HAPPY);
@@ -138,56 +177,110 @@ void setup() {
     roboEyes.setIdleMode(ON, 5, 3);
 
     connectWebSocket();
+    server.begin();  // data export, see data_export.h
 
-    // Set timezone (IST: UTC+5:30)
-    configTime(19800, 0, "pool.ntp.org", "time.nist.gov");
+    configTime(config.utcOffsetSeconds, 0, "pool.ntp.org", "time.nist.gov");
 
-    Serial.print("[TIME] Waiting for NTP time");
+    LOG_INFO(TIME, "Waiting for NTP time");
+    StallSpan span(SPAN_NTP);
     time_t now = time(nullptr);
     while (now < 100000)
     {
       delay(500);
-      Serial.print(".");
+      logDrain();
       now = time(nullptr);
     }
-    Serial.println("\n[TIME] Time synced!");
+    LOG_INFO(TIME, "Time synced!");
   }
 
 }
 
 void loop() {
-  webSocket.loop();
-  if (currentMode == MODE_MESSAGE && digitalRead(TOUCH_PIN) == HIGH) {
+  stallLoopTick();
+  allocCheckTick();
+#ifdef LOVEBOX_REPLAY
+  traceReplayTick([](uint8_t type, uint8_t* payload, size_t length) {
+    onWebSocketEvent((WStype_t)type, payload, length);
+  }, handleSerialCommand);
+#endif
+  traceTick();
+  {
+    StallSpan span(SPAN_DISPLAY);
+    display.pump();
+  }
+  {
+    StallSpan span(SPAN_WS);
+    HeapScope scope(HEAP_TAG_WS);
+    webSocket.loop();
+    if (!isInAPMode && !isTraceReplaying()) {
+      connectionHealthTick();
+    }
+  }
+  heapMonitorTick();
+  if (restartRequestedAt != 0 && millis() - restartRequestedAt > 3000) {
+    LOG_INFO(WIFI, "Restarting with the new WiFi credentials");
+    logFlush();
+    ESP.restart();
+  }
+  if (Serial.available()) {
+    char command = Serial.read();
+    traceSerialCommand(command);
+    handleSerialCommand(command);
+  }
+  if (currentMode == MODE_MESSAGE && traceDigitalRead(TOUCH_PIN) == HIGH) {
     if (isMessageUnread) {
-      Serial.println("[TOUCH] Acknowledged. Playing animation before message.");
+      LOG_INFO(TOUCH, "Acknowledged. Playing animation before message.");
 
       isMessageUnread = false;
+      sendDisplayedReceipt(unreadMessageSeq);
 
-      // Play animation before showing message
+      // Play animation before showing message, the message follows once it finishes
       playFullAnimation();
-    
-      delay(500);  // brief pause before message appears
+    }
+  }
+
+  revealScheduledMessage();
+  statsHistoryTick();
+  assetSyncTick();
+  otaTick();
+  if (!isInAPMode && !isTraceReplaying()) {
+    wifiRoamTick();
+  }
+
+  if (isAnimationPlaying()) {
+    StallSpan span(SPAN_ANIMATION);
+    if (!animationTick()) {
       updateDisplay();  // will now load saved message
-      delay(500);  // debounce
     }
   }
 
-  if (digitalRead(MODE_BUTTON_PIN) == LOW) {
-    unsigned long now = millis();
-    if (now - lastButtonPress > debounceDelay) {
+  if (isDoodlePlaying()) {
+    StallSpan span(SPAN_ANIMATION);
+    doodleTick();
+  }
+
+  if (isStreamPlaying()) {
+    StallSpan span(SPAN_ANIMATION);
+    if (!streamTick()) {
+      updateDisplay();  // hand the screen back to the current mode
+    }
+  }
+
+  if (traceDigitalRead(MODE_BUTTON_PIN) == LOW) {
+    unsigned long now = traceMillis();
+    if (now - lastButtonPress > config.debounceMs) {
       lastButtonPress = now;
 
-      currentMode = static_cast<DisplayMode>((currentMode + 1) % 4);
-      Serial.print("[BUTTON] Switched to mode: ");
-      Serial.println(currentMode);
+      currentMode = static_cast<DisplayMode>((currentMode + 1) % (MODE_DEBUG + 1));
+      LOG_INFO(BUTTON, "Switched to mode: %d", currentMode);
       updateDisplay();
     }
   }
 
   static unsigned long lastMissPress = 0;
-  if (digitalRead(MISS_BUTTON_PIN) == LOW) {
-    unsigned long now = millis();
-    if (now - lastMissPress > debounceDelay) {
+  if (traceDigitalRead(MISS_BUTTON_PIN) == LOW) {
+    unsigned long now = traceMillis();
+    if (now - lastMissPress > config.debounceMs) {
       lastMissPress = now;
       handleSecondButtonPress();
       incrementMissYouPresses();
@@ -199,14 +292,14 @@ void loop() {
     forceMessageMode = false;
 
     if (currentMode != MODE_MESSAGE) {
-      Serial.println("[LOOP] Forcing MODE_MESSAGE");
+      LOG_INFO(LOOP, "Forcing MODE_MESSAGE");
       currentMode = MODE_MESSAGE;
     }
 
     updateDisplay();
   } else if (forceDebugMode) {
       if (currentMode != MODE_DEBUG) {
-        Serial.println("[LOOP] Forcing MODE_DEBUG");
+        LOG_INFO(LOOP, "Forcing MODE_DEBUG");
         currentMode = MODE_DEBUG;
         updateDisplay();
       }
@@ -214,12 +307,12 @@ void loop() {
       forceDebugMode = false;
   }
 
-  if (currentMode == MODE_ROBOT_EYES) {
-    unsigned long now = millis();
+  if (currentMode == MODE_ROBOT_EYES && !isStreamPlaying()) {
+    unsigned long now = traceMillis();
     // Head pat sensor triggers happy mood
-    if (digitalRead(TOUCH_PIN) == HIGH) {
+    if (traceDigitalRead(TOUCH_PIN) == HIGH) {
       if (!isBeingPetted) {
-        Serial.println("[TOUCH] Head pat detected!");
+        LOG_INFO(TOUCH, "Head pat detected!");
         isBeingPetted = true;
         roboEyes.anim_laugh();
         changeMood(HAPPY);
@@ -231,9 +324,9 @@ void loop() {
     }
     // If not being petted and happy timeout expired, change mood randomly
     if (!isBeingPetted && now > happyUntil) {
-      if (WiFi.status() == WL_CONNECTED)  {
+      if (traceWifiStatus() == WL_CONNECTED)  {
         struct tm timeinfo;
-        if (getLocalTime(&timeinfo))  {
+        if (traceLocalTime(&timeinfo))  {
           int hour = timeinfo.tm_hour;
 
           if (hour >= 22 || hour < 6) {
@@ -241,7 +334,7 @@ void loop() {
               changeMood(TIRED);
             }
           }
-          else if (now - lastMoodChange > moodInterval) {
+          else if (now - lastMoodChange > config.moodIntervalMs) {
             int moods[] = {DEFAULT, TIRED, ANGRY};
             int nextMood;
             do {
@@ -256,7 +349,7 @@ void loop() {
       }
       else  {
         // If time not available, fallback to random mood
-        if (now - lastMoodChange > moodInterval)  {
+        if (now - lastMoodChange > config.moodIntervalMs)  {
           int moods[] = {DEFAULT, TIRED, ANGRY};
           int nextMood;
           do  {
@@ -270,19 +363,34 @@ void loop() {
       }
     }
 
-    // Update eyes
-    roboEyes.update();
+    // Update eyes, at whatever rate the governor settled on
+    StallSpan span(SPAN_EYES);
+    eyesGovernorUpdate();
   }
-  // Update stats display every 500ms if in stats mode
+  // Poll the stats counters every 500ms, only changed ones are redrawn
   static unsigned long lastStatsRefresh = 0;
-  if (currentMode == MODE_STATS) {
-    unsigned long now = millis();
+  if (currentMode == MODE_STATS || currentMode == MODE_HISTORY) {
+    unsigned long now = traceMillis();
     if (now - lastStatsRefresh > 500) {
-      updateDisplay();
+      StallSpan span(SPAN_SCREEN);
+      refreshScreen();
       lastStatsRefresh = now;
     }
   }
 
+  // Connection quality on the debug screen changes slowly, once a second is enough
+  static unsigned long lastDebugRefresh = 0;
+  if (currentMode == MODE_DEBUG && !isInAPMode) {
+    unsigned long now = traceMillis();
+    if (now - lastDebugRefresh > 1000) {
+      StallSpan span(SPAN_SCREEN);
+      refreshScreen();
+      lastDebugRefresh = now;
+    }
+  }
+
+  // Idle time: hand queued log lines to the UART without blocking on it
+  logDrain();
 }
 
 /*
@@ -292,31 +400,49 @@ void loop() {
   Incoming messages are expected to be JSON and are parsed by processJson()
 */
 void onWebSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
+  traceWebSocketEvent(type, payload, length);
   switch (type) {
     case WStype_DISCONNECTED:
-      Serial.println("[WS] Disconnected");
+      LOG_INFO(WS, "Disconnected");
+      onConnectionLost();
       break;
 
     case WStype_CONNECTED:
     {
-      Serial.println("[WS] Connected");
-      webSocket.sendTXT("ESP8266 connected");
+      LOG_INFO(WS, "Connected");
+      onConnectionEstablished();
+      confirmFirmware();
+      assetSyncConnected();
+
+      // Tell the server where to resume so it only resends the gap
+      char hello[PROTOCOL_MESSAGE_MAX];
+      formatHelloMessage(hello, sizeof(hello), lastAckedSequence());
+      webSocket.sendTXT(hello);
 
       int missed = readMissedPresses();
       if (missed > 0) {
+        StallSpan span(SPAN_REPLAY);
         for (int i = 0; i < missed; i++) {
-          webSocket.sendTXT("{\"type\": \"miss_you_button\"}");
+          webSocket.sendTXT(MISS_YOU_BUTTON_MESSAGE);
           delay(100); // slight delay to avoid overwhelming server
         }
-        Serial.printf("[WS] Sent %d stored 'miss_you_button' events\n", missed);
+        LOG_INFO(WS, "Sent %d stored 'miss_you_button' events", missed);
         writeMissedPresses(0); // Clear stored count
       }
       break;
     }
     case WStype_TEXT:
-      Serial.printf("[WS] Received: %s\n", payload);
-      incrementMessagesReceived();
-      processJson(String((char*)payload));
+      LOG_DEBUG(WS, "Received: %.*s", (int)min<size_t>(length, 64), (const char*)payload);
+      processJson((const char*)payload, length);
+      break;
+
+    case WStype_BIN:
+      LOG_DEBUG(WS, "Received %u binary bytes", (unsigned)length);
+      processBinary(payload, length);
+      break;
+
+    case WStype_PONG:
+      onHeartbeatPong();
       break;
   }
 }
@@ -325,47 +451,35 @@ void onWebSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
   Initializes WebSocket client connection to the Flask server
   This function connects to the WebSocket server at the specified host and port
   and sets up the event handler for incoming messages.
-  It also sets a reconnection interval to attempt to reconnect if the connection is lost.
+  Reconnection and heartbeats are driven by connection_health, see connectionHealthTick().
 */
 void connectWebSocket() {
-  const char* host = "192.168.198.155";
-  const uint16_t port = 8765;
-
-  webSocket.begin(host, port, "/");
+  webSocket.begin(config.serverHost, config.serverPort, "/");
   webSocket.onEvent(onWebSocketEvent);
-  webSocket.setReconnectInterval(5000);
+  beginConnectionHealth();
 }
 
 /*
   Create Access Point (AP) mode for WiFi setup
   This function sets up an access point with the SSID "ESP-Setup"
   and serves a simple HTML form to input WiFi credentials.
-  When the form is submitted, it saves the credentials to LittleFS in a JSON file
+  When the form is submitted, it saves the credentials to the configuration record
 
   Also displays debug info on the oled screen
 */
 void startAPMode() {
   WiFi.softAP("ESP-Setup");
   IPAddress IP = WiFi.softAPIP();
-  Serial.print("AP IP address: ");
-  Serial.println(IP);
+  LOG_INFO(WIFI, "AP IP address: %u.%u.%u.%u", IP[0], IP[1], IP[2], IP[3]);
   isInAPMode = true;
 
-  String visitLine = "http://" + IP.toString() + "/";
-  displayMessageLines({
-      "WiFi Setup Mode",
-      "Turn on your phone's WiFi and connect to",
-      "ESP-Setup",
-      "",
-      "Visit:",
-      visitLine,
-      "to configure WiFi"
-    }, 1);
+  showScreen(&apScreen);
 
   server.on("/", HTTP_GET, [](AsyncWebServerRequest *request){
     request->send(LittleFS, "/index.html", "text/html");
   });
   server.on("/save", HTTP_POST, [](AsyncWebServerRequest *request){
+    StallSpan span(SPAN_WEB);
     if (!request->hasParam("ssid", true) || !request->hasParam("password", true)) {
       request->send(400, "text/plain", "Missing parameters");
       return;
@@ -374,22 +488,15 @@ void startAPMode() {
     String ssid = request->getParam("ssid", true)->value();
     String password = request->getParam("password", true)->value();
 
-    StaticJsonDocument<256> doc;
-    doc["ssid"] = ssid;
-    doc["password"] = password;
-
-    File file = LittleFS.open("/wifi.json", "w");
-    if (!file) {
+    if (!saveWifiProfile(ssid.c_str(), password.c_str())) {
       request->send(500, "text/plain", "Failed to save WiFi credentials.");
       return;
     }
 
-    serializeJson(doc, file);
-    file.close();
-
+    // The restart happens in loop(): this callback runs in the system context, where delay() and
+    // the yield() in logFlush() are not allowed
     request->send(200, "text/plain", "WiFi credentials saved. Rebooting...");
-    delay(3000);
-    ESP.restart();
+    restartRequestedAt = max(millis(), 1UL);
   });
   server.serveStatic("/", LittleFS, "/"); // Serve files from LittleFS
 
@@ -398,62 +505,52 @@ void startAPMode() {
 
 /*
 
-  Function to connect to WiFi using credentials stored in LittleFS
-  The credentials are stored in a JSON file named "wifi.json" in the LittleFS filesystem
-  
-  requires the file to have the following structure:
-    { "ssid": "your_ssid", 
-      "password": "your_password" 
-    }
+  Function to connect to WiFi using the networks stored in the configuration
+  record (see config.h), added through the setup portal
+  Tries them best first (see wifi_profiles.h), each for WIFI_PROFILE_TIMEOUT_MS
   returns true if connected successfully, false otherwise
 */
 bool connectToWifi() {
-  File file = LittleFS.open("/wifi.json", "r");
-  if (!file) {
-    Serial.println(F("Failed to open wifi.json"));
-    return false;
-  }
-
-  StaticJsonDocument<256> doc;
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
-
-  if (error) {
-    Serial.print(F("JSON Parse Error: "));
-    Serial.println(error.c_str());
+  WifiCandidate candidates[CONFIG_WIFI_PROFILES];
+  uint8_t count = rankWifiCandidates(candidates);
+  if (count == 0) {
+    LOG_ERROR(WIFI, "No WiFi networks configured");
     return false;
   }
 
-  const char* ssid = doc["ssid"];
-  const char* password = doc["password"];
-
-  Serial.printf("Connecting to %s...", ssid);
-  WiFi.begin(ssid, password);
-
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < WIFI_CONNECTION_MAX_ATTEMPTS) {
-    delay(40); // this changes the frame rate of the eyes animation during boot
-    roboEyes.update();
-    Serial.print(".");
-    attempts++;
-  }
+  StallSpan span(SPAN_WIFI);
+  for (uint8_t i = 0; i < count; i++) {
+    const char* ssid = config.wifi[candidates[i].profile].ssid;
+    LOG_INFO(WIFI, "Connecting to %s...", ssid);
+    unsigned long start = millis();
+    beginWifiCandidate(candidates[i]);
+
+    wl_status_t status = WiFi.status();
+    while (status != WL_CONNECTED && status != WL_NO_SSID_AVAIL && status != WL_WRONG_PASSWORD &&
+           millis() - start < WIFI_PROFILE_TIMEOUT_MS) {
+      delay(40); // this changes the frame rate of the eyes animation during boot
+      roboEyes.update();
+      display.flushNow();
+      logDrain();
+      status = WiFi.status();
+    }
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n[WiFi] Connected!");
-    Serial.print("IP: ");
-    Serial.println(WiFi.localIP());
-    return true;
-  } else {
-    Serial.println("\n[WiFi] Failed to connect");
-    return false;
+    if (status == WL_CONNECTED) {
+      wifiConnected(candidates[i].profile, millis() - start);
+      IPAddress ip = WiFi.localIP();
+      LOG_INFO(WIFI, "Connected! IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+      return true;
+    }
+    LOG_WARN(WIFI, "Failed to connect to %s after %u ms (status %d)", ssid, (uint32_t)(millis() - start), status);
   }
+  return false;
 }
 
 /* 
     Automatic font size according to the number of characters in the message
     21 characters per line and 8 lines total at size 1
 */
-int pickBestFontSize(String text) {
+int pickBestFontSize(const char* text) {
   const int screenW = 128;
   const int screenH = 64;
 
@@ -464,32 +561,69 @@ int pickBestFontSize(String text) {
     int linesPerScreen = screenH / charH;
     int maxChars = charsPerLine * linesPerScreen;
 
-    if (text.length() <= maxChars) {
+    if (strlen(text) <= (size_t)maxChars) {
       return size;
     }
   }
   return 1;
 }
 
+// Writes the message document to /message.json; a partly written file is removed
+bool saveTextMessage(const JsonDocument& doc) {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open("/message.json", "w");
+  if (!file) {
+    return false;
+  }
+  bool saved = serializeJson(doc, file) == measureJson(doc);
+  file.close();
+  if (!saved) {
+    LittleFS.remove("/message.json");
+  }
+  return saved;
+}
+
 /*
   Function to process incoming JSON messages from the WebSocket
   It expects a JSON object with the following structure:
   {
+    "seq": <uint>, // optional delivery sequence number (starting at 1)
     "size": <int>, // text size (1-4)
     "pos": [<x>, <y>], // cursor position
-    "text": "<string>" // text to display
+    "text": "<string>" // text to display, UTF-8
+    "revealAt": <uint> // optional Unix time to keep the message back until
   }
+  The document is parsed straight from the caller's buffer, and the message
+  is only written back to flash when it is new (saveAndForce).
 */
-void processJson(String jsonStr, bool saveAndForce) {
+void processJson(const char* json, size_t length, bool saveAndForce) {
+  StallSpan span(SPAN_JSON);
+  HeapScope scope(HEAP_TAG_JSON);
   StaticJsonDocument<256> doc;
-  DeserializationError error = deserializeJson(doc, jsonStr);
+  DeserializationError error = deserializeJson(doc, json, length);
 
   if (error) {
-    Serial.print("[JSON] Parse Error: ");
-    Serial.println(error.c_str());
+    LOG_ERROR(JSON, "Parse Error: %s", error.c_str());
+    return;
+  }
+
+  uint32_t seq = doc["seq"] | 0;
+  if (saveAndForce && rejectMessage(seq)) {
     return;
   }
 
+  uint32_t revealAt = doc["revealAt"] | 0;
+  if (saveAndForce && revealAt > (uint32_t)traceTime()) {
+    // Stored the way /message.json is, so loadSavedMessage() takes it when revealed
+    static char stored[SCHEDULE_MAX_BYTES + 1];
+    size_t storedLength = measureJson(doc) <= SCHEDULE_MAX_BYTES ? serializeJson(doc, stored, sizeof(stored)) : 0;
+    if (storedLength > 0 && scheduleMessage(revealAt, seq, stored, storedLength)) {
+      acknowledgeMessage(seq);  // delivered, revealScheduledMessage() shows it later
+      return;
+    }
+    LOG_WARN(JSON, "Could not schedule seq %u, showing it now", seq);
+  }
+
   if (doc.containsKey("size")) {
     display.setTextSize(doc["size"]);
   }
@@ -501,35 +635,221 @@ void processJson(String jsonStr, bool saveAndForce) {
   }
 
   if (doc.containsKey("text")) {
+    const char* text = doc["text"];
     display.clearDisplay();
     display.setTextColor(SSD1306_WHITE);
-    display.println(doc["text"].as<String>());
+    // Anything beyond ASCII comes from the glyph atlas, at its own size
+    if (!needsGlyphAtlas(text) || !drawUtf8Text(text, display.getCursorX(), display.getCursorY())) {
+      display.println(text);
+    }
     display.display();
   }
 
-  File file = LittleFS.open("/message.json", "w");
-  if (file) {
-    serializeJson(doc, file);
-    file.close();
-    Serial.println("[JSON] Saved to /message.json");
+  if (saveAndForce) {
+    // Not ACKed unless it is on flash, the server resends it after a reconnect
+    if (!saveTextMessage(doc)) {
+      LOG_ERROR(JSON, "Failed to save message seq %u", seq);
+      updateDisplay();
+      return;
+    }
+    removeOtherMessages("/message.json");
+    LOG_INFO(JSON, "Saved to /message.json");
+    acceptMessage(seq);
+  }
+
+}
+
+/*
+  Handles a binary WebSocket frame, see binary_protocol.h for the format.
+  Binary messages carry pre-rendered content, so nothing is parsed or laid
+  out here; the payload is copied into the display buffer and saved.
+*/
+void processBinary(const uint8_t* payload, size_t length) {
+  if (length < BINARY_HEADER_SIZE) {
+    LOG_ERROR(WS, "Binary frame too short");
+    return;
+  }
+  uint8_t type = payload[0];
+  uint8_t flags = payload[1];
+  payload += BINARY_HEADER_SIZE;
+  length -= BINARY_HEADER_SIZE;
+
+  switch (type) {
+    case BINARY_IMAGE: {
+      if (length < IMAGE_MESSAGE_HEADER_SIZE) {
+        LOG_ERROR(WS, "Image message too short");
+        return;
+      }
+      uint32_t seq = readLe32(payload);
+      if (rejectMessage(seq)) {
+        return;
+      }
+
+      // Unpacked in the back buffer, which the current mode redraws if the message is not kept
+      StallSpan span(SPAN_DISPLAY);
+      uint8_t* image = display.getBuffer();
+      if (!unpackImage(payload + IMAGE_MESSAGE_HEADER_SIZE, length - IMAGE_MESSAGE_HEADER_SIZE,
+                       flags & BINARY_FLAG_PACKBITS, image)) {
+        LOG_ERROR(WS, "Image message seq %u does not decode to a frame", seq);
+        updateDisplay();
+        return;
+      }
+      if (!saveImageMessage(image)) {
+        LOG_ERROR(JSON, "Failed to save image message seq %u", seq);
+        updateDisplay();
+        return;
+      }
+      removeOtherMessages(IMAGE_MESSAGE_PATH);
+      acceptMessage(seq);
+      break;
+    }
+
+    case BINARY_DOODLE: {
+      if (length < 4) {
+        LOG_ERROR(WS, "Doodle message too short");
+        return;
+      }
+      uint32_t seq = readLe32(payload);
+      if (rejectMessage(seq)) {
+        return;
+      }
+
+      const uint8_t* commands = payload + 4;
+      size_t commandsLength = length - 4;
+      if (!isValidDoodle(commands, commandsLength)) {
+        LOG_ERROR(WS, "Doodle message seq %u is malformed", seq);
+        return;
+      }
+      if (!saveDoodleMessage(commands, commandsLength)) {
+        LOG_ERROR(JSON, "Failed to save doodle message seq %u", seq);
+        return;
+      }
+      removeOtherMessages(DOODLE_MESSAGE_PATH);
+      acceptMessage(seq);
+      break;
+    }
+
+    case BINARY_OTA:
+      receiveOtaChunk(payload, length);
+      break;
+
+    case BINARY_MANIFEST:
+      receiveManifest(payload, length);
+      break;
+
+    case BINARY_ASSET:
+      receiveAssetChunk(payload, length);
+      break;
+
+    case BINARY_STREAM:
+      queueStreamFrame(flags, payload, length);
+      break;
+
+    default:
+      LOG_WARN(WS, "Unknown binary message type %u", type);
+      break;
+  }
+}
+
+/*
+  True if a message with this seq must not be stored, and answers it with
+  the current ACK:
+  - it was already stored; the server resends after a reconnect when it
+    missed our ACK, so the ACK is repeated
+  - it is too far ahead of the ACK to be tracked; the unchanged ACK tells
+    the server where the gap starts, and the message comes again after it
+*/
+bool rejectMessage(uint32_t seq) {
+  if (seq == 0) {
+    return false;
+  }
+  if (isDuplicateMessage(seq)) {
+    LOG_INFO(JSON, "Dropping duplicate message seq %u", seq);
+  } else if (isBeyondDeliveryWindow(seq)) {
+    LOG_WARN(DELIVERY, "Dropping seq %u, too far ahead of ack %u", seq, lastAckedSequence());
   } else {
-    Serial.println("[JSON] Failed to save message");
+    return false;
   }
+  sendDeliveryAck();
+  return true;
+}
 
-  if (saveAndForce) {
-    isMessageUnread = true;  // Mark new message as unread
-    forceMessageMode = true; // Force message mode display
-    Serial.println("[JSON] New message received. Forcing MODE_MESSAGE");
+// Only the newest message is kept, whatever its type
+void removeOtherMessages(const char* keep) {
+  static const char* const paths[] = { "/message.json", IMAGE_MESSAGE_PATH, DOODLE_MESSAGE_PATH };
+  for (const char* path : paths) {
+    if (strcmp(path, keep) != 0 && LittleFS.exists(path)) {
+      LittleFS.remove(path);
+    }
+  }
+}
+
+// Bookkeeping once a new message, of any type, has been saved
+void acceptMessage(uint32_t seq) {
+  acknowledgeMessage(seq);
+  revealMessage(seq);
+}
+
+// Records the message as delivered and tells the server
+void acknowledgeMessage(uint32_t seq) {
+  incrementMessagesReceived();
+  if (seq != 0) {
+    markMessageReceived(seq);
+    sendDeliveryAck();
   }
+}
 
+// Makes the saved message the unread one and brings it on screen
+void revealMessage(uint32_t seq) {
+  unreadMessageSeq = seq;
+  isMessageUnread = true;  // Mark new message as unread
+  forceMessageMode = true; // Force message mode display
+  LOG_INFO(JSON, "New message received. Forcing MODE_MESSAGE");
+}
+
+/*
+  Shows a scheduled message once its reveal time has come. It is read from
+  flash and goes through the same unread flow as a live message, so it
+  appears on time even with WiFi or the relay down. It leaves the schedule
+  only once /message.json holds it in full.
+*/
+void revealScheduledMessage() {
+  static char json[SCHEDULE_MAX_BYTES];
+  static time_t retryAt = 0;
+  time_t now = traceTime();
+  if (now < 100000 || now < retryAt) {
+    return;  // the clock has not been set yet, or the last save failed
+  }
+
+  ScheduledMessage due;
+  size_t length;
+  if (!readDueMessage(now, due, json, length)) {
+    return;
+  }
+
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open("/message.json", "w");
+  bool saved = file && file.write((const uint8_t*)json, length) == length;
+  if (file) {
+    file.close();
+  }
+  if (!saved) {
+    LittleFS.remove("/message.json");
+    LOG_ERROR(JSON, "Failed to save scheduled seq %u, retrying in %us", due.seq, SCHEDULE_RETRY_S);
+    retryAt = now + SCHEDULE_RETRY_S;
+    return;
+  }
+  removeDueMessage();
+  removeOtherMessages("/message.json");
+  revealMessage(due.seq);
 }
 
 /*
   Displays multiple lines of text on the OLED display
-  This function takes a vector of strings and displays them on the screen.
+  This function takes a list of C strings and prints them straight to the screen.
 
   Parameters:
-  - lines: A vector of strings to display.
+  - lines: The strings to display, one per line.
   - size: The text size multiplier (default is 1).
   - x: The x-coordinate for the text cursor (default is 0).
   - y: The y-coordinate for the text cursor (default is 0).
@@ -537,12 +857,12 @@ void processJson(String jsonStr, bool saveAndForce) {
   Example usage:
     displayMessageLines({ "Hello", "World" }, 2);
 */
-void displayMessageLines(const std::vector<String>& lines, int size, int x, int y) {
+void displayMessageLines(std::initializer_list<const char*> lines, int size, int x, int y) {
   display.clearDisplay();
   display.setTextSize(size);
   display.setTextColor(SSD1306_WHITE);
   display.setCursor(x, y);
-  for (const auto& line : lines) {
+  for (const char* line : lines) {
     display.println(line);
   }
   display.display();
@@ -552,26 +872,38 @@ void displayMessageLines(const std::vector<String>& lines, int size, int x, int
   Function to load a saved message from LittleFS
   This function reads a JSON file named "message.json" from the LittleFS filesystem
   and displays the message on the OLED screen using the same logic as processJson().
+  The file is read into a stack buffer and parsed once.
+  A saved image message (/message.bin) is read straight into the display
+  buffer, and a saved doodle (/message.doodle) is redrawn stroke by stroke.
 */
 void loadSavedMessage() {
+  StallSpan span(SPAN_FS);
+  if (loadImageMessage(display.getBuffer())) {
+    display.display();
+    return;
+  }
+  if (loadDoodleMessage()) {
+    startDoodle();  // replayed stroke by stroke from loop()
+    return;
+  }
+
   File file = LittleFS.open("/message.json", "r");
   if (!file) {
-    Serial.println("[LOAD] No saved message found.");
+    LOG_INFO(JSON, "No saved message found.");
     return;
   }
 
-  StaticJsonDocument<256> doc;
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
-
-  if (error) {
-    Serial.println("[LOAD] Failed to parse saved message.");
+  char json[MESSAGE_JSON_MAX];
+  size_t length = file.size();
+  if (length >= sizeof(json)) {
+    file.close();
+    LOG_ERROR(JSON, "Saved message too large.");
     return;
   }
+  length = file.readBytes(json, length);
+  file.close();
 
-  String jsonStr;
-  serializeJson(doc, jsonStr);
-  processJson(jsonStr, false);
+  processJson(json, length, false);
 }
 
 /*
@@ -580,8 +912,14 @@ void loadSavedMessage() {
   It handles different modes like MODE_ROBOT_EYES, MODE_MESSAGE, and MODE_DEBUG.
 */
 void updateDisplay() {
-  Serial.print("[DISPLAY] Updating mode: ");
-  Serial.println(currentMode);
+  StallSpan span(SPAN_DISPLAY);
+  HeapScope scope(HEAP_TAG_DISPLAY);
+  LOG_DEBUG(DISPLAY, "Updating mode: %d", currentMode);
+
+  stopAnimation();  // whatever was playing loses the screen
+  stopStream();
+  stopDoodle();
+  hideScreen();
 
   if (currentMode != MODE_ROBOT_EYES) {
     display.clearDisplay(); // Only clear when not in robot mode
@@ -589,6 +927,7 @@ void updateDisplay() {
 
   switch (currentMode) {
     case MODE_ROBOT_EYES:
+      wakeEyes();  // the eyes may be paused on a frame the other mode drew over
       break;
 
     case MODE_MESSAGE:
@@ -599,68 +938,16 @@ void updateDisplay() {
       }
       break;
     case MODE_STATS:
-    {
-      display.clearDisplay();
-
-      // Draw border box
-      display.drawRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SSD1306_WHITE);
-
-      // Decorative corner circles
-      int r = 3; // radius
-      display.fillCircle(0, 0, r, SSD1306_WHITE);
-      display.fillCircle(SCREEN_WIDTH - 1, 0, r, SSD1306_WHITE);
-      display.fillCircle(0, SCREEN_HEIGHT - 1, r, SSD1306_WHITE);
-      display.fillCircle(SCREEN_WIDTH - 1, SCREEN_HEIGHT - 1, r, SSD1306_WHITE);
-
-      // Draw title
-      display.setTextSize(1);
-      display.setTextColor(SSD1306_WHITE);
-      display.setCursor((SCREEN_WIDTH - 6 * strlen("LOVE LEDGER")) / 2, 4);
-      display.println("LOVE LEDGER");
-
-      // Horizontal separator line
-      display.drawLine(0, 14, SCREEN_WIDTH, 14, SSD1306_WHITE);
-
-      // Display stat lines (evenly spaced)
-      int baseY = 18;
-      int lineHeight = 11;
-
-      display.setCursor(10, baseY);
-      display.println("Headpats: " + String(stats.headpats));
-
-      display.setCursor(10, baseY + lineHeight);
-      display.println("Missed him: " + String(stats.missYouPresses));
-
-      display.setCursor(10, baseY + 2 * lineHeight);
-      display.println("Mood Swings: " + String(stats.moodSwings));
+      showScreen(&statsScreen);
+      break;
 
-      display.setCursor(10, baseY + 3 * lineHeight);
-      display.println("Love Notes: " + String(stats.messagesReceived));
-      display.display();
+    case MODE_HISTORY:
+      showScreen(&historyScreen);
       break;
-    }
+
     case MODE_DEBUG:
-    {
-      if (isInAPMode) {
-        String visitLine = "http://" + WiFi.softAPIP().toString() + "/";
-        displayMessageLines({
-          "WiFi Setup Mode",
-          "Turn on your phone's WiFi and connect to",
-          "ESP-Setup",
-          "",
-          "Visit:",
-          visitLine,
-          "to configure WiFi"
-        }, 1);
-      } else {
-        displayMessageLines({
-          "WiFi Status: " + String(WiFi.status()),
-          "IP: " + WiFi.localIP().toString(),
-          "Mode: DEBUG"
-        }, 1);
-      }
+      showScreen(isInAPMode ? &apScreen : &debugScreen);
       break;
-    }
   }
 
   
@@ -669,18 +956,17 @@ void updateDisplay() {
 /*
   Function to change the mood of the robot eyes
   This function changes the mood of the robot eyes and updates the display accordingly.
-  It also prints the new mood to the Serial monitor for debugging purposes.
+  It also logs the new mood for debugging purposes.
 */
 void changeMood(int mood) {
   if (currentMood != mood) {
     currentMood = mood;
     roboEyes.setMood(mood);
-    Serial.print("[MOOD] Changed to: ");
     switch (mood) {
-      case DEFAULT: Serial.println("DEFAULT"); break;
-      case HAPPY: Serial.println("HAPPY"); break;
-      case TIRED: Serial.println("TIRED"); break;
-      case ANGRY: Serial.println("ANGRY"); break;
+      case DEFAULT: LOG_INFO(MOOD, "Changed to: DEFAULT"); break;
+      case HAPPY: LOG_INFO(MOOD, "Changed to: HAPPY"); break;
+      case TIRED: LOG_INFO(MOOD, "Changed to: TIRED"); break;
+      case ANGRY: LOG_INFO(MOOD, "Changed to: ANGRY"); break;
     }
   }
 }
@@ -690,29 +976,22 @@ void changeMood(int mood) {
   It clears the display and draws a bitmap image of the logo in the center.
 */
 void showNewMessageLogo() {
-  display.clearDisplay();
-  display.drawBitmap((SCREEN_WIDTH - LOGO_WIDTH) / 2, (SCREEN_HEIGHT - LOGO_HEIGHT) / 2,
-                    messageAnimation[0], LOGO_WIDTH, LOGO_HEIGHT, SSD1306_WHITE);
-  display.display();
+  showAnimationFrame(&messageRevealAnimation, 0);
 }
 
 /*
   Function to play the full message animation
-  This function iterates through all frames of the message animation and displays them one by one.
-  It clears the display before each frame and waits for a specified duration between frames.
+  Starts the timeline player on the message reveal animation. Frames are
+  advanced by animationTick() from loop(), so input and WebSocket traffic
+  keep being serviced while it plays.
 */
 void playFullAnimation() {
-  Serial.println("[ANIMATION] Playing message animation");
-
-  for (uint8_t i = 0; i < messageAnimationFrameCount; i++) {
-    display.clearDisplay();
-    display.drawBitmap(0, 0, messageAnimation[i], LOGO_WIDTH, LOGO_HEIGHT, SSD1306_WHITE);
-    display.display();
-    delay(frameDurationMs);
-  }
+  LOG_INFO(ANIMATION, "Playing message animation");
+  startAnimation(&messageRevealAnimation);
 }
 
 int readMissedPresses() {
+  StallSpan span(SPAN_FS);
   File file = LittleFS.open("/missed_presses.txt", "r");
   if (!file) return 0;
   int count = file.parseInt();
@@ -726,6 +1005,7 @@ int readMissedPresses() {
   It overwrites the file with the new count.
 */
 void writeMissedPresses(int count) {
+  StallSpan span(SPAN_FS);
   File file = LittleFS.open("/missed_presses.txt", "w");
   if (file) {
     file.print(count);
@@ -736,86 +1016,105 @@ void writeMissedPresses(int count) {
 void handleSecondButtonPress() {
   if (webSocket.isConnected()) {
     // Send event to server
-    webSocket.sendTXT("{\"type\": \"miss_you_button\"}");
-    Serial.println("[BUTTON2] Sent miss_you_button");
+    webSocket.sendTXT(MISS_YOU_BUTTON_MESSAGE);
+    LOG_INFO(BUTTON, "Sent miss_you_button");
   } else {
     // Save press for later
     int current = readMissedPresses();
     writeMissedPresses(current + 1);
-    Serial.println("[BUTTON2] Stored offline miss_you_button");
+    LOG_INFO(BUTTON, "Stored offline miss_you_button");
   }
 }
 
-void loadStats() {
-  File file = LittleFS.open("/stats.json", "r");
-  if (!file) {
-    Serial.println("[STATS] No existing stats file. Starting fresh.");
-    return;
-  }
-
-  StaticJsonDocument<128> doc;
-  DeserializationError err = deserializeJson(doc, file);
-  file.close();
-
-  if (err) {
-    Serial.println("[STATS] Failed to parse stats.json");
-    return;
-  }
 
-  stats.headpats = doc["headpats"] | 0;
-  stats.missYouPresses = doc["missYouPresses"] | 0;
-  stats.moodSwings = doc["moodSwings"] | 0;
-  stats.messagesReceived = doc["messagesReceived"] | 0;
-  Serial.println("[STATS] Loaded from file");
+/*
+  Sends the cumulative ACK: every message up to and including "ack" has been
+  stored on flash and does not need to be resent.
+*/
+void sendDeliveryAck() {
+  char ack[PROTOCOL_MESSAGE_MAX];
+  formatAckMessage(ack, sizeof(ack), lastAckedSequence());
+  webSocket.sendTXT(ack);
 }
 
 /*
-  Function to save the current stats to a JSON file
-  This function writes the current stats to a file named "stats.json" in LittleFS.
-  It creates the file if it doesn't exist or overwrites it if it does.
-
-  Format:
-  {
-    "headpats": <int>,
-    "missYouPresses": <int>,
-    "moodSwings": <int>,
-    "messagesReceived": <int>
-  }
+  Tells the server that the message with this seq was actually seen,
+  i.e. the recipient touched the sensor and the message was shown.
 */
-void saveStats() {
-  StaticJsonDocument<128> doc;
-  doc["headpats"] = stats.headpats;
-  doc["missYouPresses"] = stats.missYouPresses;
-  doc["moodSwings"] = stats.moodSwings;
-  doc["messagesReceived"] = stats.messagesReceived;
-
-  File file = LittleFS.open("/stats.json", "w");
-  if (!file) {
-    Serial.println("[STATS] Failed to open stats.json for writing");
+void sendDisplayedReceipt(uint32_t seq) {
+  if (seq == 0 || !webSocket.isConnected()) {
     return;
   }
 
-  serializeJson(doc, file);
-  file.close();
-  Serial.println("[STATS] Saved to file");
-}
-
-void incrementHeadpats() {
-  stats.headpats++;
-  saveStats();
-}
-
-void incrementMissYouPresses() {
-  stats.missYouPresses++;
-  saveStats();
-}
-
-void incrementMoodSwings() {
-  stats.moodSwings++;
-  saveStats();
+  char receipt[PROTOCOL_MESSAGE_MAX];
+  formatDisplayedMessage(receipt, sizeof(receipt), seq);
+  webSocket.sendTXT(receipt);
 }
 
-void incrementMessagesReceived() {
-  stats.messagesReceived++;
-  saveStats();
-}
+/*
+  Single character commands typed into the Serial monitor
+    h - heap report
+    l - log lines recovered from before the last reset
+    s - loop stalls and the postmortem of the last reset
+    e - eye frame rate governor
+    v - last live stream
+    g - glyph cache hit rate
+    q - scheduled messages
+    o - firmware image and update progress
+    a - asset sync
+    c - configuration
+    w - WiFi networks and roaming
+    r - start or stop recording an input trace
+    t - trace recording or replay progress
+    y - stats history
+*/
+void handleSerialCommand(char command) {
+  switch (command) {
+    case 'h':
+      printHeapReport();
+      break;
+    case 'l':
+      printRecoveredLog();
+      break;
+    case 's':
+      printStallReport();
+      break;
+    case 'e':
+      printEyesReport();
+      break;
+    case 'v':
+      printStreamReport();
+      break;
+    case 'g':
+      printGlyphReport();
+      break;
+    case 'q':
+      printScheduleReport();
+      break;
+    case 'o':
+      printOtaReport();
+      break;
+    case 'a':
+      printAssetReport();
+      break;
+    case 'c':
+      printConfigReport();
+      break;
+    case 'w':
+      printWifiReport();
+      break;
+    case 'r':
+      if (isTraceRecording()) {
+        stopTraceRecording();
+      } else {
+        startTraceRecording();
+      }
+      break;
+    case 't':
+      printTraceReport();
+      break;
+    case 'y':
+      printStatsHistoryReport();
+      break;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include <message_delivery.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <heap_monitor.h>
+#include <log.h>
+#include <stall_watchdog.h>
+
+static DeliveryWindow window = {0, 0};
+
+static void saveDeliveryState() {
+  StallSpan span(SPAN_FS);
+  HeapScope scope(HEAP_TAG_FS);
+  StaticJsonDocument<64> doc;
+  doc["ack"] = window.ackedSeq;
+  doc["window"] = window.pendingWindow;
+
+  File file = LittleFS.open("/delivery.json", "w");
+  if (!file) {
+    LOG_ERROR(DELIVERY, "Failed to open delivery.json for writing");
+    return;
+  }
+
+  serializeJson(doc, file);
+  file.close();
+}
+
+/*
+  Function to load the delivery window from LittleFS
+  Missing or corrupt state starts from zero, which lets the server resend
+  everything it still has queued.
+*/
+void loadDeliveryState() {
+  File file = LittleFS.open("/delivery.json", "r");
+  if (!file) {
+    LOG_INFO(DELIVERY, "No delivery state. Starting from seq 0.");
+    return;
+  }
+
+  StaticJsonDocument<64> doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+
+  if (err) {
+    LOG_ERROR(DELIVERY, "Failed to parse delivery.json");
+    return;
+  }
+
+  window.ackedSeq = doc["ack"] | 0;
+  window.pendingWindow = doc["window"] | (uint64_t)0;
+  LOG_INFO(DELIVERY, "Resuming after seq %u", window.ackedSeq);
+}
+
+bool isDuplicateMessage(uint32_t seq) {
+  return isDuplicateInWindow(window, seq);
+}
+
+bool isBeyondDeliveryWindow(uint32_t seq) {
+  return isBeyondWindow(window, seq);
+}
+
+/*
+  Records seq as received and persists the window. A duplicate or a seq
+  beyond the window is ignored.
+
+  Returns true if the cumulative ACK advanced.
+*/
+bool markMessageReceived(uint32_t seq) {
+  uint32_t previousAck = window.ackedSeq;
+  if (!recordInWindow(window, seq)) {
+    return false;
+  }
+
+  saveDeliveryState();
+  return window.ackedSeq != previousAck;
+}
+
+uint32_t lastAckedSequence() {
+  return window.ackedSeq;
+}
@@ -0,0 +1,255 @@
+#include <ota_delta.h>
+#include <algorithm>
+#include <string.h>
+
+enum PatchState : uint8_t {
+  PATCH_OPCODE,
+  PATCH_OPERANDS,
+  PATCH_DATA,
+  PATCH_DONE
+};
+
+static uint32_t sourceSize = 0;
+static uint32_t targetSize = 0;
+static OtaSourceReader readSource = nullptr;
+static OtaTargetWriter writeTarget = nullptr;
+
+// LZSS decoder
+static uint8_t window[OTA_WINDOW_SIZE];
+static uint16_t windowPos = 0;
+static uint8_t flags = 0;
+static uint8_t flagsLeft = 0;
+static bool haveReferenceHigh = false;
+static uint8_t referenceHigh = 0;
+
+// Patch interpreter
+static PatchState patchState = PATCH_OPCODE;
+static uint8_t op = OTA_OP_END;
+static uint8_t operands[8];
+static uint8_t operandsUsed = 0;
+static uint8_t operandsNeeded = 0;
+static uint32_t opSource = 0;
+static uint32_t opRemaining = 0;
+
+static uint8_t output[OTA_OUTPUT_CHUNK];
+static uint16_t outputUsed = 0;
+static uint32_t written = 0;  // handed to writeTarget
+
+static uint8_t source[OTA_SOURCE_CHUNK];
+static uint32_t sourceStart = 0;
+static bool haveSource = false;  // source holds the running image from sourceStart
+
+static const char* failure = nullptr;
+
+static uint32_t le32(const uint8_t* p) {
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static bool fail(const char* reason) {
+  failure = reason;
+  return false;
+}
+
+static bool flushOutput() {
+  if (outputUsed == 0) {
+    return true;
+  }
+  if (!writeTarget(output, outputUsed)) {
+    return fail("flash write failed");
+  }
+  written += outputUsed;
+  outputUsed = 0;
+  return true;
+}
+
+static bool emit(uint8_t b) {
+  if (written + outputUsed >= targetSize) {
+    return fail("patch runs past the target size");
+  }
+  output[outputUsed++] = b;
+  return outputUsed < OTA_OUTPUT_CHUNK || flushOutput();
+}
+
+// Reads a byte of the running image for ADD, OTA_SOURCE_CHUNK at a time
+static bool sourceByte(uint32_t address, uint8_t& b) {
+  if (!haveSource || address < sourceStart || address - sourceStart >= OTA_SOURCE_CHUNK) {
+    uint32_t length = std::min<uint32_t>(OTA_SOURCE_CHUNK, sourceSize - address);
+    if (!readSource(address, source, length)) {
+      haveSource = false;
+      return fail("flash read failed");
+    }
+    sourceStart = address;
+    haveSource = true;
+  }
+  b = source[address - sourceStart];
+  return true;
+}
+
+// Copies running image bytes straight into the output buffer
+static bool copySource(uint32_t address, uint32_t length) {
+  if (written + outputUsed + length > targetSize) {
+    return fail("patch runs past the target size");
+  }
+  while (length > 0) {
+    uint16_t chunk = std::min<uint32_t>(length, OTA_OUTPUT_CHUNK - outputUsed);
+    if (!readSource(address, output + outputUsed, chunk)) {
+      return fail("flash read failed");
+    }
+    outputUsed += chunk;
+    address += chunk;
+    length -= chunk;
+    if (outputUsed == OTA_OUTPUT_CHUNK && !flushOutput()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool finishPatch() {
+  if (!flushOutput()) {
+    return false;
+  }
+  if (written != targetSize) {
+    return fail("patch ended short of the target size");
+  }
+  patchState = PATCH_DONE;
+  return true;
+}
+
+// Runs one decompressed byte through the patch interpreter
+static bool patchByte(uint8_t b) {
+  switch (patchState) {
+    case PATCH_OPCODE:
+      op = b;
+      operandsUsed = 0;
+      switch (op) {
+        case OTA_OP_END: return finishPatch();
+        case OTA_OP_COPY:
+        case OTA_OP_ADD: operandsNeeded = 8; break;
+        case OTA_OP_INSERT: operandsNeeded = 4; break;
+        default: return fail("unknown patch op");
+      }
+      patchState = PATCH_OPERANDS;
+      return true;
+
+    case PATCH_OPERANDS:
+      operands[operandsUsed++] = b;
+      if (operandsUsed < operandsNeeded) {
+        return true;
+      }
+      if (op == OTA_OP_INSERT) {
+        opRemaining = le32(operands);
+      } else {
+        opSource = le32(operands);
+        opRemaining = le32(operands + 4);
+        if (opSource > sourceSize || opRemaining > sourceSize - opSource) {
+          return fail("patch reads past the running image");
+        }
+        if (op == OTA_OP_COPY) {
+          patchState = PATCH_OPCODE;
+          return copySource(opSource, opRemaining);
+        }
+      }
+      patchState = opRemaining > 0 ? PATCH_DATA : PATCH_OPCODE;
+      return true;
+
+    case PATCH_DATA:
+      if (op == OTA_OP_ADD) {
+        uint8_t running;
+        if (!sourceByte(opSource++, running)) {
+          return false;
+        }
+        b += running;
+      }
+      if (--opRemaining == 0) {
+        patchState = PATCH_OPCODE;
+      }
+      return emit(b);
+
+    case PATCH_DONE:
+      return true;  // anything after OTA_OP_END is ignored
+  }
+  return false;
+}
+
+static bool decodedByte(uint8_t b) {
+  window[windowPos] = b;
+  windowPos = (windowPos + 1) % OTA_WINDOW_SIZE;
+  return patchByte(b);
+}
+
+// Runs one byte of the compressed body through the LZSS decoder
+static bool bodyByte(uint8_t b) {
+  if (flagsLeft == 0) {
+    flags = b;
+    flagsLeft = 8;
+    return true;
+  }
+
+  bool literal = flags & 1;
+  if (!literal && !haveReferenceHigh) {
+    referenceHigh = b;
+    haveReferenceHigh = true;
+    return true;
+  }
+  flags >>= 1;
+  flagsLeft--;
+
+  if (literal) {
+    return decodedByte(b);
+  }
+  haveReferenceHigh = false;
+  uint16_t distance = ((referenceHigh << 2) | (b >> 6)) + 1;
+  uint8_t length = (b & 0x3F) + 3;
+  for (uint8_t i = 0; i < length && patchState != PATCH_DONE; i++) {
+    if (!decodedByte(window[(windowPos + OTA_WINDOW_SIZE - distance) % OTA_WINDOW_SIZE])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Starts decoding a body that turns the sourceSize byte running image into a targetSize one
+void beginOtaDelta(uint32_t sourceBytes, uint32_t targetBytes, OtaSourceReader reader, OtaTargetWriter writer) {
+  sourceSize = sourceBytes;
+  targetSize = targetBytes;
+  readSource = reader;
+  writeTarget = writer;
+  windowPos = 0;
+  flagsLeft = 0;
+  haveReferenceHigh = false;
+  patchState = PATCH_OPCODE;
+  outputUsed = 0;
+  written = 0;
+  haveSource = false;
+  failure = nullptr;
+  memset(window, 0, sizeof(window));
+}
+
+/*
+  Decodes the next length bytes of the body, which may be cut anywhere.
+  Returns false on a malformed delta or a failed read or write, see
+  otaDeltaFailure(); the decoder then has to be begun again.
+*/
+bool applyOtaDelta(const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length && patchState != PATCH_DONE; i++) {
+    if (!bodyByte(data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// True once OTA_OP_END was decoded and the whole target was written
+bool isOtaDeltaDone() {
+  return patchState == PATCH_DONE;
+}
+
+// Bytes of the new image decoded so far, written or buffered
+uint32_t otaDeltaOutput() {
+  return written + outputUsed;
+}
+
+const char* otaDeltaFailure() {
+  return failure;
+}
@@ -0,0 +1,368 @@
+#include <ota_update.h>
+#include <ota_delta.h>
+#include <binary_protocol.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <Updater.h>
+#include <WebSocketsClient.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define OTA_MAGIC 0x3144424CUL  // "LBD1"
+
+extern WebSocketsClient webSocket;
+
+struct OtaHeader {
+  uint32_t magic;
+  uint32_t sourceSize;
+  uint8_t sourceMd5[16];
+  uint32_t targetSize;
+  uint8_t targetMd5[16];
+};
+
+enum OtaPhase : uint8_t {
+  OTA_IDLE,
+  OTA_HEADER,
+  OTA_SAVING,  // copying the running image to OTA_ROLLBACK_PATH, see otaTick()
+  OTA_BODY,
+  OTA_FINISHED
+};
+
+static OtaPhase phase = OTA_IDLE;
+static uint32_t nextOffset = 0;  // in the delta file
+static uint8_t headerBytes[OTA_HEADER_SIZE];
+static uint8_t headerUsed = 0;
+static OtaHeader header;
+static File rollbackFile;
+static uint32_t savedBytes = 0;  // of the running image, while OTA_SAVING
+
+static const char* failure = nullptr;
+static uint32_t startedMs = 0;
+
+static void sendReply(const char* key, uint32_t value) {
+  char reply[48];
+  snprintf(reply, sizeof(reply), "{\"type\": \"ota\", \"%s\": %u}", key, value);
+  webSocket.sendTXT(reply);
+}
+
+static void toHex(const uint8_t* md5, char* hex) {
+  for (uint8_t i = 0; i < 16; i++) {
+    sprintf(hex + 2 * i, "%02x", md5[i]);
+  }
+}
+
+static bool fail(const char* reason) {
+  failure = reason;
+  return false;
+}
+
+static bool readRunningImage(uint32_t address, uint8_t* data, size_t length) {
+  return ESP.flashRead(address, data, length);
+}
+
+static bool writeSpareSlot(const uint8_t* data, size_t length) {
+  if (Update.write(const_cast<uint8_t*>(data), length) != length) {
+    return false;
+  }
+  yield();  // a large copy writes many sectors in one go
+  return true;
+}
+
+/*
+  Checks the header and starts copying the running image to LittleFS, so
+  a failed update can be undone. otaTick() does the copy.
+*/
+static bool beginUpdate() {
+  memcpy(&header, headerBytes, sizeof(header));
+  if (header.magic != OTA_MAGIC) {
+    return fail("not a delta file");
+  }
+
+  if (header.sourceSize != 0) {
+    char md5[33];
+    toHex(header.sourceMd5, md5);
+    if (header.sourceSize != ESP.getSketchSize() || ESP.getSketchMD5() != md5) {
+      return fail("delta is for a different image");
+    }
+  }
+
+  LittleFS.remove(OTA_ROLLBACK_PATH);
+  FSInfo info;
+  if (!LittleFS.info(info) || info.totalBytes - info.usedBytes < ESP.getSketchSize() + 2 * info.blockSize) {
+    return fail("no room for the rollback image");
+  }
+  rollbackFile = LittleFS.open(OTA_ROLLBACK_PATH, "w");
+  if (!rollbackFile) {
+    return fail("no room for the rollback image");
+  }
+  savedBytes = 0;
+  phase = OTA_SAVING;
+  LOG_INFO(OTA, "Saving the running image, %u bytes", ESP.getSketchSize());
+  return true;
+}
+
+// Copies the next OTA_SAVE_STEP bytes of the running image
+static bool saveRollbackStep() {
+  uint8_t buffer[OTA_OUTPUT_CHUNK];
+  uint32_t until = min<uint32_t>(ESP.getSketchSize(), savedBytes + OTA_SAVE_STEP);
+  while (savedBytes < until) {
+    uint16_t chunk = min<uint32_t>(until - savedBytes, sizeof(buffer));
+    if (!ESP.flashRead(savedBytes, buffer, chunk) || rollbackFile.write(buffer, chunk) != chunk) {
+      return fail("could not save the rollback image");
+    }
+    savedBytes += chunk;
+  }
+  return true;
+}
+
+// The rollback image is saved: open the spare slot and hand the body to the decoder
+static bool beginWriting() {
+  if (!Update.begin(header.targetSize)) {
+    return fail("target does not fit the spare slot");
+  }
+  char md5[33];
+  toHex(header.targetMd5, md5);
+  Update.setMD5(md5);
+
+  beginOtaDelta(header.sourceSize, header.targetSize, readRunningImage, writeSpareSlot);
+  phase = OTA_BODY;
+  LOG_INFO(OTA, "Updating to a %u byte image", header.targetSize);
+  return true;
+}
+
+static bool finishUpdate() {
+  if (!Update.end()) {
+    return fail("target MD5 mismatch");
+  }
+  phase = OTA_FINISHED;
+  return true;
+}
+
+// Takes the header, then hands the body to the delta decoder
+static bool otaBytes(const uint8_t* data, size_t length) {
+  while (phase == OTA_HEADER && length > 0) {
+    headerBytes[headerUsed++] = *data++;
+    length--;
+    if (headerUsed == OTA_HEADER_SIZE && !beginUpdate()) {
+      return false;
+    }
+  }
+  if (phase != OTA_BODY) {
+    // Saving: the body comes again after the copy. Finished: anything
+    // after OTA_OP_END is ignored
+    return true;
+  }
+  if (!applyOtaDelta(data, length)) {
+    return fail(otaDeltaFailure());
+  }
+  return !isOtaDeltaDone() || finishUpdate();
+}
+
+static void abortOta() {
+  LOG_ERROR(OTA, "Update failed at byte %u: %s", nextOffset, failure);
+  if (Update.isRunning()) {
+    Update.end();  // unfinished, so this discards it
+  }
+  if (rollbackFile) {
+    rollbackFile.close();
+    LittleFS.remove(OTA_ROLLBACK_PATH);  // only part of the image
+  }
+  char reply[96];
+  snprintf(reply, sizeof(reply), "{\"type\": \"ota\", \"error\": \"%s\"}", failure);
+  webSocket.sendTXT(reply);
+  phase = OTA_IDLE;
+}
+
+static void startOta() {
+  if (Update.isRunning()) {
+    Update.end();
+  }
+  if (rollbackFile) {
+    rollbackFile.close();
+  }
+  phase = OTA_HEADER;
+  nextOffset = 0;
+  headerUsed = 0;
+  failure = nullptr;
+  startedMs = millis();
+}
+
+/*
+  Applies one BINARY_OTA frame: offset (u32) into the delta file, then its
+  bytes. Offset 0 starts a new update. Every frame is answered with the
+  offset expected next ({"type": "ota", "next": N}), so the server resends
+  from there after a drop, or with {"type": "ota", "error": "..."}. The
+  frame that completes the header is answered by otaTick() once the
+  running image is saved, and frames arriving meanwhile are dropped
+  unanswered. Once the image is verified the device replies "done" and
+  restarts into it.
+*/
+void receiveOtaChunk(const uint8_t* payload, size_t length) {
+  if (length < 4) {
+    LOG_ERROR(OTA, "Update frame too short");
+    return;
+  }
+  uint32_t offset = readLe32(payload);
+  payload += 4;
+  length -= 4;
+
+  if (offset == 0) {
+    startOta();
+  }
+  if (phase == OTA_IDLE) {
+    fail("no update in progress");
+    abortOta();
+    return;
+  }
+  if (phase == OTA_SAVING) {
+    return;  // answered by otaTick() when the copy is done
+  }
+  if (offset != nextOffset) {
+    sendReply("next", nextOffset);
+    return;
+  }
+
+  StallSpan span(SPAN_OTA);
+  if (!otaBytes(payload, length)) {
+    abortOta();
+    return;
+  }
+  if (phase == OTA_SAVING) {
+    nextOffset = OTA_HEADER_SIZE;  // the rest of the frame comes again after the copy
+    return;
+  }
+  nextOffset += length;
+
+  if (phase != OTA_FINISHED) {
+    sendReply("next", nextOffset);
+    return;
+  }
+
+  File file = LittleFS.open(OTA_STATE_PATH, "w");
+  if (file) {
+    file.print("{\"trial\": 0}");
+    file.close();
+  }
+  LOG_INFO(OTA, "Update verified after %u ms, %u delta bytes for %u, restarting",
+           (uint32_t)(millis() - startedMs), nextOffset, otaDeltaOutput());
+  sendReply("done", otaDeltaOutput());
+  logFlush();
+  delay(200);  // let the reply leave
+  ESP.restart();
+}
+
+bool isOtaRunning() {
+  return phase == OTA_HEADER || phase == OTA_SAVING || phase == OTA_BODY;
+}
+
+/*
+  Saves the running image OTA_SAVE_STEP bytes per call while an update
+  starts, so loop() keeps running through the copy, then asks the server
+  for the body. Call every loop() pass.
+*/
+void otaTick() {
+  if (phase != OTA_SAVING) {
+    return;
+  }
+
+  StallSpan span(SPAN_OTA);
+  if (!saveRollbackStep()) {
+    abortOta();
+    return;
+  }
+  if (savedBytes < ESP.getSketchSize()) {
+    return;
+  }
+  rollbackFile.close();
+  if (!beginWriting()) {
+    abortOta();
+    return;
+  }
+  sendReply("next", nextOffset);
+}
+
+/*
+  Flashes the saved image back and restarts into it; returns only on
+  failure. Without an image the trial ends here; a copy that fails keeps
+  the trial state, so the next boot tries again.
+*/
+static void rollBack() {
+  File file = LittleFS.open(OTA_ROLLBACK_PATH, "r");
+  if (!file || !Update.begin(file.size())) {
+    LOG_ERROR(OTA, "No image to roll back to");
+    LittleFS.remove(OTA_STATE_PATH);  // keep what we have rather than retry every boot
+    return;
+  }
+  uint32_t size = file.size();
+  uint32_t written = Update.writeStream(file);
+  file.close();
+  if (written != size) {
+    Update.end();  // unfinished, so this discards it
+    LOG_ERROR(OTA, "Rollback copy stopped after %u of %u bytes", written, size);
+    return;
+  }
+  if (!Update.end()) {
+    LOG_ERROR(OTA, "Rollback image did not verify");
+    return;
+  }
+  LittleFS.remove(OTA_STATE_PATH);
+  LittleFS.remove(OTA_ROLLBACK_PATH);
+  LOG_WARN(OTA, "Rolled back, restarting");
+  logFlush();
+  ESP.restart();
+}
+
+/*
+  Counts crashes of an image still on trial and rolls back after
+  OTA_TRIAL_BOOTS of them. Call first thing in setup(), after logBegin().
+*/
+void otaBootCheck() {
+  StallSpan span(SPAN_OTA);
+  if (!LittleFS.begin() || !LittleFS.exists(OTA_STATE_PATH)) {
+    return;
+  }
+
+  File file = LittleFS.open(OTA_STATE_PATH, "r");
+  StaticJsonDocument<32> doc;
+  deserializeJson(doc, file);
+  file.close();
+  uint8_t trial = doc["trial"] | 0;
+
+  uint32_t reason = ESP.getResetInfoPtr()->reason;
+  if (reason == REASON_WDT_RST || reason == REASON_EXCEPTION_RST || reason == REASON_SOFT_WDT_RST) {
+    trial++;
+    file = LittleFS.open(OTA_STATE_PATH, "w");
+    if (file) {
+      file.printf("{\"trial\": %u}", trial);
+      file.close();
+    }
+  }
+  LOG_WARN(OTA, "New firmware on trial, %u of %u crashes", trial, OTA_TRIAL_BOOTS);
+
+  if (trial >= OTA_TRIAL_BOOTS) {
+    LOG_ERROR(OTA, "New firmware keeps crashing, rolling back");
+    rollBack();
+  }
+}
+
+// The running image works well enough to take the next update; drop the rollback copy
+void confirmFirmware() {
+  if (!LittleFS.exists(OTA_STATE_PATH)) {
+    return;
+  }
+  LittleFS.remove(OTA_STATE_PATH);
+  LittleFS.remove(OTA_ROLLBACK_PATH);
+  LOG_INFO(OTA, "New firmware confirmed");
+}
+
+void printOtaReport() {
+  LOG_INFO(OTA, "Running image: %u bytes, MD5 %s", ESP.getSketchSize(), ESP.getSketchMD5().c_str());
+  if (phase == OTA_SAVING) {
+    LOG_INFO(OTA, "Update starting: %u of %u bytes of the running image saved", savedBytes, ESP.getSketchSize());
+  } else if (isOtaRunning()) {
+    LOG_INFO(OTA, "Update in progress: %u delta bytes in, %u of %u image bytes written",
+             nextOffset, phase == OTA_BODY ? otaDeltaOutput() : 0, header.targetSize);
+  } else if (LittleFS.exists(OTA_STATE_PATH)) {
+    LOG_INFO(OTA, "On trial until the next WebSocket connection");
+  }
+}
@@ -0,0 +1,88 @@
+#include <page_blit.h>
+#include <buffered_display.h>
+
+static inline uint32_t replicate(uint8_t b) {
+  return b * 0x01010101UL;
+}
+
+// Applies src to dst where cover is set; works on one byte or four at once
+static inline uint32_t combine(uint32_t dst, uint32_t src, uint32_t cover, BlitMode mode) {
+  src &= cover;
+  switch (mode) {
+    case BLIT_COPY: return (dst & ~cover) | src;
+    case BLIT_OR: return dst | src;
+    case BLIT_XOR: return dst ^ src;
+    case BLIT_ERASE:
+    default: return dst & ~src;
+  }
+}
+
+/*
+  Copies a page-layout bitmap into the frame buffer with its top left
+  corner at x, y.
+*/
+void blitPages(uint8_t* buffer, const uint8_t* bitmap, uint8_t width, uint8_t height,
+               int16_t x, int16_t y, BlitMode mode) {
+  int16_t from = max<int16_t>(0, -x);  // first visible column of the bitmap
+  int16_t to = min<int16_t>(width, SCREEN_WIDTH - x);
+  if (height == 0 || from >= to) {
+    return;
+  }
+
+  uint8_t bitmapPages = (height + 7) / 8;
+  int16_t firstPage = y >> 3;  // floor, also for negative y
+  uint8_t shift = y & 7;
+
+  // Whole pages landing on page boundaries are plain copies
+  if (mode == BLIT_COPY && shift == 0 && height % 8 == 0) {
+    if (x == 0 && y == 0 && width == SCREEN_WIDTH && height == SCREEN_HEIGHT) {
+      memcpy_P(buffer, bitmap, DISPLAY_BUFFER_SIZE);
+      return;
+    }
+    for (uint8_t page = 0; page < bitmapPages; page++) {
+      int16_t target = firstPage + page;
+      if (target >= 0 && target < DISPLAY_PAGES) {
+        memcpy_P(buffer + target * SCREEN_WIDTH + x + from, bitmap + page * width + from, to - from);
+      }
+    }
+    return;
+  }
+
+  bool words = (x & 3) == 0 && (width & 3) == 0 &&
+               ((uintptr_t)bitmap & 3) == 0 && ((uintptr_t)buffer & 3) == 0;
+  uint32_t lowMask = replicate(0xFF << shift);
+  uint32_t highMask = replicate(0xFF >> (8 - shift));
+
+  int16_t lastRow = y + height - 1;
+  int16_t lastPage = min<int16_t>(lastRow >> 3, DISPLAY_PAGES - 1);
+  for (int16_t target = max<int16_t>(firstPage, 0); target <= lastPage; target++) {
+    // Rows of this page the bitmap covers
+    uint8_t top = max<int16_t>(y - target * 8, 0);
+    uint8_t bottom = min<int16_t>(lastRow - target * 8, 7);
+    uint8_t cover = (0xFF << top) & (0xFF >> (7 - bottom));
+
+    // The bitmap page shifted down into this one, and the one whose bottom rows spill over
+    int16_t lowPage = target - firstPage;
+    const uint8_t* low = lowPage < bitmapPages ? bitmap + lowPage * width : nullptr;
+    const uint8_t* high = shift && lowPage > 0 ? bitmap + (lowPage - 1) * width : nullptr;
+    uint8_t* dst = buffer + target * SCREEN_WIDTH + x;
+
+    int16_t column = from;
+    if (words) {
+      uint32_t coverWord = replicate(cover);
+      for (; column + 4 <= to; column += 4) {
+        uint32_t bits = 0;
+        if (low) bits |= (pgm_read_dword(low + column) << shift) & lowMask;
+        if (high) bits |= (pgm_read_dword(high + column) >> (8 - shift)) & highMask;
+        uint32_t* word = (uint32_t*)(dst + column);
+        *word = combine(*word, bits, coverWord, mode);
+      }
+    }
+    for (; column < to; column++) {
+      uint8_t bits = 0;
+      if (low) bits |= pgm_read_byte(low + column) << shift;
+      if (high) bits |= pgm_read_byte(high + column) >> (8 - shift);
+      dst[column] = combine(dst[column], bits, cover, mode);
+    }
+  }
+}
@@ -0,0 +1,14 @@
+#include <protocol_messages.h>
+#include <stdio.h>
+
+int formatHelloMessage(char* out, size_t size, uint32_t lastAck) {
+  return snprintf(out, size, "{\"type\": \"hello\", \"last_ack\": %u}", (unsigned)lastAck);
+}
+
+int formatAckMessage(char* out, size_t size, uint32_t ack) {
+  return snprintf(out, size, "{\"type\": \"ack\", \"ack\": %u}", (unsigned)ack);
+}
+
+int formatDisplayedMessage(char* out, size_t size, uint32_t seq) {
+  return snprintf(out, size, "{\"type\": \"displayed\", \"seq\": %u}", (unsigned)seq);
+}
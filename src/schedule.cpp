@@ -0,0 +1,285 @@
+#include <schedule.h>
+#include <LittleFS.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define SCHEDULE_MAGIC 0x31484353UL  // "SCH1"
+
+struct ScheduleHeader {
+  uint32_t magic;
+  uint16_t count;
+  uint16_t reserved;
+  uint32_t nextId;
+};
+
+static ScheduleHeader header = { SCHEDULE_MAGIC, 0, 0, 1 };
+static ScheduledMessage head;  // entry 0 while count > 0
+
+static bool before(const ScheduledMessage& a, const ScheduledMessage& b) {
+  if (a.revealAt != b.revealAt) {
+    return a.revealAt < b.revealAt;
+  }
+  return (int32_t)(a.id - b.id) < 0;
+}
+
+static void bodyPath(uint32_t id, char* path, size_t size) {
+  snprintf(path, size, SCHEDULE_DIR "/%u.json", id);
+}
+
+static bool readEntry(File& file, uint16_t index, ScheduledMessage& entry) {
+  return file.seek(sizeof(ScheduleHeader) + index * sizeof(ScheduledMessage)) &&
+         file.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry);
+}
+
+static bool writeEntry(File& file, uint16_t index, const ScheduledMessage& entry) {
+  return file.seek(sizeof(ScheduleHeader) + index * sizeof(ScheduledMessage)) &&
+         file.write((const uint8_t*)&entry, sizeof(entry)) == sizeof(entry);
+}
+
+static bool writeHeader(File& file) {
+  return file.seek(0) && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+}
+
+/*
+  Moves entry down from index to its place among the first count entries.
+  Returns false if a child could not be read; entry is written anyway, so
+  nothing is lost, but the heap may be out of order.
+*/
+static bool siftDown(File& file, uint16_t index, const ScheduledMessage& entry, uint16_t count) {
+  bool intact = true;
+  while (true) {
+    uint16_t child = 2 * index + 1;
+    if (child >= count) {
+      break;
+    }
+    ScheduledMessage smaller;
+    ScheduledMessage sibling;
+    bool hasSibling = child + 1 < count;
+    if (!readEntry(file, child, smaller) || (hasSibling && !readEntry(file, child + 1, sibling))) {
+      intact = false;
+      break;
+    }
+    if (hasSibling && before(sibling, smaller)) {
+      smaller = sibling;
+      child++;
+    }
+    if (!before(smaller, entry)) {
+      break;
+    }
+    writeEntry(file, index, smaller);
+    index = child;
+  }
+  return writeEntry(file, index, entry) && intact;
+}
+
+static File openHeap() {
+  if (!LittleFS.exists(SCHEDULE_PATH)) {
+    File file = LittleFS.open(SCHEDULE_PATH, "w");
+    if (file) {
+      writeHeader(file);
+      file.close();
+    }
+  }
+  return LittleFS.open(SCHEDULE_PATH, "r+");
+}
+
+/*
+  Reads the heap header and caches its head. LittleFS commits a file on
+  close, so an insert or pop cut short by a reset leaves the previous
+  heap; one that still fails the order check is rebuilt in place.
+*/
+void loadSchedule() {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(SCHEDULE_PATH, "r+");
+  if (!file) {
+    LOG_INFO(SCHEDULE, "No scheduled messages");
+    return;
+  }
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) || header.magic != SCHEDULE_MAGIC) {
+    LOG_ERROR(SCHEDULE, "Failed to parse %s, starting empty", SCHEDULE_PATH);
+    header = { SCHEDULE_MAGIC, 0, 0, 1 };
+    writeHeader(file);
+    file.close();
+    return;
+  }
+
+  // Check the order entry by entry against the parent, straight from flash
+  ScheduledMessage entry;
+  ScheduledMessage parent;
+  uint16_t count = 0;
+  bool ordered = true;
+  while (count < min<uint16_t>(header.count, SCHEDULE_MAX_ENTRIES) && readEntry(file, count, entry)) {
+    if (count > 0 && ordered) {
+      ordered = readEntry(file, (count - 1) / 2, parent) && !before(entry, parent);
+    }
+    count++;
+  }
+  if (!ordered || count != header.count) {
+    LOG_WARN(SCHEDULE, "Heap out of order, rebuilding %u entries", count);
+    header.count = count;
+    for (int16_t i = count / 2 - 1; i >= 0; i--) {
+      if (readEntry(file, i, entry)) {
+        siftDown(file, i, entry, count);
+      }
+    }
+    writeHeader(file);
+  }
+
+  if (header.count > 0 && readEntry(file, 0, head)) {
+    LOG_INFO(SCHEDULE, "%u scheduled, next at %u", header.count, head.revealAt);
+  }
+  file.close();
+}
+
+/*
+  Stores a message to be revealed at revealAt. Returns false when the
+  queue is full or the message too large; the caller shows it right away.
+*/
+bool scheduleMessage(uint32_t revealAt, uint32_t seq, const char* json, size_t length) {
+  if (header.count >= SCHEDULE_MAX_ENTRIES || length > SCHEDULE_MAX_BYTES) {
+    return false;
+  }
+  StallSpan span(SPAN_FS);
+
+  ScheduledMessage entry = { revealAt, seq, header.nextId };
+  char path[32];
+  bodyPath(entry.id, path, sizeof(path));
+  File body = LittleFS.open(path, "w");
+  if (!body) {
+    LOG_ERROR(SCHEDULE, "Failed to open %s for writing", path);
+    return false;
+  }
+  bool written = body.write((const uint8_t*)json, length) == length;
+  body.close();
+
+  File file = openHeap();
+  if (!written || !file) {
+    LOG_ERROR(SCHEDULE, "Failed to store scheduled message");
+    LittleFS.remove(path);
+    return false;
+  }
+
+  // Sift up from the new leaf
+  uint16_t index = header.count;
+  while (index > 0) {
+    uint16_t parent = (index - 1) / 2;
+    ScheduledMessage above;
+    if (!readEntry(file, parent, above) || !before(entry, above)) {
+      break;
+    }
+    writeEntry(file, index, above);
+    index = parent;
+  }
+  writeEntry(file, index, entry);
+
+  header.count++;
+  header.nextId++;
+  writeHeader(file);
+  file.close();
+
+  if (index == 0) {
+    head = entry;
+  }
+  LOG_INFO(SCHEDULE, "seq %u scheduled for %u, %u pending", seq, revealAt, header.count);
+  return true;
+}
+
+/*
+  Reads the head into due and its body into json (SCHEDULE_MAX_BYTES) if
+  its reveal time has come. The entry stays queued until the caller has
+  saved it and calls removeDueMessage(); a head whose body is missing is
+  dropped. Cheap when nothing is due: only the cached head is looked at.
+*/
+bool readDueMessage(uint32_t now, ScheduledMessage& due, char* json, size_t& length) {
+  if (header.count == 0 || now < head.revealAt) {
+    return false;
+  }
+  StallSpan span(SPAN_FS);
+  due = head;
+  char path[32];
+  bodyPath(due.id, path, sizeof(path));
+  File body = LittleFS.open(path, "r");
+  length = body ? body.read((uint8_t*)json, SCHEDULE_MAX_BYTES) : 0;
+  body.close();
+
+  if (length == 0) {
+    LOG_ERROR(SCHEDULE, "Body of scheduled seq %u is missing", due.seq);
+    removeDueMessage();
+    return false;
+  }
+  return true;
+}
+
+/*
+  Pops the head and deletes its body. An entry that cannot be read while
+  sifting the last leaf down leaves the heap unchecked, so it is loaded
+  again, which rebuilds it if needed.
+*/
+void removeDueMessage() {
+  if (header.count == 0) {
+    return;
+  }
+  StallSpan span(SPAN_FS);
+  File file = openHeap();
+  if (!file) {
+    return;
+  }
+
+  uint32_t seq = head.seq;
+  char path[32];
+  bodyPath(head.id, path, sizeof(path));
+  LittleFS.remove(path);
+
+  header.count--;
+  bool intact = true;
+  if (header.count > 0) {
+    ScheduledMessage last;
+    intact = readEntry(file, header.count, last) &&
+             siftDown(file, 0, last, header.count) &&
+             readEntry(file, 0, head);
+  }
+  writeHeader(file);
+  file.close();
+
+  if (!intact) {
+    LOG_WARN(SCHEDULE, "Short read while removing seq %u", seq);
+    loadSchedule();
+    return;
+  }
+  LOG_INFO(SCHEDULE, "Revealing seq %u, %u still pending", seq, header.count);
+}
+
+uint16_t scheduledCount() {
+  return header.count;
+}
+
+/*
+  Reads pending entry index in heap order, which is not reveal order, for
+  exports. Entries move when one is added or revealed in between calls.
+*/
+bool readScheduledEntry(uint16_t index, ScheduledMessage& entry) {
+  if (index >= header.count) {
+    return false;
+  }
+  File file = LittleFS.open(SCHEDULE_PATH, "r");
+  if (!file) {
+    return false;
+  }
+  bool ok = readEntry(file, index, entry);
+  file.close();
+  return ok;
+}
+
+void scheduledBodyPath(uint32_t id, char* path, size_t size) {
+  bodyPath(id, path, size);
+}
+
+void printScheduleReport() {
+  if (header.count == 0) {
+    LOG_INFO(SCHEDULE, "No scheduled messages");
+    return;
+  }
+  LOG_INFO(SCHEDULE, "%u scheduled, next is seq %u at %u (now %u)",
+           header.count, head.seq, head.revealAt, (uint32_t)time(nullptr));
+}
+
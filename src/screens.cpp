@@ -0,0 +1,146 @@
+#include <screens.h>
+#include <buffered_display.h>
+#include <connection_health.h>
+#include <stats.h>
+#include <stats_history.h>
+#include <heap_monitor.h>
+#include <trace.h>
+#include <ESP8266WiFi.h>
+
+extern BufferedDisplay display;
+
+static void formatIp(char* buf, size_t len, const char* prefix, IPAddress ip, const char* suffix) {
+  snprintf(buf, len, "%s%u.%u.%u.%u%s", prefix, ip[0], ip[1], ip[2], ip[3], suffix);
+}
+
+/*
+  Stats screen ("LOVE LEDGER")
+  Border, corner dots, title and separator are drawn once; only the four
+  counters are redrawn, and only when they change.
+*/
+static FrameWidget statsBorder(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 3);
+static LabelWidget statsTitle((SCREEN_WIDTH - 6 * (sizeof("LOVE LEDGER") - 1)) / 2, 4, "LOVE LEDGER");
+static LineWidget statsSeparator(0, 14, SCREEN_WIDTH, 14);
+static NumberWidget statsHeadpats(10, 18, 108, "Headpats: ", &stats.headpats);
+static NumberWidget statsMissed(10, 29, 108, "Missed him: ", &stats.missYouPresses);
+static NumberWidget statsMoodSwings(10, 40, 108, "Mood Swings: ", &stats.moodSwings);
+static NumberWidget statsNotes(10, 51, 108, "Love Notes: ", &stats.messagesReceived);
+
+static Widget* const statsWidgets[] = {
+  &statsBorder, &statsTitle, &statsSeparator,
+  &statsHeadpats, &statsMissed, &statsMoodSwings, &statsNotes
+};
+const Screen statsScreen = { statsWidgets, sizeof(statsWidgets) / sizeof(statsWidgets[0]) };
+
+/*
+  History screen: one row per counter, a sparkline of the last 48 hours
+  and weekly bars over the last 90 days. Each chart reads its series from
+  flash only when the history changed.
+*/
+static uint8_t readHourly(uint8_t counter, uint16_t* values) {
+  return readStatsSeries((StatsCounter)counter, STATS_HOURLY, values);
+}
+
+static uint8_t readDaily(uint8_t counter, uint16_t* values) {
+  return readStatsSeries((StatsCounter)counter, STATS_DAILY, values);
+}
+
+static LabelWidget historyPats(0, 4, "Pats");
+static LabelWidget historyMissed(0, 20, "Miss");
+static LabelWidget historyMoods(0, 36, "Mood");
+static LabelWidget historyNotes(0, 52, "Note");
+static ChartWidget historyPatsHours(26, 1, 48, 14, ChartWidget::SPARKLINE, readHourly, STATS_HEADPATS,
+                                    &statsHistoryVersion);
+static ChartWidget historyMissedHours(26, 17, 48, 14, ChartWidget::SPARKLINE, readHourly, STATS_MISS_YOU,
+                                      &statsHistoryVersion);
+static ChartWidget historyMoodsHours(26, 33, 48, 14, ChartWidget::SPARKLINE, readHourly, STATS_MOOD_SWINGS,
+                                     &statsHistoryVersion);
+static ChartWidget historyNotesHours(26, 49, 48, 14, ChartWidget::SPARKLINE, readHourly, STATS_MESSAGES,
+                                     &statsHistoryVersion);
+static ChartWidget historyPatsWeeks(76, 1, 52, 14, ChartWidget::BARS, readDaily, STATS_HEADPATS,
+                                    &statsHistoryVersion, 7);
+static ChartWidget historyMissedWeeks(76, 17, 52, 14, ChartWidget::BARS, readDaily, STATS_MISS_YOU,
+                                      &statsHistoryVersion, 7);
+static ChartWidget historyMoodsWeeks(76, 33, 52, 14, ChartWidget::BARS, readDaily, STATS_MOOD_SWINGS,
+                                     &statsHistoryVersion, 7);
+static ChartWidget historyNotesWeeks(76, 49, 52, 14, ChartWidget::BARS, readDaily, STATS_MESSAGES,
+                                     &statsHistoryVersion, 7);
+
+static Widget* const historyWidgets[] = {
+  &historyPats, &historyMissed, &historyMoods, &historyNotes,
+  &historyPatsHours, &historyMissedHours, &historyMoodsHours, &historyNotesHours,
+  &historyPatsWeeks, &historyMissedWeeks, &historyMoodsWeeks, &historyNotesWeeks
+};
+const Screen historyScreen = { historyWidgets, sizeof(historyWidgets) / sizeof(historyWidgets[0]) };
+
+/*
+  Debug screen: WiFi state and connection quality, one line per value
+*/
+static void formatWifiStatus(char* buf, size_t len) {
+  snprintf(buf, len, "WiFi Status: %d", WiFi.status());
+}
+
+static void formatLocalIp(char* buf, size_t len) {
+  formatIp(buf, len, "IP: ", WiFi.localIP(), "");
+}
+
+static void formatHeap(char* buf, size_t len) {
+  HeapSample heap = currentHeapSample();
+  snprintf(buf, len, "Heap: %uk/%uk %u%%%s", heap.freeHeap / 1024, heap.maxBlock / 1024, heap.fragmentation,
+           heapWarning() == HEAP_OK ? "" : " !");
+}
+
+static void formatRssi(char* buf, size_t len) {
+  snprintf(buf, len, "RSSI: %d dBm", WiFi.RSSI());
+}
+
+static void formatRtt(char* buf, size_t len) {
+  snprintf(buf, len, "RTT: %u ms (max %u)", connectionStats.rttEwmaMs, connectionStats.rttMaxMs);
+}
+
+static void formatReconnects(char* buf, size_t len) {
+  snprintf(buf, len, "Reconnects: %u", connectionStats.reconnects);
+}
+
+static void formatWsUptime(char* buf, size_t len) {
+  uint32_t up = connectionStats.connectedSince ? (traceMillis() - connectionStats.connectedSince) / 1000 : 0;
+  snprintf(buf, len, "WS up: %um %us", up / 60, up % 60);
+}
+
+static void formatLcd(char* buf, size_t len) {
+  snprintf(buf, len, "LCD: %u fps, %u us", display.stats.fps, display.stats.lastFlushUs);
+}
+
+static TextWidget debugWifi(0, 0, SCREEN_WIDTH, formatWifiStatus);
+static TextWidget debugIp(0, 8, SCREEN_WIDTH, formatLocalIp);
+static TextWidget debugHeap(0, 16, SCREEN_WIDTH, formatHeap);
+static TextWidget debugRssi(0, 24, SCREEN_WIDTH, formatRssi);
+static TextWidget debugRtt(0, 32, SCREEN_WIDTH, formatRtt);
+static TextWidget debugReconnects(0, 40, SCREEN_WIDTH, formatReconnects);
+static TextWidget debugUptime(0, 48, SCREEN_WIDTH, formatWsUptime);
+static TextWidget debugLcd(0, 56, SCREEN_WIDTH, formatLcd);
+
+static Widget* const debugWidgets[] = {
+  &debugWifi, &debugIp, &debugHeap, &debugRssi,
+  &debugRtt, &debugReconnects, &debugUptime, &debugLcd
+};
+const Screen debugScreen = { debugWidgets, sizeof(debugWidgets) / sizeof(debugWidgets[0]) };
+
+/*
+  WiFi setup screen shown in AP mode. The second label wraps over two lines.
+*/
+static void formatVisitUrl(char* buf, size_t len) {
+  formatIp(buf, len, "http://", WiFi.softAPIP(), "/");
+}
+
+static LabelWidget apTitle(0, 0, "WiFi Setup Mode");
+static LabelWidget apConnect(0, 8, "Turn on your phone's WiFi and connect to");
+static LabelWidget apSsid(0, 24, "ESP-Setup");
+static LabelWidget apVisit(0, 40, "Visit:");
+static TextWidget apUrl(0, 48, SCREEN_WIDTH, formatVisitUrl);
+static LabelWidget apConfigure(0, 56, "to configure WiFi");
+
+static Widget* const apWidgets[] = {
+  &apTitle, &apConnect, &apSsid, &apVisit, &apUrl, &apConfigure
+};
+const Screen apScreen = { apWidgets, sizeof(apWidgets) / sizeof(apWidgets[0]) };
@@ -0,0 +1,235 @@
+#include <stall_watchdog.h>
+#include <rtc_layout.h>
+#include <log.h>
+
+#define RTC_STALL_MAGIC 0x53544C31UL  // "STL1"
+#define STALL_MS_MAX 4095              // 12 bits per duration in a packed record
+#define STALL_CRASHED 0x80000000UL
+
+// Packed so it fits RTC_STALL_WORDS; millis() values are kept to 24 bits
+struct RtcStallBlock {
+  uint32_t magic;
+  uint32_t current;   // open span << 24 | millis() when it was entered
+  uint32_t crash;     // STALL_CRASHED | millis() at an exception or soft WDT, 0 otherwise
+  uint8_t head;
+  uint8_t count;
+  uint16_t reserved;
+  uint32_t records[STALL_RECORDS][2];  // span << 24 | spanMs << 12 | passMs, uptime in s
+};
+
+static_assert(sizeof(RtcStallBlock) <= RTC_STALL_WORDS * 4, "stall records do not fit their RTC slot");
+
+StallStats stallStats;
+
+static RtcStallBlock rtcBlock;
+static StallSpanId currentSpan = SPAN_SETUP;
+static uint32_t currentSinceUs = 0;
+static uint32_t passStartUs = 0;
+static bool passStarted = false;
+static uint32_t passUs[SPAN_COUNT];
+
+// What the previous boot left behind
+static rst_info previousReset;
+static StallSpanId previousSpan = SPAN_LOOP;
+static uint32_t previousSpanStartMs = 0;
+static uint32_t previousCrash = 0;
+static StallRecord previousRecords[STALL_RECORDS];
+static uint8_t previousCount = 0;
+
+static const char* const spanNames[SPAN_COUNT] = {
+  "loop", "setup", "WiFi", "NTP", "WS", "replay", "JSON", "FS",
+  "display", "animation", "eyes", "screen", "web", "OTA"
+};
+
+static void rtcWriteCurrent() {
+  rtcBlock.current = ((uint32_t)currentSpan << 24) | (millis() & 0xFFFFFF);
+  ESP.rtcUserMemoryWrite(RTC_STALL_OFFSET + offsetof(RtcStallBlock, current) / 4, &rtcBlock.current, 4);
+}
+
+static StallRecord unpackRecord(const uint32_t* packed) {
+  StallRecord record;
+  record.span = (StallSpanId)min<uint32_t>(packed[0] >> 24, SPAN_COUNT - 1);
+  record.spanMs = (packed[0] >> 12) & 0xFFF;
+  record.passMs = packed[0] & 0xFFF;
+  record.uptimeS = packed[1];
+  return record;
+}
+
+// Charges the time since the last switch to the open span
+static void chargeCurrent(uint32_t nowUs) {
+  passUs[currentSpan] += nowUs - currentSinceUs;
+  currentSinceUs = nowUs;
+}
+
+static void recordStall(StallSpanId span, uint32_t spanMs, uint32_t passMs) {
+  uint32_t* packed = rtcBlock.records[rtcBlock.head];
+  packed[0] = ((uint32_t)span << 24) | (min<uint32_t>(spanMs, STALL_MS_MAX) << 12) | min<uint32_t>(passMs, STALL_MS_MAX);
+  packed[1] = millis() / 1000;
+
+  ESP.rtcUserMemoryWrite(RTC_STALL_OFFSET + (offsetof(RtcStallBlock, records) / 4) + rtcBlock.head * 2, packed, 8);
+  rtcBlock.head = (rtcBlock.head + 1) % STALL_RECORDS;
+  if (rtcBlock.count < STALL_RECORDS) {
+    rtcBlock.count++;
+  }
+  ESP.rtcUserMemoryWrite(RTC_STALL_OFFSET + offsetof(RtcStallBlock, head) / 4, (uint32_t*)&rtcBlock.head, 4);
+}
+
+/*
+  Called by the core on exceptions and software watchdog resets, right
+  before the restart. Only stamps the time; everything else is already in RTC.
+*/
+extern "C" void custom_crash_callback(struct rst_info* info, uint32_t stack, uint32_t stackEnd) {
+  (void)info;
+  (void)stack;
+  (void)stackEnd;
+  rtcBlock.crash = STALL_CRASHED | (millis() & 0xFFFFFF);
+  ESP.rtcUserMemoryWrite(RTC_STALL_OFFSET + offsetof(RtcStallBlock, crash) / 4, &rtcBlock.crash, 4);
+}
+
+StallSpan::StallSpan(StallSpanId id) : previous(currentSpan) {
+  chargeCurrent(micros());
+  currentSpan = id;
+  rtcWriteCurrent();
+}
+
+StallSpan::~StallSpan() {
+  chargeCurrent(micros());
+  currentSpan = previous;
+  rtcWriteCurrent();
+}
+
+/*
+  Picks up the records and the open span the previous boot left in RTC
+  memory, then starts a fresh block. Call early in setup(), after logBegin().
+*/
+void stallWatchdogBegin() {
+  previousReset = *ESP.getResetInfoPtr();
+  ESP.rtcUserMemoryRead(RTC_STALL_OFFSET, (uint32_t*)&rtcBlock, sizeof(rtcBlock));
+
+  if (rtcBlock.magic == RTC_STALL_MAGIC && rtcBlock.count <= STALL_RECORDS && rtcBlock.head < STALL_RECORDS) {
+    previousSpan = (StallSpanId)min<uint32_t>(rtcBlock.current >> 24, SPAN_COUNT - 1);
+    previousSpanStartMs = rtcBlock.current & 0xFFFFFF;
+    previousCrash = rtcBlock.crash;
+    previousCount = rtcBlock.count;
+    uint8_t oldest = (rtcBlock.head + STALL_RECORDS - rtcBlock.count) % STALL_RECORDS;
+    for (uint8_t i = 0; i < previousCount; i++) {
+      previousRecords[i] = unpackRecord(rtcBlock.records[(oldest + i) % STALL_RECORDS]);
+    }
+  }
+
+  memset(&rtcBlock, 0, sizeof(rtcBlock));
+  rtcBlock.magic = RTC_STALL_MAGIC;
+  ESP.rtcUserMemoryWrite(RTC_STALL_OFFSET, (uint32_t*)&rtcBlock, sizeof(rtcBlock));
+
+  currentSpan = SPAN_SETUP;
+  currentSinceUs = micros();
+  rtcWriteCurrent();
+
+  if (previousReset.reason == REASON_WDT_RST || previousReset.reason == REASON_EXCEPTION_RST ||
+      previousReset.reason == REASON_SOFT_WDT_RST || previousCount > 0) {
+    printStallReport();
+  }
+}
+
+/*
+  Closes the previous loop() pass and starts the next. Call first thing
+  in loop(); a pass over STALL_BUDGET_MS is recorded against the subsystem
+  that used most of it.
+*/
+void stallLoopTick() {
+  uint32_t nowUs = micros();
+  chargeCurrent(nowUs);
+  currentSpan = SPAN_LOOP;
+  rtcWriteCurrent();
+
+  if (passStarted) {
+    uint32_t passMs = (nowUs - passStartUs) / 1000;
+    stallStats.passes++;
+
+    if (passMs > STALL_BUDGET_MS) {
+      StallSpanId worst = SPAN_LOOP;
+      for (uint8_t i = 1; i < SPAN_COUNT; i++) {
+        if (passUs[i] > passUs[worst]) {
+          worst = (StallSpanId)i;
+        }
+      }
+      uint32_t spanMs = passUs[worst] / 1000;
+
+      stallStats.stalls++;
+      if (passMs > stallStats.worstPassMs) {
+        stallStats.worstPassMs = passMs;
+        stallStats.worstSpan = worst;
+      }
+      recordStall(worst, spanMs, passMs);
+      LOG_WARN(STALL, "loop() pass took %u ms, %u ms in %s", passMs, spanMs, spanNames[worst]);
+    }
+  }
+
+  memset(passUs, 0, sizeof(passUs));
+  passStartUs = nowUs;
+  passStarted = true;
+}
+
+const char* stallSpanName(StallSpanId id) {
+  return id < SPAN_COUNT ? spanNames[id] : "?";
+}
+
+static const char* resetReasonName(uint32_t reason) {
+  switch (reason) {
+    case REASON_DEFAULT_RST: return "power on";
+    case REASON_WDT_RST: return "hardware watchdog";
+    case REASON_EXCEPTION_RST: return "exception";
+    case REASON_SOFT_WDT_RST: return "software watchdog";
+    case REASON_SOFT_RESTART: return "restart";
+    case REASON_DEEP_SLEEP_AWAKE: return "deep sleep wake";
+    case REASON_EXT_SYS_RST: return "reset pin";
+    default: return "unknown";
+  }
+}
+
+static void logRecords(const char* heading, const StallRecord* records, uint8_t count) {
+  if (count == 0) {
+    return;
+  }
+  LOG_INFO(STALL, "%s (oldest first):", heading);
+  for (uint8_t i = 0; i < count; i++) {
+    LOG_INFO(STALL, "  %6u s  %-9s %4u of %4u ms", records[i].uptimeS, spanNames[records[i].span],
+             records[i].spanMs, records[i].passMs);
+  }
+}
+
+/*
+  Prints the postmortem of the previous reset, followed by the stalls of
+  this boot. Queued through the log, so it is safe to call from loop().
+*/
+void printStallReport() {
+  LOG_INFO(STALL, "Previous reset: %s", resetReasonName(previousReset.reason));
+
+  if (previousReset.reason == REASON_EXCEPTION_RST) {
+    LOG_INFO(STALL, "  exccause %u epc1 0x%08x excvaddr 0x%08x",
+             previousReset.exccause, previousReset.epc1, previousReset.excvaddr);
+  }
+
+  if (previousReset.reason == REASON_WDT_RST || previousReset.reason == REASON_EXCEPTION_RST ||
+      previousReset.reason == REASON_SOFT_WDT_RST) {
+    if (previousCrash & STALL_CRASHED) {
+      uint32_t stuckMs = ((previousCrash & 0xFFFFFF) - previousSpanStartMs) & 0xFFFFFF;
+      LOG_INFO(STALL, "  in %s for %u ms", spanNames[previousSpan], stuckMs);
+    } else {
+      // Hardware watchdog: the crash callback never ran, only the entry time is known
+      LOG_INFO(STALL, "  in %s, entered at %u ms uptime", spanNames[previousSpan], previousSpanStartMs);
+    }
+  }
+  logRecords("Stalls before the reset", previousRecords, previousCount);
+
+  LOG_INFO(STALL, "This boot: %u passes, %u over %u ms, worst %u ms in %s",
+           stallStats.passes, stallStats.stalls, STALL_BUDGET_MS,
+           stallStats.worstPassMs, spanNames[stallStats.worstSpan]);
+
+  StallRecord current[STALL_RECORDS];
+  uint8_t oldest = (rtcBlock.head + STALL_RECORDS - rtcBlock.count) % STALL_RECORDS;
+  for (uint8_t i = 0; i < rtcBlock.count; i++) {
+    current[i] = unpackRecord(rtcBlock.records[(oldest + i) % STALL_RECORDS]);
+  }
+  logRecords("Recent stalls", current, rtcBlock.count);
+}
@@ -0,0 +1,91 @@
+#include <stats.h>
+#include <stats_history.h>
+#include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <heap_monitor.h>
+#include <log.h>
+#include <stall_watchdog.h>
+
+Stats stats;
+
+void loadStats() {
+  StallSpan span(SPAN_FS);
+  HeapScope scope(HEAP_TAG_FS);
+  File file = LittleFS.open("/stats.json", "r");
+  if (!file) {
+    LOG_INFO(STATS, "No existing stats file. Starting fresh.");
+    return;
+  }
+
+  StaticJsonDocument<128> doc;
+  DeserializationError err = deserializeJson(doc, file);
+  file.close();
+
+  if (err) {
+    LOG_ERROR(STATS, "Failed to parse stats.json");
+    return;
+  }
+
+  stats.headpats = doc["headpats"] | 0;
+  stats.missYouPresses = doc["missYouPresses"] | 0;
+  stats.moodSwings = doc["moodSwings"] | 0;
+  stats.messagesReceived = doc["messagesReceived"] | 0;
+  LOG_INFO(STATS, "Loaded from file");
+}
+
+/*
+  Function to save the current stats to a JSON file
+  This function writes the current stats to a file named "stats.json" in LittleFS.
+  It creates the file if it doesn't exist or overwrites it if it does.
+
+  Format:
+  {
+    "headpats": <int>,
+    "missYouPresses": <int>,
+    "moodSwings": <int>,
+    "messagesReceived": <int>
+  }
+*/
+void saveStats() {
+  StallSpan span(SPAN_FS);
+  HeapScope scope(HEAP_TAG_FS);
+  StaticJsonDocument<128> doc;
+  doc["headpats"] = stats.headpats;
+  doc["missYouPresses"] = stats.missYouPresses;
+  doc["moodSwings"] = stats.moodSwings;
+  doc["messagesReceived"] = stats.messagesReceived;
+
+  File file = LittleFS.open("/stats.json", "w");
+  if (!file) {
+    LOG_ERROR(STATS, "Failed to open stats.json for writing");
+    return;
+  }
+
+  serializeJson(doc, file);
+  file.close();
+  LOG_DEBUG(STATS, "Saved to file");
+}
+
+void incrementHeadpats() {
+  stats.headpats++;
+  saveStats();
+  countStatsEvent(STATS_HEADPATS);
+}
+
+void incrementMissYouPresses() {
+  stats.missYouPresses++;
+  saveStats();
+  countStatsEvent(STATS_MISS_YOU);
+}
+
+void incrementMoodSwings() {
+  stats.moodSwings++;
+  saveStats();
+  countStatsEvent(STATS_MOOD_SWINGS);
+}
+
+void incrementMessagesReceived() {
+  stats.messagesReceived++;
+  saveStats();
+  countStatsEvent(STATS_MESSAGES);
+}
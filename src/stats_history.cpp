@@ -0,0 +1,318 @@
+#include <stats_history.h>
+#include <algorithm>
+#include <LittleFS.h>
+#include <config.h>
+#include <trace.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define STATS_HISTORY_MAGIC 0x31545348UL  // "HST1"
+#define STATS_CLOCK_SET 100000            // time() below this has not been set by NTP
+
+struct StatsHistoryHeader {
+  uint32_t magic;
+  uint8_t hourlySlots;
+  uint8_t dailySlots;
+  uint8_t counters;
+  uint8_t reserved;
+  uint32_t hour;  // newest hourly bucket, hours since the epoch in local time; 0 before the first event
+  uint32_t day;   // newest daily bucket
+};
+
+static const StatsHistoryHeader emptyHeader = {
+  STATS_HISTORY_MAGIC, STATS_HOURLY_SLOTS, STATS_DAILY_SLOTS, STATS_COUNTER_COUNT, 0, 0, 0
+};
+
+static StatsHistoryHeader header = emptyHeader;
+static uint16_t pending[STATS_COUNTER_COUNT];  // events before the clock was set
+static uint32_t lastTick = 0;
+
+uint32_t statsHistoryVersion = 0;
+
+static const char* const counterNames[STATS_COUNTER_COUNT] = {
+  "Headpats", "Missed him", "Mood swings", "Love notes"
+};
+
+static uint8_t slotCount(StatsResolution resolution) {
+  return resolution == STATS_HOURLY ? STATS_HOURLY_SLOTS : STATS_DAILY_SLOTS;
+}
+
+static uint32_t seriesOffset(StatsCounter counter, StatsResolution resolution) {
+  uint32_t offset = sizeof(StatsHistoryHeader) + counter * (STATS_HOURLY_SLOTS + STATS_DAILY_SLOTS) * sizeof(uint16_t);
+  return resolution == STATS_HOURLY ? offset : offset + STATS_HOURLY_SLOTS * sizeof(uint16_t);
+}
+
+static uint32_t slotOffset(StatsCounter counter, StatsResolution resolution, uint32_t bucket) {
+  return seriesOffset(counter, resolution) + (bucket % slotCount(resolution)) * sizeof(uint16_t);
+}
+
+static uint32_t newestBucket(StatsResolution resolution) {
+  return resolution == STATS_HOURLY ? header.hour : header.day;
+}
+
+// Bucket the clock is in now, or 0 while it has not been set
+static uint32_t currentBucket(StatsResolution resolution) {
+  time_t now = traceTime();
+  if (now < STATS_CLOCK_SET) {
+    return 0;
+  }
+  uint32_t local = now + config.utcOffsetSeconds;
+  return resolution == STATS_HOURLY ? local / 3600 : local / 86400;
+}
+
+static bool writeHeader(File& file) {
+  return file.seek(0) && file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+}
+
+static bool createHistory() {
+  File file = LittleFS.open(STATS_HISTORY_PATH, "w");
+  if (!file) {
+    LOG_ERROR(STATS, "Failed to create %s", STATS_HISTORY_PATH);
+    return false;
+  }
+  header = emptyHeader;
+  static const uint8_t zeros[64] = {};
+  size_t left = STATS_COUNTER_COUNT * (STATS_HOURLY_SLOTS + STATS_DAILY_SLOTS) * sizeof(uint16_t);
+  bool ok = writeHeader(file);
+  while (ok && left > 0) {
+    size_t chunk = min(left, sizeof(zeros));
+    ok = file.write(zeros, chunk) == chunk;
+    left -= chunk;
+  }
+  file.close();
+  return ok;
+}
+
+/*
+  Reads the header. A history that is missing, or was written with other
+  slot counts or counters, starts over empty.
+*/
+void loadStatsHistory() {
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(STATS_HISTORY_PATH, "r");
+  if (file) {
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && header.magic == emptyHeader.magic &&
+              header.hourlySlots == STATS_HOURLY_SLOTS && header.dailySlots == STATS_DAILY_SLOTS &&
+              header.counters == STATS_COUNTER_COUNT;
+    file.close();
+    if (ok) {
+      LOG_INFO(STATS, "History up to hour %u, day %u", header.hour, header.day);
+      return;
+    }
+    LOG_ERROR(STATS, "Failed to parse %s, starting empty", STATS_HISTORY_PATH);
+  } else {
+    LOG_INFO(STATS, "No stats history. Starting fresh.");
+  }
+  createHistory();
+}
+
+static void zeroSlots(File& file, StatsResolution resolution, uint32_t from, uint32_t to) {
+  const uint16_t zero = 0;
+  for (uint8_t c = 0; c < STATS_COUNTER_COUNT; c++) {
+    for (uint32_t bucket = from; bucket <= to; bucket++) {
+      file.seek(slotOffset((StatsCounter)c, resolution, bucket));
+      file.write((const uint8_t*)&zero, sizeof(zero));
+    }
+  }
+}
+
+/*
+  Moves the newest buckets up to the clock, zeroing the slots in between.
+  The clock going back (an NTP correction) keeps counting into the newest
+  bucket rather than rewriting older ones.
+*/
+static void advance(File& file, uint32_t hour, uint32_t day) {
+  if (hour <= header.hour && day <= header.day) {
+    return;
+  }
+  if (header.hour != 0) {
+    if (hour > header.hour) {
+      zeroSlots(file, STATS_HOURLY, max(header.hour + 1, hour - STATS_HOURLY_SLOTS + 1), hour);
+    }
+    if (day > header.day) {
+      zeroSlots(file, STATS_DAILY, max(header.day + 1, day - STATS_DAILY_SLOTS + 1), day);
+    }
+  }
+  header.hour = max(header.hour, hour);
+  header.day = max(header.day, day);
+  writeHeader(file);
+  statsHistoryVersion++;
+}
+
+static void addToSlot(File& file, StatsCounter counter, StatsResolution resolution, uint16_t count) {
+  uint32_t offset = slotOffset(counter, resolution, newestBucket(resolution));
+  uint16_t value = 0;
+  file.seek(offset);
+  file.read((uint8_t*)&value, sizeof(value));
+  value = min<uint32_t>((uint32_t)value + count, UINT16_MAX);
+  file.seek(offset);
+  file.write((const uint8_t*)&value, sizeof(value));
+}
+
+// Opens the history with its newest buckets at the clock, which must be set
+static File openCurrent() {
+  File file = LittleFS.open(STATS_HISTORY_PATH, "r+");
+  if (!file && createHistory()) {
+    file = LittleFS.open(STATS_HISTORY_PATH, "r+");
+  }
+  if (!file) {
+    LOG_ERROR(STATS, "Failed to open %s", STATS_HISTORY_PATH);
+    return file;
+  }
+  advance(file, currentBucket(STATS_HOURLY), currentBucket(STATS_DAILY));
+
+  for (uint8_t c = 0; c < STATS_COUNTER_COUNT; c++) {
+    if (pending[c] > 0) {
+      addToSlot(file, (StatsCounter)c, STATS_HOURLY, pending[c]);
+      addToSlot(file, (StatsCounter)c, STATS_DAILY, pending[c]);
+      pending[c] = 0;
+    }
+  }
+  return file;
+}
+
+// Counts one event in the current hour and day
+void countStatsEvent(StatsCounter counter) {
+  if (currentBucket(STATS_HOURLY) == 0) {
+    pending[counter] = min<uint32_t>(pending[counter] + 1, UINT16_MAX);
+    return;
+  }
+
+  StallSpan span(SPAN_FS);
+  File file = openCurrent();
+  if (!file) {
+    return;
+  }
+  addToSlot(file, counter, STATS_HOURLY, 1);
+  addToSlot(file, counter, STATS_DAILY, 1);
+  file.close();
+  statsHistoryVersion++;
+}
+
+/*
+  Rolls the history over when the hour changes, so charts move on without
+  new events, and stores what was counted before the clock was set.
+  Touches flash only when there is something to write.
+*/
+void statsHistoryTick() {
+  uint32_t now = traceMillis();
+  if (now - lastTick < STATS_HISTORY_TICK_MS) {
+    return;
+  }
+  lastTick = now;
+
+  uint32_t hour = currentBucket(STATS_HOURLY);
+  if (hour == 0) {
+    return;
+  }
+  bool held = false;
+  for (uint16_t count : pending) {
+    held |= count > 0;
+  }
+  if (hour <= header.hour && !held) {
+    return;
+  }
+
+  StallSpan span(SPAN_FS);
+  File file = openCurrent();
+  if (file) {
+    file.close();
+    statsHistoryVersion++;
+  }
+}
+
+/*
+  Reads one series into values, oldest bucket first, and returns its
+  length (STATS_HOURLY_SLOTS or STATS_DAILY_SLOTS). Buckets the clock has
+  moved past since the last write read as 0; values must hold the length.
+*/
+uint8_t readStatsSeries(StatsCounter counter, StatsResolution resolution, uint16_t* values) {
+  uint8_t length = slotCount(resolution);
+  memset(values, 0, length * sizeof(uint16_t));
+
+  uint32_t newest = newestBucket(resolution);
+  uint32_t now = currentBucket(resolution);
+  uint32_t stale = now > newest ? now - newest : 0;
+  if (newest == 0 || stale >= length) {
+    return length;
+  }
+
+  StallSpan span(SPAN_FS);
+  File file = LittleFS.open(STATS_HISTORY_PATH, "r");
+  if (!file || !file.seek(seriesOffset(counter, resolution)) ||
+      file.read((uint8_t*)values, length * sizeof(uint16_t)) != (int)(length * sizeof(uint16_t))) {
+    memset(values, 0, length * sizeof(uint16_t));
+    return length;
+  }
+  file.close();
+
+  // Slots are in ring order, the oldest bucket follows the newest
+  std::rotate(values, values + (newest + 1) % length, values + length);
+  if (stale > 0) {
+    memmove(values, values + stale, (length - stale) * sizeof(uint16_t));
+    memset(values + length - stale, 0, stale * sizeof(uint16_t));
+  }
+  return length;
+}
+
+/*
+  Bucket of the last value readStatsSeries() returns: the one the clock is
+  in, or the newest written while the clock is not set. 0 without history.
+*/
+uint32_t newestStatsBucket(StatsResolution resolution) {
+  if (header.hour == 0) {
+    return 0;
+  }
+  return max(currentBucket(resolution), newestBucket(resolution));
+}
+
+static uint32_t sumNewest(const uint16_t* values, uint8_t length, uint8_t count) {
+  uint32_t sum = 0;
+  for (uint8_t i = length - count; i < length; i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+/*
+  Per counter: totals over the last day, week and STATS_DAILY_SLOTS days,
+  and the hour of day with the most events in the last STATS_HOURLY_SLOTS
+  hours. Reads one series at a time.
+*/
+void printStatsHistoryReport() {
+  if (header.hour == 0) {
+    LOG_INFO(STATS, "No history yet%s", currentBucket(STATS_HOURLY) == 0 ? ", the clock is not set" : "");
+    return;
+  }
+  uint32_t hour = newestStatsBucket(STATS_HOURLY);
+  uint16_t values[STATS_DAILY_SLOTS];
+
+  for (uint8_t c = 0; c < STATS_COUNTER_COUNT; c++) {
+    StatsCounter counter = (StatsCounter)c;
+    readStatsSeries(counter, STATS_HOURLY, values);
+    uint32_t lastDay = sumNewest(values, STATS_HOURLY_SLOTS, 24);
+    uint16_t byHourOfDay[24] = {};
+    for (uint8_t i = 0; i < STATS_HOURLY_SLOTS; i++) {
+      uint32_t bucket = hour - (STATS_HOURLY_SLOTS - 1 - i);
+      byHourOfDay[bucket % 24] += values[i];
+    }
+    uint8_t peak = 0;
+    for (uint8_t h = 1; h < 24; h++) {
+      if (byHourOfDay[h] > byHourOfDay[peak]) {
+        peak = h;
+      }
+    }
+
+    readStatsSeries(counter, STATS_DAILY, values);
+    uint32_t lastWeek = sumNewest(values, STATS_DAILY_SLOTS, 7);
+    uint32_t all = sumNewest(values, STATS_DAILY_SLOTS, STATS_DAILY_SLOTS);
+
+    if (byHourOfDay[peak] == 0) {
+      LOG_INFO(STATS, "%s: %u in 24 h, %u in 7 days, %u in %u days", counterNames[c], lastDay, lastWeek, all,
+               STATS_DAILY_SLOTS);
+    } else {
+      LOG_INFO(STATS, "%s: %u in 24 h, %u in 7 days, %u in %u days, most around %02u:00", counterNames[c], lastDay,
+               lastWeek, all, STATS_DAILY_SLOTS, peak);
+    }
+  }
+}
@@ -0,0 +1,259 @@
+#include <stream_player.h>
+#include <binary_protocol.h>
+#include <buffered_display.h>
+#include <image_message.h>
+#include <widgets.h>
+#include <animation.h>
+#include <trace.h>
+#include <WebSocketsClient.h>
+#include <log.h>
+
+extern BufferedDisplay display;
+extern WebSocketsClient webSocket;
+
+struct StreamEntry {
+  uint16_t offset;  // into queued[]
+  uint16_t length;
+  uint16_t durationMs;
+  uint8_t flags;
+};
+
+StreamStats streamStats;
+
+static uint8_t canvas[DISPLAY_BUFFER_SIZE];  // the stream's current frame, deltas apply here
+static uint8_t queued[STREAM_BUFFER_SIZE];
+static StreamEntry entries[STREAM_QUEUE_FRAMES];
+static uint8_t firstEntry = 0;
+static uint8_t entryCount = 0;
+
+static bool playing = false;
+static bool started = false;       // prebuffering is over
+static bool ended = false;         // STREAM_END was queued
+static bool synced = false;        // the next delta can be applied
+static uint8_t streamId = 0;
+static uint16_t nextFrame = 0;
+static uint32_t firstArrival = 0;
+static uint32_t lastArrival = 0;
+static uint32_t deadline = 0;      // when the oldest queued frame is due
+static uint32_t lastKeyframeRequest = 0;
+
+static void requestKeyframe() {
+  uint32_t now = traceMillis();
+  if (now - lastKeyframeRequest < STREAM_KEYFRAME_RETRY_MS || !webSocket.isConnected()) {
+    return;
+  }
+  lastKeyframeRequest = now;
+
+  char request[48];
+  snprintf(request, sizeof(request), "{\"type\": \"keyframe\", \"stream\": %u}", streamId);
+  webSocket.sendTXT(request);
+}
+
+static bool applyDelta(const uint8_t* data, size_t length) {
+  size_t in = 0;
+  size_t out = 0;
+  while (in + 2 <= length) {
+    out += data[in++];
+    uint8_t count = data[in++];
+    if (out + count > DISPLAY_BUFFER_SIZE || in + count > length) {
+      return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      canvas[out++] ^= data[in++];
+    }
+  }
+  return in == length;
+}
+
+// Decodes the oldest queued frame into the canvas and removes it from the queue
+static void decodeOldest() {
+  StreamEntry& entry = entries[firstEntry];
+  uint32_t start = micros();
+
+  bool ok;
+  if (entry.flags & BINARY_FLAG_KEYFRAME) {
+    ok = unpackImage(queued + entry.offset, entry.length, entry.flags & BINARY_FLAG_PACKBITS, canvas);
+  } else {
+    ok = applyDelta(queued + entry.offset, entry.length);
+  }
+  if (!ok) {
+    // The canvas is now off; everything up to the next keyframe builds on it
+    LOG_WARN(STREAM, "Undecodable frame, waiting for a keyframe");
+    streamStats.framesRejected++;
+    synced = false;
+    requestKeyframe();
+  }
+
+  uint32_t took = micros() - start;
+  if (took > streamStats.maxDecodeUs) {
+    streamStats.maxDecodeUs = took;
+  }
+
+  deadline += entry.durationMs;
+  firstEntry = (firstEntry + 1) % STREAM_QUEUE_FRAMES;
+  entryCount--;
+}
+
+// Makes room for length bytes at the end of queued[]; returns its offset
+static uint16_t reserve(size_t length) {
+  if (entryCount == 0) {
+    return 0;
+  }
+
+  const StreamEntry& first = entries[firstEntry];
+  const StreamEntry& last = entries[(firstEntry + entryCount - 1) % STREAM_QUEUE_FRAMES];
+  uint16_t end = last.offset + last.length;
+  if (end + length <= STREAM_BUFFER_SIZE) {
+    return end;
+  }
+
+  // Slide the queue to the front of the buffer
+  uint16_t shift = first.offset;
+  memmove(queued, queued + shift, end - shift);
+  for (uint8_t i = 0; i < entryCount; i++) {
+    entries[(firstEntry + i) % STREAM_QUEUE_FRAMES].offset -= shift;
+  }
+  return end - shift;
+}
+
+static void beginStream(uint8_t id) {
+  stopAnimation();
+  hideScreen();
+  memset(canvas, 0, sizeof(canvas));
+  memset(&streamStats, 0, sizeof(streamStats));
+  firstEntry = 0;
+  entryCount = 0;
+  playing = true;
+  started = false;
+  ended = false;
+  synced = false;
+  streamId = id;
+  firstArrival = traceMillis();
+  LOG_INFO(STREAM, "Stream %u started", id);
+}
+
+/*
+  Queues one BINARY_STREAM frame (payload after the two byte binary
+  header). Starts playback when no stream is playing.
+*/
+void queueStreamFrame(uint8_t flags, const uint8_t* payload, size_t length) {
+  if (length < STREAM_FRAME_HEADER_SIZE) {
+    LOG_ERROR(STREAM, "Stream frame too short");
+    return;
+  }
+  uint8_t id = payload[0];
+  uint16_t frame = readLe16(payload + 1);
+  uint16_t durationMs = readLe16(payload + 3);
+  payload += STREAM_FRAME_HEADER_SIZE;
+  length -= STREAM_FRAME_HEADER_SIZE;
+
+  if (!playing || id != streamId) {
+    beginStream(id);
+  }
+  uint32_t now = traceMillis();
+  lastArrival = now;
+  streamStats.framesReceived++;
+  streamStats.bytesReceived += length + STREAM_FRAME_HEADER_SIZE;
+
+  bool keyframe = flags & BINARY_FLAG_KEYFRAME;
+  if (!keyframe && (!synced || frame != nextFrame)) {
+    streamStats.framesRejected++;
+    synced = false;
+    requestKeyframe();
+    return;
+  }
+  if (length > STREAM_BUFFER_SIZE) {
+    LOG_ERROR(STREAM, "Frame %u too large to queue", frame);
+    streamStats.framesRejected++;
+    synced = false;
+    requestKeyframe();
+    return;
+  }
+  synced = true;
+  nextFrame = frame + 1;
+  if (flags & BINARY_FLAG_STREAM_END) {
+    ended = true;
+  }
+
+  // Behind by a whole buffer: decode (but never show) the backlog and jump to this frame
+  if (entryCount == STREAM_QUEUE_FRAMES || reserve(length) + length > STREAM_BUFFER_SIZE) {
+    while (entryCount > 0) {
+      decodeOldest();
+      streamStats.framesDropped++;
+    }
+    deadline = now;
+  }
+  if (entryCount == 0 && started && (int32_t)(now - deadline) > 0) {
+    deadline = now;  // the queue ran dry; restart the clock rather than rush to catch up
+  }
+
+  uint16_t offset = reserve(length);
+  memcpy(queued + offset, payload, length);
+  StreamEntry& entry = entries[(firstEntry + entryCount) % STREAM_QUEUE_FRAMES];
+  entry.offset = offset;
+  entry.length = length;
+  entry.durationMs = durationMs;
+  entry.flags = flags;
+  entryCount++;
+  if (entryCount > streamStats.maxQueued) {
+    streamStats.maxQueued = entryCount;
+  }
+}
+
+/*
+  Shows the newest due frame of the running stream; call once per loop()
+  pass. Returns false once the stream has ended (or if none is playing).
+*/
+bool streamTick() {
+  if (!playing) {
+    return false;
+  }
+  uint32_t now = traceMillis();
+
+  if (!started) {
+    if (entryCount == 0 || (now - firstArrival < STREAM_PREBUFFER_MS && !ended)) {
+      return true;
+    }
+    started = true;
+    deadline = now;
+  }
+
+  bool due = false;
+  while (entryCount > 0 && (int32_t)(now - deadline) >= 0) {
+    if (due) {
+      streamStats.framesDropped++;  // the frame decoded before this one is never shown
+    }
+    decodeOldest();
+    due = true;
+  }
+  if (due) {
+    memcpy(display.getBuffer(), canvas, DISPLAY_BUFFER_SIZE);
+    display.display();
+    streamStats.framesShown++;
+  }
+
+  if (entryCount == 0 && (ended || now - lastArrival > STREAM_IDLE_TIMEOUT_MS)) {
+    playing = false;
+    printStreamReport();
+    return false;
+  }
+  return true;
+}
+
+bool isStreamPlaying() {
+  return playing;
+}
+
+// Drops the running stream, e.g. when a message or a mode change takes the screen
+void stopStream() {
+  playing = false;
+  entryCount = 0;
+}
+
+void printStreamReport() {
+  LOG_INFO(STREAM, "Stream %u: %u frames received, %u shown, %u dropped, %u rejected",
+           streamId, streamStats.framesReceived, streamStats.framesShown,
+           streamStats.framesDropped, streamStats.framesRejected);
+  LOG_INFO(STREAM, "  %u bytes, queue peak %u, slowest decode %u us",
+           streamStats.bytesReceived, streamStats.maxQueued, streamStats.maxDecodeUs);
+}
@@ -0,0 +1,443 @@
+#include <trace.h>
+#include <config.h>
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <WebSocketsClient.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+#define TRACE_MAGIC "TRC1"
+#define TRACE_CLOCK_SLACK_S 2  // smaller clock moves are millis() rounding, not NTP
+#define TRACE_END_BYTES 6  // kept free for the end record
+#define TRACE_CLOCK_SET 100000  // time() below this has not been set by NTP and stands still
+
+static bool recording = false;
+static File traceFile;
+static uint8_t buffer[TRACE_BUFFER_SIZE];
+static size_t buffered = 0;
+static uint32_t traceBytes = 0;     // written plus buffered
+static uint32_t traceRecords = 0;
+static uint32_t droppedFrames = 0;
+static uint32_t lastRecordAt = 0;   // millis() of the previous record
+static uint32_t lastFlush = 0;
+
+// Last recorded (on replay, last replayed) value of each input
+static uint32_t gpioKnown = 0;      // bit per pin
+static uint32_t gpioLevels = 0;
+static uint8_t wifiStatus = 0xFF;   // none yet
+static bool clockKnown = false;
+static time_t clockBase = 0;
+static uint32_t clockBaseAt = 0;    // millis() when clockBase was read
+
+static bool replaying = false;
+static uint32_t virtualNow = 0;
+
+static void flushTrace() {
+  if (buffered == 0) {
+    return;
+  }
+  StallSpan span(SPAN_FS);
+  size_t length = buffered;
+  buffered = 0;
+  lastFlush = millis();
+  if (recording && traceFile.write(buffer, length) != length) {
+    LOG_ERROR(TRACE, "Write failed, recording stopped");
+    recording = false;
+    traceFile.close();
+  }
+}
+
+static void put(const uint8_t* data, size_t length) {
+  traceBytes += length;
+  while (length > 0) {
+    if (buffered == sizeof(buffer)) {
+      flushTrace();
+    }
+    size_t n = min(length, sizeof(buffer) - buffered);
+    memcpy(buffer + buffered, data, n);
+    buffered += n;
+    data += n;
+    length -= n;
+  }
+}
+
+static void putByte(uint8_t value) {
+  put(&value, 1);
+}
+
+static void putVarint(uint32_t value) {
+  while (value >= 0x80) {
+    putByte((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  putByte(value);
+}
+
+static void putLe32(uint32_t value) {
+  uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+  put(bytes, sizeof(bytes));
+}
+
+/*
+  Writes a record's type and time delta; the caller writes at most
+  payloadBytes more. False, and recording stops, if the trace would grow
+  past TRACE_MAX_BYTES.
+*/
+static bool beginRecord(TraceRecordType type, size_t payloadBytes) {
+  if (!recording) {
+    return false;
+  }
+  size_t limit = type == TRACE_END ? TRACE_MAX_BYTES : TRACE_MAX_BYTES - TRACE_END_BYTES;
+  if (traceBytes + 1 + 5 + payloadBytes > limit) {
+    LOG_WARN(TRACE, "Trace is full at %u bytes", traceBytes);
+    stopTraceRecording();
+    return false;
+  }
+  uint32_t now = millis();
+  putByte(type);
+  putVarint(now - lastRecordAt);
+  lastRecordAt = now;
+  traceRecords++;
+  return true;
+}
+
+/*
+  Starts a new trace, replacing the last one. random() is reseeded with a
+  seed the trace keeps, so a replay draws the same numbers.
+*/
+void startTraceRecording() {
+  if (recording || replaying) {
+    return;
+  }
+  traceFile = LittleFS.open(TRACE_PATH, "w");
+  if (!traceFile) {
+    LOG_ERROR(TRACE, "Failed to open %s for writing", TRACE_PATH);
+    return;
+  }
+  recording = true;
+  buffered = 0;
+  traceBytes = 0;
+  traceRecords = 0;
+  droppedFrames = 0;
+  gpioKnown = 0;
+  wifiStatus = 0xFF;
+  clockKnown = false;
+  put((const uint8_t*)TRACE_MAGIC, 4);
+
+  uint32_t seed = ESP.random();
+  randomSeed(seed);
+  lastRecordAt = millis();
+  lastFlush = lastRecordAt;
+  beginRecord(TRACE_START, 12);
+  putLe32(seed);
+  putLe32((uint32_t)time(nullptr));
+  putLe32(lastRecordAt);
+  LOG_INFO(TRACE, "Recording to %s", TRACE_PATH);
+}
+
+void stopTraceRecording() {
+  if (!recording) {
+    return;
+  }
+  beginRecord(TRACE_END, 0);  // replay runs until here
+  flushTrace();
+  recording = false;
+  traceFile.close();
+  LOG_INFO(TRACE, "Recorded %u records, %u bytes", traceRecords, traceBytes);
+}
+
+bool isTraceRecording() {
+  return recording;
+}
+
+// Writes buffered records now and then, so a crash loses at most TRACE_FLUSH_MS. Call once per loop() pass.
+void traceTick() {
+  if (recording && buffered > 0 && millis() - lastFlush >= TRACE_FLUSH_MS) {
+    flushTrace();
+  }
+}
+
+uint32_t traceMillis() {
+  return replaying ? virtualNow : millis();
+}
+
+int traceDigitalRead(uint8_t pin) {
+  uint32_t bit = 1UL << pin;
+  if (replaying) {
+    return (gpioKnown & bit) ? (gpioLevels & bit ? HIGH : LOW) : digitalRead(pin);
+  }
+  int level = digitalRead(pin);
+  if (recording && (!(gpioKnown & bit) || ((gpioLevels & bit) != 0) != (level == HIGH))) {
+    gpioKnown |= bit;
+    gpioLevels = level == HIGH ? gpioLevels | bit : gpioLevels & ~bit;
+    if (beginRecord(TRACE_GPIO, 2)) {
+      putByte(pin);
+      putByte(level);
+    }
+  }
+  return level;
+}
+
+uint8_t traceWifiStatus() {
+  if (replaying) {
+    return wifiStatus == 0xFF ? (uint8_t)WL_DISCONNECTED : wifiStatus;
+  }
+  uint8_t status = WiFi.status();
+  if (recording && status != wifiStatus) {
+    wifiStatus = status;
+    if (beginRecord(TRACE_WIFI, 1)) {
+      putByte(status);
+    }
+  }
+  return status;
+}
+
+// time(), recorded when it jumps rather than every second: replay derives it from the virtual clock
+time_t traceTime() {
+  if (replaying) {
+    if (!clockKnown || clockBase < TRACE_CLOCK_SET) {
+      return clockKnown ? clockBase : 0;
+    }
+    return clockBase + (virtualNow - clockBaseAt) / 1000;
+  }
+  time_t now = time(nullptr);
+  if (recording) {
+    uint32_t at = millis();
+    time_t expected = clockBase < TRACE_CLOCK_SET ? clockBase : clockBase + (at - clockBaseAt) / 1000;
+    if (!clockKnown || now > expected + TRACE_CLOCK_SLACK_S || now < expected - TRACE_CLOCK_SLACK_S) {
+      clockKnown = true;
+      clockBase = now;
+      clockBaseAt = at;
+      if (beginRecord(TRACE_CLOCK, 4)) {
+        putLe32((uint32_t)now);
+      }
+    }
+  }
+  return now;
+}
+
+// getLocalTime() on traceTime(), with the configured UTC offset
+bool traceLocalTime(struct tm* info) {
+  time_t now = traceTime();
+  if (now < TRACE_CLOCK_SET) {
+    return false;  // the clock has not been set yet
+  }
+  now += config.utcOffsetSeconds;
+  gmtime_r(&now, info);
+  return true;
+}
+
+void traceWebSocketEvent(uint8_t type, const uint8_t* payload, size_t length) {
+  if (!recording) {
+    return;
+  }
+  if (type == WStype_CONNECTED || type == WStype_DISCONNECTED) {
+    if (beginRecord(TRACE_WS_EVENT, 1)) {
+      putByte(type);
+    }
+  } else if (type == WStype_TEXT || type == WStype_BIN) {
+    if (length > TRACE_FRAME_MAX) {
+      droppedFrames++;
+      if (beginRecord(TRACE_WS_DROPPED, 6)) {
+        putByte(type);
+        putVarint(length);
+      }
+    } else if (beginRecord(type == WStype_TEXT ? TRACE_WS_TEXT : TRACE_WS_BINARY, 5 + length)) {
+      putVarint(length);
+      put(payload, length);
+    }
+  }
+}
+
+void traceSerialCommand(char command) {
+  if (beginRecord(TRACE_SERIAL, 1)) {
+    putByte(command);
+  }
+}
+
+bool isTraceReplaying() {
+  return replaying;
+}
+
+void printTraceReport() {
+  if (recording) {
+    LOG_INFO(TRACE, "Recording: %u records, %u of %u bytes, %u frames too big to keep", traceRecords,
+             traceBytes, TRACE_MAX_BYTES, droppedFrames);
+  } else if (replaying) {
+    LOG_INFO(TRACE, "Replaying: %u records, virtual clock at %u ms", traceRecords, virtualNow);
+  } else {
+    LOG_INFO(TRACE, "Idle, last trace %u records, %u bytes", traceRecords, traceBytes);
+  }
+}
+
+#ifdef LOVEBOX_REPLAY
+static File replayFile;
+static uint8_t frame[TRACE_FRAME_MAX + 1];
+static bool haveNext = false;
+static uint8_t nextType = 0;
+static uint32_t nextAt = 0;  // virtual time of the next record
+
+static bool readVarint(uint32_t& value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    int c = replayFile.read();
+    if (c < 0) {
+      return false;
+    }
+    value |= (uint32_t)(c & 0x7F) << shift;
+    if (!(c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool readTraceLe32(uint32_t& value) {
+  uint8_t bytes[4];
+  if (replayFile.read(bytes, 4) != 4) {
+    return false;
+  }
+  value = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+  return true;
+}
+
+// Reads the next record's type and time; the payload is read when it is due
+static void readNextHeader() {
+  int type = replayFile.read();
+  uint32_t delta;
+  haveNext = type >= 0 && readVarint(delta);
+  if (haveNext) {
+    nextType = type;
+    nextAt += delta;
+  }
+}
+
+/*
+  Opens TRACE_PATH and starts the virtual clock where the recording
+  started. Call in setup() in place of connecting.
+*/
+bool beginTraceReplay() {
+  replayFile = LittleFS.open(TRACE_PATH, "r");
+  char magic[4];
+  if (!replayFile || replayFile.read((uint8_t*)magic, 4) != 4 || memcmp(magic, TRACE_MAGIC, 4) != 0) {
+    LOG_ERROR(TRACE, "No trace to replay in %s", TRACE_PATH);
+    replayFile.close();
+    return false;
+  }
+  uint32_t seed, clock, startedAt;
+  readNextHeader();
+  if (!haveNext || nextType != TRACE_START || !readTraceLe32(seed) || !readTraceLe32(clock) || !readTraceLe32(startedAt)) {
+    LOG_ERROR(TRACE, "%s does not start with a start record", TRACE_PATH);
+    replayFile.close();
+    return false;
+  }
+  randomSeed(seed);
+  virtualNow = startedAt;
+  nextAt = startedAt;
+  gpioKnown = 0;
+  wifiStatus = 0xFF;
+  clockKnown = false;
+  traceRecords = 1;
+  replaying = true;
+  readNextHeader();
+  LOG_INFO(TRACE, "Replaying %s, %u bytes", TRACE_PATH, (unsigned)replayFile.size());
+  return true;
+}
+
+static bool replayFrame(uint8_t type, TraceFrameHandler onFrame) {
+  uint32_t length;
+  if (!readVarint(length) || length > TRACE_FRAME_MAX || replayFile.read(frame, length) != (int)length) {
+    return false;
+  }
+  frame[length] = '\0';  // as the WebSocket library delivers text
+  onFrame(type, frame, length);
+  return true;
+}
+
+static bool replayRecord(TraceFrameHandler onFrame, TraceCommandHandler onCommand) {
+  int a, b;
+  uint32_t value;
+  switch (nextType) {
+    case TRACE_GPIO:
+      a = replayFile.read();
+      b = replayFile.read();
+      if (a < 0 || b < 0 || a >= 32) {
+        return false;
+      }
+      gpioKnown |= 1UL << a;
+      gpioLevels = b == HIGH ? gpioLevels | 1UL << a : gpioLevels & ~(1UL << a);
+      return true;
+    case TRACE_WIFI:
+      a = replayFile.read();
+      wifiStatus = a;
+      return a >= 0;
+    case TRACE_CLOCK:
+      if (!readTraceLe32(value)) {
+        return false;
+      }
+      clockKnown = true;
+      clockBase = value;
+      clockBaseAt = virtualNow;
+      return true;
+    case TRACE_WS_EVENT:
+      a = replayFile.read();
+      if (a < 0) {
+        return false;
+      }
+      onFrame(a, nullptr, 0);
+      return true;
+    case TRACE_WS_TEXT:
+      return replayFrame(WStype_TEXT, onFrame);
+    case TRACE_WS_BINARY:
+      return replayFrame(WStype_BIN, onFrame);
+    case TRACE_SERIAL:
+      a = replayFile.read();
+      if (a < 0) {
+        return false;
+      }
+      onCommand(a);
+      return true;
+    case TRACE_WS_DROPPED:
+      a = replayFile.read();
+      if (a < 0 || !readVarint(value)) {
+        return false;
+      }
+      LOG_WARN(TRACE, "Skipping a %u byte frame the trace did not keep", value);
+      return true;
+    case TRACE_END:
+      haveNext = false;
+      return true;
+    default:
+      LOG_ERROR(TRACE, "Unknown record type %u", nextType);
+      return false;
+  }
+}
+
+/*
+  Advances the virtual clock by one step and plays the records that are
+  due. Call at the top of loop(); false once the trace has ended.
+*/
+bool traceReplayTick(TraceFrameHandler onFrame, TraceCommandHandler onCommand) {
+  if (!replaying) {
+    return false;
+  }
+  virtualNow += TRACE_REPLAY_STEP_MS;
+  while (haveNext && (int32_t)(nextAt - virtualNow) <= 0) {
+    if (!replayRecord(onFrame, onCommand)) {
+      LOG_ERROR(TRACE, "Trace is damaged after %u records", traceRecords);
+      haveNext = false;
+      break;
+    }
+    traceRecords++;
+    if (haveNext) {
+      readNextHeader();
+    }
+  }
+  if (!haveNext) {
+    replaying = false;
+    replayFile.close();
+    LOG_INFO(TRACE, "Replay finished, %u records", traceRecords);
+  }
+  return replaying;
+}
+#endif
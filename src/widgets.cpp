@@ -0,0 +1,179 @@
+#include <widgets.h>
+#include <buffered_display.h>
+
+extern BufferedDisplay display;
+
+ScreenStats screenStats;
+
+static const Screen* active = nullptr;
+
+void FrameWidget::draw(Adafruit_GFX& gfx) {
+  gfx.drawRect(x, y, w, h, SSD1306_WHITE);
+  if (cornerDotRadius > 0) {
+    gfx.fillCircle(x, y, cornerDotRadius, SSD1306_WHITE);
+    gfx.fillCircle(x + w - 1, y, cornerDotRadius, SSD1306_WHITE);
+    gfx.fillCircle(x, y + h - 1, cornerDotRadius, SSD1306_WHITE);
+    gfx.fillCircle(x + w - 1, y + h - 1, cornerDotRadius, SSD1306_WHITE);
+  }
+}
+
+void LineWidget::draw(Adafruit_GFX& gfx) {
+  gfx.drawLine(x, y, x + w, y + h, SSD1306_WHITE);
+}
+
+void LabelWidget::draw(Adafruit_GFX& gfx) {
+  gfx.setTextSize(size);
+  gfx.setCursor(x, y);
+  gfx.print(text);
+}
+
+void BitmapWidget::draw(Adafruit_GFX& gfx) {
+  gfx.drawBitmap(x, y, bitmap, w, h, SSD1306_WHITE);
+}
+
+bool NumberWidget::changed() {
+  return !drawn || *value != shown;
+}
+
+void NumberWidget::draw(Adafruit_GFX& gfx) {
+  shown = *value;
+  drawn = true;
+  gfx.setTextSize(1);
+  gfx.setCursor(x, y);
+  gfx.print(prefix);
+  gfx.print(shown);
+}
+
+bool TextWidget::changed() {
+  char next[TEXT_WIDGET_MAX_CHARS];
+  format(next, sizeof(next));
+  if (drawn && strcmp(next, text) == 0) {
+    return false;
+  }
+  memcpy(text, next, sizeof(text));
+  return true;
+}
+
+void TextWidget::draw(Adafruit_GFX& gfx) {
+  drawn = true;
+  gfx.setTextSize(1);
+  gfx.setCursor(x, y);
+  gfx.print(text);
+}
+
+bool ChartWidget::changed() {
+  return !drawn || *version != shown;
+}
+
+void ChartWidget::draw(Adafruit_GFX& gfx) {
+  shown = *version;
+  drawn = true;
+  uint16_t values[CHART_WIDGET_MAX_POINTS];
+  uint8_t count = read(series, values);
+  if (count == 0) {
+    return;
+  }
+  if (style == SPARKLINE) {
+    drawSparkline(gfx, values, count);
+  } else {
+    drawBars(gfx, values, count);
+  }
+}
+
+// One point per column where the width allows, a flat baseline without data
+void ChartWidget::drawSparkline(Adafruit_GFX& gfx, const uint16_t* values, uint8_t count) {
+  uint16_t top = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    top = max(top, values[i]);
+  }
+  int16_t bottom = y + h - 1;
+  int16_t lastX = x;
+  int16_t lastY = top ? bottom - (int32_t)values[0] * (h - 1) / top : bottom;
+  for (uint8_t i = 1; i < count; i++) {
+    int16_t px = x + (int32_t)i * (w - 1) / (count - 1);
+    int16_t py = top ? bottom - (int32_t)values[i] * (h - 1) / top : bottom;
+    gfx.drawLine(lastX, lastY, px, py, SSD1306_WHITE);
+    lastX = px;
+    lastY = py;
+  }
+}
+
+// Bars one pixel apart; any nonzero bar is at least one pixel high
+void ChartWidget::drawBars(Adafruit_GFX& gfx, const uint16_t* values, uint8_t count) {
+  uint8_t bars = (count + group - 1) / group;
+  uint8_t first = bars * group - count;  // the oldest bar is the partial one
+  uint32_t sums[CHART_WIDGET_MAX_POINTS] = {};
+  uint32_t top = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t& sum = sums[(first + i) / group];
+    sum += values[i];
+    top = max(top, sum);
+  }
+
+  int16_t barWidth = max<int16_t>(w / bars, 1);
+  for (uint8_t b = 0; b < bars; b++) {
+    if (sums[b] == 0) {
+      continue;
+    }
+    int16_t barHeight = max<int32_t>(sums[b] * h / top, 1);
+    gfx.fillRect(x + w - (bars - b) * barWidth, y + h - barHeight, max<int16_t>(barWidth - 1, 1), barHeight,
+                 SSD1306_WHITE);
+  }
+}
+
+/*
+  Makes a screen the active one and draws it completely, static parts
+  included. Dynamic widgets poll their value first so they start current.
+*/
+void showScreen(const Screen* screen) {
+  active = screen;
+  screenStats.fullDraws++;
+
+  display.clearDisplay();
+  display.setTextColor(SSD1306_WHITE);
+  for (uint8_t i = 0; i < screen->count; i++) {
+    Widget* widget = screen->widgets[i];
+    widget->changed();
+    widget->draw(display);
+  }
+  display.display();
+}
+
+// Called when something else takes over the display
+void hideScreen() {
+  active = nullptr;
+}
+
+/*
+  Redraws the widgets of the active screen whose bound value changed.
+  Returns true if anything was drawn (and committed to the display).
+*/
+bool refreshScreen() {
+  if (active == nullptr) {
+    return false;
+  }
+
+  bool drew = false;
+  for (uint8_t i = 0; i < active->count; i++) {
+    Widget* widget = active->widgets[i];
+    if (!widget->dynamic || !widget->changed()) {
+      continue;
+    }
+    display.fillRect(widget->x, widget->y, widget->w, widget->h, SSD1306_BLACK);
+    display.setTextColor(SSD1306_WHITE);
+    widget->draw(display);
+    screenStats.widgetRedraws++;
+    drew = true;
+  }
+
+  if (drew) {
+    display.display();
+  } else {
+    screenStats.idleRefreshes++;
+  }
+  return drew;
+}
+
+bool isScreenActive(const Screen* screen) {
+  return active == screen;
+}
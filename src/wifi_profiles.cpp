@@ -0,0 +1,227 @@
+#include <wifi_profiles.h>
+#include <config.h>
+#include <ESP8266WiFi.h>
+#include <ota_update.h>
+#include <trace.h>
+#include <stall_watchdog.h>
+#include <log.h>
+
+static uint32_t lastCheck = 0;
+static uint8_t weakChecks = 0;
+static uint32_t lostSince = 0;
+static bool scanning = false;
+static int8_t roamingTo = -1;  // profile being joined in the background
+static uint32_t roamStartedAt = 0;
+static uint32_t roams = 0;
+
+// Fills in the strongest access point of the scan for the candidate's network
+static void matchScan(int8_t found, WifiCandidate& candidate) {
+  candidate.rssi = WIFI_RSSI_UNSEEN;
+  candidate.channel = 0;
+  for (int8_t i = 0; i < found; i++) {
+    int32_t rssi = WiFi.RSSI(i);
+    if (rssi > candidate.rssi && WiFi.SSID(i) == config.wifi[candidate.profile].ssid) {
+      candidate.rssi = rssi;
+      candidate.channel = WiFi.channel(i);
+      memcpy(candidate.bssid, WiFi.BSSID(i), sizeof(candidate.bssid));
+    }
+  }
+}
+
+static uint8_t mostRecentProfile() {
+  uint8_t best = 0;
+  for (uint8_t i = 1; i < CONFIG_WIFI_PROFILES; i++) {
+    if (config.wifi[i].lastUsed > config.wifi[best].lastUsed) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+static int16_t score(const WifiCandidate& candidate, uint8_t recent) {
+  if (candidate.rssi == WIFI_RSSI_UNSEEN) {
+    return INT16_MIN;  // ties broken by recency
+  }
+  bool bonus = candidate.profile == recent && config.wifi[recent].lastUsed != 0;
+  return candidate.rssi + (bonus ? WIFI_RECENT_BONUS_DB : 0);
+}
+
+static bool ranksBefore(const WifiCandidate& a, const WifiCandidate& b, uint8_t recent) {
+  int16_t scoreA = score(a, recent);
+  int16_t scoreB = score(b, recent);
+  if (scoreA != scoreB) {
+    return scoreA > scoreB;
+  }
+  return config.wifi[a.profile].lastUsed > config.wifi[b.profile].lastUsed;
+}
+
+/*
+  Scans once and fills candidates with the stored networks, best first.
+  Returns how many there are; 0 if none is configured.
+*/
+uint8_t rankWifiCandidates(WifiCandidate* candidates) {
+  StallSpan span(SPAN_WIFI);
+  uint32_t start = millis();
+  WiFi.mode(WIFI_STA);
+  int8_t found = WiFi.scanNetworks();
+
+  uint8_t count = 0;
+  uint8_t visible = 0;
+  uint8_t recent = mostRecentProfile();
+  for (uint8_t p = 0; p < CONFIG_WIFI_PROFILES; p++) {
+    if (config.wifi[p].ssid[0] == '\0') {
+      continue;
+    }
+    WifiCandidate candidate;
+    candidate.profile = p;
+    matchScan(found, candidate);
+    visible += candidate.rssi != WIFI_RSSI_UNSEEN;
+
+    // Insertion sort, there are at most CONFIG_WIFI_PROFILES
+    uint8_t at = count++;
+    while (at > 0 && ranksBefore(candidate, candidates[at - 1], recent)) {
+      candidates[at] = candidates[at - 1];
+      at--;
+    }
+    candidates[at] = candidate;
+  }
+  WiFi.scanDelete();
+
+  LOG_INFO(WIFI, "Scan found %d networks in %u ms, %u of %u stored networks visible",
+           max<int8_t>(found, 0), (uint32_t)(millis() - start), visible, count);
+  return count;
+}
+
+// Starts joining the candidate; on its access point if the scan saw it
+void beginWifiCandidate(const WifiCandidate& candidate) {
+  const WifiProfile& profile = config.wifi[candidate.profile];
+  if (candidate.rssi == WIFI_RSSI_UNSEEN) {
+    WiFi.begin(profile.ssid, profile.password);
+  } else {
+    WiFi.begin(profile.ssid, profile.password, candidate.channel, candidate.bssid);
+  }
+}
+
+// Records a successful connection, which makes the network the most recent one
+void wifiConnected(uint8_t profile, uint32_t elapsedMs) {
+  WifiProfile& connected = config.wifi[profile];
+  LOG_INFO(WIFI, "Connected to %s in %u ms (%d dBm)", connected.ssid, elapsedMs, WiFi.RSSI());
+  connected.connectMs = min<uint32_t>(elapsedMs, UINT16_MAX);
+  connected.lastUsed = ++config.wifiConnects;
+  saveConfig();
+}
+
+// Joins the strongest stored network of a finished background scan if it beats the current one
+static void roamFromScan(int8_t found) {
+  bool connected = WiFi.status() == WL_CONNECTED;
+  int32_t currentRssi = connected ? WiFi.RSSI() : WIFI_RSSI_UNSEEN;
+  uint8_t currentBssid[6] = {};
+  if (connected) {
+    memcpy(currentBssid, WiFi.BSSID(), sizeof(currentBssid));
+  }
+
+  WifiCandidate best;
+  best.rssi = WIFI_RSSI_UNSEEN;
+  for (uint8_t p = 0; p < CONFIG_WIFI_PROFILES; p++) {
+    if (config.wifi[p].ssid[0] == '\0') {
+      continue;
+    }
+    WifiCandidate candidate;
+    candidate.profile = p;
+    matchScan(found, candidate);
+    if (candidate.rssi > best.rssi) {
+      best = candidate;
+    }
+  }
+
+  if (best.rssi == WIFI_RSSI_UNSEEN ||
+      (connected && (best.rssi < currentRssi + WIFI_ROAM_MARGIN_DB ||
+                     memcmp(best.bssid, currentBssid, sizeof(currentBssid)) == 0))) {
+    LOG_DEBUG(WIFI, "No better network (%d dBm now)", currentRssi);
+    return;
+  }
+
+  LOG_INFO(WIFI, "Roaming to %s (%d dBm, was %d dBm)", config.wifi[best.profile].ssid, best.rssi, currentRssi);
+  roams++;
+  roamingTo = best.profile;
+  roamStartedAt = traceMillis();
+  beginWifiCandidate(best);
+}
+
+/*
+  Watches the signal and roams to a stronger stored network; the
+  WebSocket reconnects on its own once the new network gives an IP.
+  Call once per loop() pass while in station mode.
+*/
+void wifiRoamTick() {
+  uint32_t now = traceMillis();
+  if (scanning) {
+    int8_t found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) {
+      return;
+    }
+    scanning = false;
+    if (found >= 0) {
+      roamFromScan(found);
+    }
+    WiFi.scanDelete();
+    return;
+  }
+
+  bool connected = WiFi.status() == WL_CONNECTED;
+  if (roamingTo >= 0) {
+    if (connected) {
+      wifiConnected(roamingTo, now - roamStartedAt);
+      roamingTo = -1;
+    } else if (now - roamStartedAt > WIFI_PROFILE_TIMEOUT_MS) {
+      LOG_WARN(WIFI, "Roaming to %s timed out", config.wifi[roamingTo].ssid);
+      roamingTo = -1;
+    } else {
+      return;
+    }
+  }
+
+  if (now - lastCheck < WIFI_ROAM_CHECK_MS || isOtaRunning()) {
+    return;
+  }
+  lastCheck = now;
+
+  if (connected) {
+    lostSince = 0;
+    if (WiFi.RSSI() >= WIFI_ROAM_RSSI) {
+      weakChecks = 0;
+      return;
+    }
+    if (++weakChecks < 2) {
+      return;
+    }
+    LOG_INFO(WIFI, "Signal weak (%d dBm), scanning", WiFi.RSSI());
+  } else {
+    if (lostSince == 0) {
+      lostSince = now;
+    }
+    if (now - lostSince < WIFI_LOST_MS) {
+      return;
+    }
+    LOG_INFO(WIFI, "Disconnected for %u s, scanning", (now - lostSince) / 1000);
+  }
+  weakChecks = 0;
+  scanning = WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING;
+}
+
+void printWifiReport() {
+  bool connected = WiFi.status() == WL_CONNECTED;
+  LOG_INFO(WIFI, "%s %d dBm, %u roams", connected ? WiFi.SSID().c_str() : "Not connected",
+           connected ? WiFi.RSSI() : 0, roams);
+  for (const WifiProfile& profile : config.wifi) {
+    if (profile.ssid[0] == '\0') {
+      continue;
+    }
+    if (profile.lastUsed == 0) {
+      LOG_INFO(WIFI, "  %s: never connected", profile.ssid);
+    } else {
+      LOG_INFO(WIFI, "  %s: connected in %u ms, %u connections ago", profile.ssid, profile.connectMs,
+               config.wifiConnects - profile.lastUsed);
+    }
+  }
+}
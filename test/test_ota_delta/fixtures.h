@@ -0,0 +1,561 @@
+// Generated by make_fixtures.py from tools/make_delta.py, do not edit
+
+#pragma once
+
+#include <stdint.h>
+
+static const uint8_t addNearStartSource[] = {
+  0x15, 0xbc, 0x09, 0x73, 0xa4, 0xf4, 0x94, 0xdf, 0xc1, 0x0a, 0x54, 0xbe, 0xc1, 0xcb, 0x37, 0xf8,
+  0x82, 0x47, 0x48, 0x47, 0xc2, 0x4f, 0xda, 0x5a, 0xdc, 0xba, 0x70, 0x79, 0x8e, 0xca, 0x6f, 0xd4,
+  0xe4, 0x06, 0xea, 0xe4, 0x0a, 0xc6, 0x19, 0xae, 0xe0, 0x17, 0xee, 0x0b, 0x9b, 0x00, 0x99, 0xb2,
+  0xbb, 0xbc, 0x87, 0x09, 0xf1, 0x50, 0x46, 0x1c, 0xdf, 0x8e, 0x52, 0x01, 0x84, 0xd5, 0x7e, 0x4b,
+  0x12, 0x3a, 0x15, 0x8b, 0xa1, 0x69, 0x4f, 0x7e, 0x15, 0x5b, 0x0c, 0x36, 0x51, 0xe4, 0x5b, 0x28,
+  0xe4, 0x57, 0xc1, 0x55, 0xd6, 0xd2, 0x79, 0xcd, 0x45, 0x37, 0x1c, 0x77, 0x49, 0x0f, 0x0d, 0xe3,
+  0x3e, 0x0a, 0x87, 0x61, 0xb5, 0xa3, 0xf5, 0xca, 0xc3, 0xc9, 0x5e, 0xc4, 0xaf, 0xbc, 0xcb, 0x68,
+  0xd5, 0x01, 0xf7, 0xdf, 0x3e, 0xde, 0x26, 0xcd, 0x04, 0x29, 0x8a, 0x17, 0x03, 0x27, 0x11, 0x5b,
+  0xe5, 0x68, 0x05, 0x5f, 0x11, 0xb7, 0x5d, 0x79, 0xc9, 0x0b, 0x0e, 0x15, 0xcc, 0x77, 0x9e, 0x95,
+  0xf5, 0x5b, 0x81, 0x17, 0xf7, 0x69, 0x4c, 0x09, 0x43, 0xeb, 0x5f, 0x3e, 0x96, 0xe2, 0x8e, 0xe4,
+  0xa4, 0x5c, 0x3c, 0xb6, 0x61, 0x75, 0x63, 0xed, 0x47, 0x1c, 0x46, 0xb8, 0x87, 0x5d, 0x7e, 0xb4,
+  0xb0, 0x9a, 0x72, 0x5b, 0xa3, 0xf4, 0x7d, 0x56, 0x75, 0x6f, 0x94, 0x69, 0x57, 0xfb, 0xc4, 0xd3,
+  0x94, 0xb5, 0x0b, 0xc3, 0xc0, 0x82, 0x37, 0x8b, 0xa9, 0xcc, 0x83, 0x44, 0xe3, 0x33, 0xac, 0x48,
+  0xab, 0xaa, 0x91, 0xb0, 0x24, 0x96, 0xaa, 0x6d, 0x22, 0x3b, 0xf7, 0xd3, 0x42, 0x76, 0x7a, 0x71,
+  0xd2, 0x14, 0x37, 0x8e, 0x59, 0x81, 0xda, 0x12, 0xae, 0x26, 0xa2, 0xb1, 0x33, 0x70, 0x65, 0xfe,
+  0x49, 0xfe, 0xc2, 0x03, 0xc0, 0x15, 0x50, 0x71, 0xc7, 0x88, 0x4d, 0x54, 0xf4, 0x75, 0x86, 0x4f,
+  0xea, 0x64, 0x55, 0xa7, 0xbb, 0xec, 0x2e, 0x96, 0xc4, 0x94, 0xbd, 0x8f, 0xc8, 0xd8, 0xc9, 0x81,
+  0x04, 0xc8, 0x2c, 0x43, 0xf2, 0x05, 0x08, 0x39, 0xa2, 0x58, 0xaa, 0xa2, 0x9e, 0x30, 0xd5, 0x3c,
+  0x47, 0x08, 0x39, 0x54, 0x58, 0x45, 0xe2, 0x46, 0x4c, 0x5c, 0x3d, 0x45, 0xba, 0x73, 0x54, 0x7a,
+  0x94, 0xc5, 0x32, 0xae, 0x98, 0x4e, 0xb6, 0x26, 0xa0, 0xcb, 0x05, 0xe4, 0xcc, 0xef, 0xaf, 0x54,
+  0xc2, 0x6f, 0x80, 0xb7, 0x4e, 0x98, 0x17, 0x00, 0xb1, 0x48, 0x92, 0xa1, 0x3b, 0x22, 0x9e, 0xca,
+  0x9e, 0xa3, 0x18, 0x26, 0x7f, 0xdd, 0x36, 0xf0, 0xbc, 0x9d, 0xef, 0xee, 0x09, 0x09, 0x30, 0x33,
+  0xbb, 0xbb, 0x9e, 0xe5, 0xe7, 0xf6, 0x50, 0x7e, 0x06, 0x8c, 0x04, 0xfa, 0x8a, 0x25, 0x41, 0xdf,
+  0xf0, 0xda, 0x86, 0xd8, 0xe7, 0x8c, 0xaf, 0xe4, 0xd2, 0x32, 0x78, 0x0f, 0xfc, 0x41, 0x79, 0x3f,
+  0x09, 0x60, 0x79, 0xdb, 0x76, 0x8a, 0xc9, 0xcb, 0xe3, 0x7a, 0xd2, 0x2b, 0x9e, 0xdc, 0x3f, 0x81,
+  0xf8, 0x24, 0x23, 0x01, 0x8f, 0x86, 0x20, 0x85, 0x96, 0xbc, 0xec, 0x72, 0xbd, 0xe6, 0x0d, 0x2f,
+  0x46, 0xf0, 0x79, 0x52, 0x2a, 0xcf, 0x0b, 0x9f, 0x8f, 0xa6, 0x52, 0x2d, 0xbc, 0x7a, 0x64, 0x7b,
+  0xff, 0x49, 0xa9, 0xd7, 0x2d, 0xec, 0xb1, 0xd5, 0x71, 0x92, 0xc8, 0x5f, 0x46, 0x25, 0x4f, 0xe0,
+  0xc5, 0x7e, 0xbe, 0x0a, 0xa3, 0xb1, 0x31, 0x39, 0xa2, 0x3a, 0x93, 0x6b, 0xac, 0xad, 0x8b, 0x85,
+  0x7b, 0x5d, 0x60, 0xc8, 0x23, 0x9e, 0x65, 0x36, 0xdf, 0xe0, 0xb9, 0x88, 0xd8, 0x1f, 0x29, 0x40,
+  0x9f, 0xbe, 0xa3, 0xb3, 0x9e, 0x63, 0x9a, 0x88, 0x99, 0xf1, 0x60, 0x71, 0x86, 0x0b, 0x33, 0xa6,
+  0xad, 0xba, 0xd4, 0x84, 0x44, 0x95, 0xe3, 0xda, 0xa4, 0x2c, 0x39, 0x6d, 0xf5, 0x49, 0x74, 0xe3,
+  0x46, 0xcf, 0x88, 0xed, 0x7d, 0x32, 0x1f, 0x5a, 0x06, 0x9b, 0xb0, 0xef, 0x09, 0x8b, 0x88, 0x75,
+  0x3d, 0xcc, 0x5c, 0x5f, 0xc3, 0x84, 0x36, 0xac, 0x65, 0xd8, 0x21, 0x25, 0x20, 0x63, 0x9a, 0xad,
+  0x03, 0x5b, 0xf7, 0x26, 0x70, 0xfd, 0x35, 0xb8, 0xe4, 0xe7, 0xcc, 0xc9, 0x81, 0xac, 0x3d, 0x9b,
+  0x93, 0x1e, 0xc6, 0xa1, 0xc8, 0xd6, 0x1f, 0xf7, 0x16, 0x99, 0x08, 0x4c, 0x40, 0x41, 0xe2, 0x67,
+  0x09, 0x9e, 0xb9, 0x96, 0x6e, 0x25, 0xaa, 0xc4, 0x9c, 0xf9, 0xf6, 0x25, 0x57, 0xe0, 0xd6, 0xea,
+  0xab, 0xfb, 0x26, 0x2c, 0xd9, 0x2f, 0x57, 0x8c, 0xa9, 0xad, 0x14, 0xc9, 0x26, 0xa3, 0xc0, 0xed,
+  0xc0, 0x2b, 0x4a, 0xd6, 0x17, 0x62, 0x8a, 0xba, 0xb6, 0x8f, 0x88, 0x8e, 0x3a, 0x7d, 0xc2, 0x87,
+  0x87, 0xdb, 0x40, 0x63, 0x2b, 0xee, 0x21, 0xe0, 0x44, 0x1f, 0xeb, 0xa3, 0xbd, 0xf7, 0x8f, 0x58,
+  0x6b, 0x0a, 0x42, 0xdc, 0x00, 0xe9, 0xb2, 0x23, 0x5e, 0x84, 0x29, 0xa3, 0xe6, 0x87, 0x45, 0xa7,
+  0xda, 0x56, 0x22, 0x5c, 0x13, 0xf6, 0xd6, 0xf5, 0x85, 0x5f, 0xa5, 0xd3, 0x1f, 0x64, 0xc0, 0xa1,
+  0xc3, 0x36, 0x5a, 0x8d, 0x6c, 0xfe, 0x88, 0x34, 0x25, 0x50, 0xe7, 0x38, 0xe9, 0xbb, 0x4b, 0x73,
+  0x64, 0xa4, 0xa8, 0x20, 0xb7, 0x34, 0x08, 0xeb, 0xfc, 0x71, 0x4f, 0x61, 0x79, 0x6c, 0xa3, 0x94,
+  0x8a, 0x1e, 0x26, 0x97, 0xf7, 0x9e, 0xb9, 0xe9, 0xcb, 0x4a, 0x29, 0x22, 0x60, 0x21, 0x6b, 0xe0,
+  0x1c, 0xe3, 0x23, 0x4f, 0xf3, 0x6a, 0x94, 0xc4, 0x9e, 0xb1, 0x5b, 0x8c, 0x0d, 0x62, 0xb9, 0x86,
+  0x28, 0xd9, 0xe2, 0x24, 0x55, 0x76, 0xdb, 0x78, 0x5a, 0x6a, 0x89, 0x30, 0xb0, 0xa9, 0x08, 0x36,
+  0xc6, 0x2e, 0x47, 0xcc, 0x12, 0xe1, 0x9a, 0xcd, 0x5e, 0x27, 0x53, 0x8e, 0xba, 0x39, 0x25, 0xce,
+  0x12, 0xae, 0x37, 0x8f, 0x66, 0x30, 0xc7, 0x46, 0xcc, 0xb3, 0x73, 0x5b, 0x29, 0x50, 0x44, 0x6d,
+  0x56, 0xd8, 0xdc, 0x27, 0x94, 0xf9, 0xf8, 0x1a, 0x1f, 0x8e, 0x16, 0x20, 0x65, 0x83, 0xf7, 0x3d,
+  0xd4, 0x37, 0x43, 0x4d, 0x50, 0xb6, 0xf2, 0x6a, 0x49, 0x94, 0xb1, 0xe2, 0x05, 0x61, 0xbb, 0xc4,
+  0x83, 0x2e, 0x96, 0x1e, 0x0b, 0xd5, 0x1d, 0xb0, 0xbc, 0x0d, 0xab, 0x41, 0x9b, 0x39, 0x79, 0xeb,
+  0x19, 0x9f, 0x99, 0x53, 0xe2, 0x82, 0xba, 0x1e, 0xce, 0x71, 0x00, 0x1c, 0x5a, 0x3f, 0x09, 0x41,
+  0x51, 0x7c, 0xa4, 0x6a, 0xab, 0xc5, 0xb4, 0x3f, 0x68, 0x33, 0x4e, 0x0d, 0x1a, 0x1b, 0x60, 0x4e,
+  0x95, 0xe0, 0x9b, 0xc4, 0x03, 0x4d, 0x26, 0x02, 0x4d, 0x67, 0xb5, 0xac, 0x0e, 0x3d, 0xac, 0x05,
+  0x90, 0x6a, 0xda, 0x75, 0x8f, 0x9b, 0x86, 0x42, 0xa7, 0xf5, 0x0f, 0xaa, 0xa6, 0x3e, 0x5e, 0xd8,
+  0x7d, 0x67, 0xfc, 0xe2, 0x5b, 0x1e, 0x24, 0xc1, 0x6a, 0x99, 0xc7, 0x85, 0x64, 0x58, 0xd3, 0x5a,
+  0x8d, 0xbe, 0xfb, 0x55, 0x59, 0x51, 0x1e, 0xeb, 0xd1, 0xe7, 0x88, 0xb0, 0x2e, 0xf4, 0x70, 0x24,
+  0xbe, 0x4a, 0x8a, 0x5d, 0xdc, 0x8a, 0x5b, 0xd9, 0x99, 0xc8, 0x86, 0x62, 0x84, 0x2b, 0x08, 0xe4,
+  0x12, 0x8d, 0xd5, 0xb1, 0x72, 0x5a, 0xe6, 0xb5, 0xb6, 0xea, 0x17, 0x44, 0xff, 0x78, 0x0d, 0x05,
+  0xcb, 0xaf, 0x33, 0xd3, 0x11, 0xd2, 0x2e, 0x8a, 0x4c, 0x21, 0x69, 0x51, 0x0b, 0x4c, 0x96, 0xfa,
+  0x0f, 0xa5, 0x80, 0xfe, 0x0d, 0xc8, 0xb9, 0x2f, 0xfa, 0xda, 0x29, 0x69, 0x22, 0x2a, 0x0b, 0x84,
+  0xe5, 0x36, 0x9d, 0x8b, 0x03, 0x13, 0x83, 0x6c, 0x3e, 0x42, 0x44, 0xd4, 0x81, 0xb1, 0x5f, 0xc3,
+  0xe5, 0xf5, 0xe3, 0x16, 0x0a, 0x7d, 0x90, 0xd3, 0x2b, 0x22, 0x92, 0x17, 0x86, 0x3c, 0xbe, 0x07,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t addNearStartTarget[] = {
+  0x15, 0xbc, 0x09, 0x73, 0xa4, 0xf4, 0x94, 0xdf, 0xc1, 0x0a, 0x54, 0xbe, 0xc1, 0xcb, 0x37, 0xf8,
+  0x82, 0x47, 0x48, 0x47, 0xc2, 0x4f, 0xda, 0x5a, 0xdc, 0xba, 0x70, 0x79, 0x8e, 0xca, 0x6f, 0xd4,
+  0xe4, 0x06, 0xea, 0xe4, 0x0a, 0xc6, 0x19, 0xae, 0xe1, 0x17, 0xee, 0x0b, 0x9b, 0x00, 0x99, 0xb3,
+  0xbb, 0xbc, 0x87, 0x09, 0xf1, 0x50, 0x47, 0x1c, 0xdf, 0x8e, 0x52, 0x01, 0x84, 0xd6, 0x7e, 0x4b,
+  0x12, 0x3a, 0x15, 0x8b, 0xa2, 0x69, 0x4f, 0x7e, 0x15, 0x5b, 0x0c, 0x37, 0x51, 0xe4, 0x5b, 0x28,
+  0xe4, 0x57, 0xc2, 0x55, 0xd6, 0xd2, 0x79, 0xcd, 0x45, 0x38, 0x1c, 0x77, 0x49, 0x0f, 0x0d, 0xe3,
+  0x3f, 0x0a, 0x87, 0x61, 0xb5, 0xa3, 0xf5, 0xcb, 0xc3, 0xc9, 0x5e, 0xc4, 0xaf, 0xbc, 0xcc, 0x68,
+  0xd5, 0x01, 0xf7, 0xdf, 0x3e, 0xdf, 0x26, 0xcd, 0x04, 0x29, 0x8a, 0x17, 0x04, 0x27, 0x11, 0x5b,
+  0xe5, 0x68, 0x05, 0x60, 0x11, 0xb7, 0x5d, 0x79, 0xc9, 0x0b, 0x0f, 0x15, 0xcc, 0x77, 0x9e, 0x95,
+  0xf5, 0x5c, 0x81, 0x17, 0xf7, 0x69, 0x4c, 0x09, 0x44, 0xeb, 0x5f, 0x3e, 0x96, 0xe2, 0x8e, 0xe5,
+  0xa4, 0x5c, 0x3c, 0xb6, 0x61, 0x75, 0x64, 0xed, 0x47, 0x1c, 0x46, 0xb8, 0x87, 0x5e, 0x7e, 0xb4,
+  0xb0, 0x9a, 0x72, 0x5b, 0xa4, 0xf4, 0x7d, 0x56, 0x75, 0x6f, 0x94, 0x6a, 0x57, 0xfb, 0xc4, 0xd3,
+  0x94, 0xb5, 0x0c, 0xc3, 0xc0, 0x82, 0x37, 0x8b, 0xa9, 0xcd, 0x83, 0x44, 0xe3, 0x33, 0xac, 0x48,
+  0xac, 0xaa, 0x91, 0xb0, 0x24, 0x96, 0xaa, 0x6e, 0x22, 0x3b, 0xf7, 0xd3, 0x42, 0x76, 0x7b, 0x71,
+  0xd2, 0x14, 0x37, 0x8e, 0x59, 0x82, 0xda, 0x12, 0xae, 0x26, 0xa2, 0xb1, 0x34, 0x70, 0x65, 0xfe,
+  0x49, 0xfe, 0xc2, 0x04, 0xc0, 0x15, 0x50, 0x71, 0xc7, 0x88, 0x4e, 0x54, 0xf4, 0x75, 0x86, 0x4f,
+  0xea, 0x65, 0x55, 0xa7, 0xbb, 0xec, 0x2e, 0x96, 0xc5, 0x94, 0xbd, 0x8f, 0xc8, 0xd8, 0xc9, 0x82,
+  0x04, 0xc8, 0x2c, 0x43, 0xf2, 0x05, 0x09, 0x39, 0xa2, 0x58, 0xaa, 0xa2, 0x9e, 0x31, 0xd5, 0x3c,
+  0x47, 0x08, 0x39, 0x54, 0x59, 0x45, 0xe2, 0x46, 0x4c, 0x5c, 0x3d, 0x46, 0xba, 0x73, 0x54, 0x7a,
+  0x94, 0xc5, 0x33, 0xae, 0x98, 0x4e, 0xb6, 0x26, 0xa0, 0xcc, 0x05, 0xe4, 0xcc, 0xef, 0xaf, 0x54,
+  0xc3, 0x6f, 0x80, 0xb7, 0x4e, 0x98, 0x17, 0x01, 0xb1, 0x48, 0x92, 0xa1, 0x3b, 0x22, 0x9f, 0xca,
+  0x9e, 0xa3, 0x18, 0x26, 0x7f, 0xde, 0x36, 0xf0, 0xbc, 0x9d, 0xef, 0xee, 0x0a, 0x09, 0x30, 0x33,
+  0xbb, 0xbb, 0x9e, 0xe6, 0xe7, 0xf6, 0x50, 0x7e, 0x06, 0x8c, 0x05, 0xfa, 0x8a, 0x25, 0x41, 0xdf,
+  0xf0, 0xdb, 0x86, 0xd8, 0xe7, 0x8c, 0xaf, 0xe4, 0xd3, 0x32, 0x78, 0x0f, 0xfc, 0x41, 0x79, 0x40,
+  0x09, 0x60, 0x79, 0xdb, 0x76, 0x8a, 0xca, 0xcb, 0xe3, 0x7a, 0xd2, 0x2b, 0x9e, 0xdd, 0x3f, 0x81,
+  0xf8, 0x24, 0x23, 0x01, 0x8f, 0x86, 0x20, 0x85, 0x96, 0xbc, 0xec, 0x72, 0xbd, 0xe6, 0x0d, 0x2f,
+  0x46, 0xf0, 0x79, 0x52, 0x2a, 0xcf, 0x0b, 0x9f, 0x8f, 0xa6, 0x52, 0x2d, 0xbc, 0x7a, 0x64, 0x7b,
+  0xff, 0x49, 0xa9, 0xd7, 0x2d, 0xec, 0xb1, 0xd5, 0x71, 0x92, 0xc8, 0x5f, 0x46, 0x25, 0x4f, 0xe0,
+  0xc5, 0x7e, 0xbe, 0x0a, 0xa3, 0xb1, 0x31, 0x39, 0xa2, 0x3a, 0x93, 0x6b, 0xac, 0xad, 0x8b, 0x85,
+  0x7b, 0x5d, 0x60, 0xc8, 0x23, 0x9e, 0x65, 0x36, 0xdf, 0xe0, 0xb9, 0x88, 0xd8, 0x1f, 0x29, 0x40,
+  0x9f, 0xbe, 0xa3, 0xb3, 0x9e, 0x63, 0x9a, 0x88, 0x99, 0xf1, 0x60, 0x71, 0x86, 0x0b, 0x33, 0xa6,
+  0xad, 0xba, 0xd4, 0x84, 0x44, 0x95, 0xe3, 0xda, 0xa4, 0x2c, 0x39, 0x6d, 0xf5, 0x49, 0x74, 0xe3,
+  0x46, 0xcf, 0x88, 0xed, 0x7d, 0x32, 0x1f, 0x5a, 0x06, 0x9b, 0xb0, 0xef, 0x09, 0x8b, 0x88, 0x75,
+  0x3d, 0xcc, 0x5c, 0x5f, 0xc3, 0x84, 0x36, 0xac, 0x65, 0xd8, 0x21, 0x25, 0x20, 0x63, 0x9a, 0xad,
+  0x03, 0x5b, 0xf7, 0x26, 0x70, 0xfd, 0x35, 0xb8, 0xe4, 0xe7, 0xcc, 0xc9, 0x81, 0xac, 0x3d, 0x9b,
+  0x93, 0x1e, 0xc6, 0xa1, 0xc8, 0xd6, 0x1f, 0xf7, 0x16, 0x99, 0x08, 0x4c, 0x40, 0x41, 0xe2, 0x67,
+  0x09, 0x9e, 0xb9, 0x96, 0x6e, 0x25, 0xaa, 0xc4, 0x9c, 0xf9, 0xf6, 0x25, 0x57, 0xe0, 0xd6, 0xea,
+  0xab, 0xfb, 0x26, 0x2c, 0xd9, 0x2f, 0x57, 0x8c, 0xa9, 0xad, 0x14, 0xc9, 0x26, 0xa3, 0xc0, 0xed,
+  0xc0, 0x2b, 0x4a, 0xd6, 0x17, 0x62, 0x8a, 0xba, 0xb6, 0x8f, 0x88, 0x8e, 0x3a, 0x7d, 0xc2, 0x87,
+  0x87, 0xdb, 0x40, 0x63, 0x2b, 0xee, 0x21, 0xe0, 0x44, 0x1f, 0xeb, 0xa3, 0xbd, 0xf7, 0x8f, 0x58,
+  0x6b, 0x0a, 0x42, 0xdc, 0x00, 0xe9, 0xb2, 0x23, 0x5e, 0x84, 0x29, 0xa3, 0xe6, 0x87, 0x45, 0xa7,
+  0xda, 0x56, 0x22, 0x5c, 0x13, 0xf6, 0xd6, 0xf5, 0x85, 0x5f, 0xa5, 0xd3, 0x1f, 0x64, 0xc0, 0xa1,
+  0xc3, 0x36, 0x5a, 0x8d, 0x6c, 0xfe, 0x88, 0x34, 0x25, 0x50, 0xe7, 0x38, 0xe9, 0xbb, 0x4b, 0x73,
+  0x64, 0xa4, 0xa8, 0x20, 0xb7, 0x34, 0x08, 0xeb, 0xfc, 0x71, 0x4f, 0x61, 0x79, 0x6c, 0xa3, 0x94,
+  0x8a, 0x1e, 0x26, 0x97, 0xf7, 0x9e, 0xb9, 0xe9, 0xcb, 0x4a, 0x29, 0x22, 0x60, 0x21, 0x6b, 0xe0,
+  0x1c, 0xe3, 0x23, 0x4f, 0xf3, 0x6a, 0x94, 0xc4, 0x9e, 0xb1, 0x5b, 0x8c, 0x0d, 0x62, 0xb9, 0x86,
+  0x28, 0xd9, 0xe2, 0x24, 0x55, 0x76, 0xdb, 0x78, 0x5a, 0x6a, 0x89, 0x30, 0xb0, 0xa9, 0x08, 0x36,
+  0xc6, 0x2e, 0x47, 0xcc, 0x12, 0xe1, 0x9a, 0xcd, 0x5e, 0x27, 0x53, 0x8e, 0xba, 0x39, 0x25, 0xce,
+  0x12, 0xae, 0x37, 0x8f, 0x66, 0x30, 0xc7, 0x46, 0xcc, 0xb3, 0x73, 0x5b, 0x29, 0x50, 0x44, 0x6d,
+  0x56, 0xd8, 0xdc, 0x27, 0x94, 0xf9, 0xf8, 0x1a, 0x1f, 0x8e, 0x16, 0x20, 0x65, 0x83, 0xf7, 0x3d,
+  0xd4, 0x37, 0x43, 0x4d, 0x50, 0xb6, 0xf2, 0x6a, 0x49, 0x94, 0xb1, 0xe2, 0x05, 0x61, 0xbb, 0xc4,
+  0x83, 0x2e, 0x96, 0x1e, 0x0b, 0xd5, 0x1d, 0xb0, 0xbc, 0x0d, 0xab, 0x41, 0x9b, 0x39, 0x79, 0xeb,
+  0x19, 0x9f, 0x99, 0x53, 0xe2, 0x82, 0xba, 0x1e, 0xce, 0x71, 0x00, 0x1c, 0x5a, 0x3f, 0x09, 0x41,
+  0x51, 0x7c, 0xa4, 0x6a, 0xab, 0xc5, 0xb4, 0x3f, 0x68, 0x33, 0x4e, 0x0d, 0x1a, 0x1b, 0x60, 0x4e,
+  0x95, 0xe0, 0x9b, 0xc4, 0x03, 0x4d, 0x26, 0x02, 0x4d, 0x67, 0xb5, 0xac, 0x0e, 0x3d, 0xac, 0x05,
+  0x90, 0x6a, 0xda, 0x75, 0x8f, 0x9b, 0x86, 0x42, 0xa7, 0xf5, 0x0f, 0xaa, 0xa6, 0x3e, 0x5e, 0xd8,
+  0x7d, 0x67, 0xfc, 0xe2, 0x5b, 0x1e, 0x24, 0xc1, 0x6a, 0x99, 0xc7, 0x85, 0x64, 0x58, 0xd3, 0x5a,
+  0x8d, 0xbe, 0xfb, 0x55, 0x59, 0x51, 0x1e, 0xeb, 0xd1, 0xe7, 0x88, 0xb0, 0x2e, 0xf4, 0x70, 0x24,
+  0xbe, 0x4a, 0x8a, 0x5d, 0xdc, 0x8a, 0x5b, 0xd9, 0x99, 0xc8, 0x86, 0x62, 0x84, 0x2b, 0x08, 0xe4,
+  0x12, 0x8d, 0xd5, 0xb1, 0x72, 0x5a, 0xe6, 0xb5, 0xb6, 0xea, 0x17, 0x44, 0xff, 0x78, 0x0d, 0x05,
+  0xcb, 0xaf, 0x33, 0xd3, 0x11, 0xd2, 0x2e, 0x8a, 0x4c, 0x21, 0x69, 0x51, 0x0b, 0x4c, 0x96, 0xfa,
+  0x0f, 0xa5, 0x80, 0xfe, 0x0d, 0xc8, 0xb9, 0x2f, 0xfa, 0xda, 0x29, 0x69, 0x22, 0x2a, 0x0b, 0x84,
+  0xe5, 0x36, 0x9d, 0x8b, 0x03, 0x13, 0x83, 0x6c, 0x3e, 0x42, 0x44, 0xd4, 0x81, 0xb1, 0x5f, 0xc3,
+  0xe5, 0xf5, 0xe3, 0x16, 0x0a, 0x7d, 0x90, 0xd3, 0x2b, 0x22, 0x92, 0x17, 0x86, 0x3c, 0xbe, 0x07,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t addNearStartDelta[] = {
+  0x4c, 0x42, 0x44, 0x31, 0x00, 0x04, 0x00, 0x00, 0xa8, 0x17, 0x73, 0xc8, 0xf9, 0x87, 0x53, 0x7b,
+  0x37, 0xbc, 0x5f, 0x98, 0x52, 0x62, 0xc9, 0xb9, 0x00, 0x04, 0x00, 0x00, 0xe8, 0x68, 0xc9, 0x6e,
+  0xf5, 0x93, 0xa3, 0x28, 0x98, 0xe3, 0x81, 0x41, 0x29, 0x1d, 0x27, 0xf3, 0xab, 0x01, 0x00, 0x00,
+  0x00, 0x28, 0x00, 0xc0, 0x02, 0x01, 0x01, 0x66, 0x00, 0x03, 0x80, 0x04, 0x42, 0x01, 0xbf, 0x01,
+  0xbf, 0x01, 0xbf, 0x01, 0xbf, 0x01, 0xbf, 0x01, 0x94, 0x1b, 0x01, 0x8e, 0x02, 0x40, 0x72, 0x02,
+  0x02, 0x80,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t shiftedSource[] = {
+  0x48, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0x15, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61,
+  0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48,
+  0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0x5f,
+  0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20,
+  0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7,
+  0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20,
+  0xe7, 0x48, 0x15, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f,
+  0x61, 0x48, 0x48, 0x30, 0x9b, 0x5f, 0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f,
+  0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5e, 0x50,
+  0x5e, 0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f,
+  0x61, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48,
+  0x07, 0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48,
+  0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0x12, 0x07, 0x5f,
+  0x61, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48,
+  0x5f, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48,
+  0x07, 0x5e, 0x50, 0x5e, 0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x5f, 0x61, 0x48, 0x07, 0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48,
+  0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20,
+  0x12, 0x07, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b, 0x07, 0x5e, 0xe7, 0x2e,
+  0xee, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xed, 0x5e, 0xe7, 0x2e, 0xed, 0x5e, 0x48, 0x7b,
+  0xe7, 0xca, 0xe7, 0x1e, 0x5e, 0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07,
+  0x15, 0x48, 0x07, 0x5f, 0x61, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0xe7,
+  0xe7, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f,
+  0xe4, 0x9b, 0xca, 0x61, 0xed, 0xed, 0xe7, 0x20, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f,
+  0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0x12, 0x07, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x61,
+  0xe4, 0xe7, 0xe7, 0x7b, 0x07, 0x5e, 0xe7, 0x2e, 0xee, 0x5f, 0x61, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4,
+  0x9b, 0x5f, 0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48,
+  0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x7b, 0xe4,
+  0x2e, 0x7b, 0x07, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4,
+  0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x61, 0x48, 0x07, 0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07,
+  0x5f, 0xe4, 0x30, 0x7b, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61,
+  0x07, 0x5f, 0x61, 0x15, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48,
+  0x07, 0x5e, 0x50, 0x5e, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b, 0x07, 0x5e, 0xe7, 0x2e,
+  0xee, 0x5f, 0x61, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0x5f, 0x5f, 0x5e, 0x15, 0xee, 0xe4, 0x61,
+  0xe4, 0xca, 0x07, 0x48, 0x12, 0xe7, 0xe4, 0xee, 0xe4, 0x9b, 0x1e, 0x07, 0x15, 0x5f, 0x0f, 0xe7,
+  0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0xe7, 0xe4, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x61,
+  0x61, 0x61, 0xe7, 0x5f, 0xe4, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x61, 0x48,
+  0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0xee, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0x12, 0x07,
+  0x07, 0xf3, 0x0f, 0xe7, 0xed, 0xe7, 0x61, 0xe7, 0x1e, 0x07, 0x48, 0x61, 0x61, 0x61, 0x61, 0x20,
+  0x12, 0x07, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x20, 0x48, 0x61, 0x61, 0x61, 0xe7, 0xe7, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x5f, 0x61, 0x48, 0x07, 0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48,
+  0x07, 0x15, 0x48, 0x07, 0xe4, 0xe7, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4,
+  0x9b, 0xca, 0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f,
+  0xe7, 0x5f, 0xe4, 0x9b, 0xf3, 0x7b, 0x5e, 0x07, 0x07, 0x0f, 0x50, 0x0f, 0x9b, 0x12, 0x48, 0x5f,
+  0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x9b, 0x20, 0x07, 0x20, 0x61,
+  0xe4, 0xca, 0x07, 0x48, 0x12, 0xe7, 0xe4, 0xee, 0xe4, 0x9b, 0x1e, 0x07, 0x15, 0x5f, 0x0f, 0xe7,
+  0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0x12, 0xe7, 0x48, 0x07, 0x15, 0x5f,
+  0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x07, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b, 0x07,
+  0x5e, 0xe7, 0x2e, 0xee, 0x5f, 0x61, 0x5f, 0x61, 0x12, 0x20, 0x07, 0x20, 0x1e, 0x5f, 0x5f, 0x5e,
+  0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t shiftedTarget[] = {
+  0x48, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0x15, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61,
+  0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61,
+  0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48,
+  0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0x5f,
+  0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20,
+  0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7,
+  0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15,
+  0x48, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20,
+  0xe7, 0x48, 0x15, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f,
+  0x61, 0x48, 0x48, 0x30, 0x9b, 0x5f, 0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f,
+  0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5e, 0x50,
+  0x5e, 0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f,
+  0x61, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48,
+  0x07, 0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48,
+  0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0xd3, 0xce, 0x89, 0x7e,
+  0xf2, 0xfc, 0x41, 0xad, 0xde, 0xf3, 0xa2, 0x37, 0x20, 0x12, 0x07, 0x5f, 0x61, 0x48, 0x48, 0x5f,
+  0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x07, 0x5f, 0x61,
+  0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x5e, 0x50, 0x5e,
+  0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61,
+  0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x61, 0x48, 0x07,
+  0x5f, 0x61, 0xca, 0x07, 0x15, 0x48, 0x07, 0x5f, 0xe4, 0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07,
+  0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe4, 0x20, 0x12, 0x07, 0x5f, 0x61,
+  0x48, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b, 0x07, 0x5e, 0xe7, 0x2e, 0xee, 0x5f, 0x61, 0xe4,
+  0x20, 0xe7, 0x48, 0x07, 0xed, 0x5e, 0xe7, 0x2e, 0xed, 0x5e, 0x48, 0x7b, 0xe7, 0xca, 0xe7, 0x1e,
+  0x5e, 0xf3, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f,
+  0x61, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0xe7, 0xe7, 0x5f, 0x61, 0x48,
+  0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61,
+  0xed, 0xed, 0xe7, 0x20, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0xe4, 0x20, 0x12, 0x07, 0x5f, 0x61, 0x48, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b,
+  0x07, 0x5e, 0xe7, 0x2e, 0xee, 0x5f, 0x61, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0x5f, 0x5f, 0x5e,
+  0x15, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48,
+  0x07, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4,
+  0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48,
+  0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca, 0x61, 0x7b, 0xe4, 0x2e, 0x7b, 0x07, 0x07,
+  0x15, 0x48, 0x07, 0x5f, 0x62, 0x07, 0x5f, 0x61, 0x48, 0x60, 0x61, 0xe4, 0x20, 0xe7, 0x49, 0x07,
+  0x15, 0x5f, 0x61, 0x49, 0x07, 0x5f, 0x61, 0xca, 0x08, 0x15, 0x48, 0x07, 0x5f, 0xe5, 0x30, 0x7b,
+  0x5f, 0x61, 0xe5, 0x20, 0xe7, 0x48, 0x07, 0x16, 0x48, 0x07, 0x5f, 0x61, 0x08, 0x5f, 0x61, 0x15,
+  0x48, 0x60, 0x61, 0xe4, 0x20, 0xe7, 0x49, 0x07, 0xe4, 0x20, 0xe7, 0x49, 0x07, 0x5e, 0x50, 0x5e,
+  0x49, 0x48, 0x5f, 0x61, 0xe4, 0xe8, 0xe7, 0x7b, 0x07, 0x5e, 0xe8, 0x2e, 0xee, 0x5f, 0x61, 0x60,
+  0x0f, 0xe7, 0x5f, 0xe4, 0x9c, 0x5f, 0x5f, 0x5e, 0x15, 0xef, 0xe4, 0x61, 0xe4, 0xca, 0x08, 0x48,
+  0x12, 0xe7, 0xe4, 0xef, 0xe4, 0x9b, 0x1e, 0x07, 0x16, 0x5f, 0x0f, 0xe7, 0x5f, 0xe5, 0x9b, 0xca,
+  0x61, 0x61, 0x49, 0x5f, 0x5f, 0x61, 0xe4, 0x21, 0xe7, 0x48, 0x07, 0x15, 0x49, 0x48, 0x5f, 0x61,
+  0xe4, 0x21, 0xe7, 0xe7, 0xe4, 0x5f, 0xe5, 0x9b, 0xca, 0x61, 0x61, 0x62, 0x61, 0x61, 0xe7, 0x5f,
+  0xe5, 0x5f, 0x61, 0x48, 0x5f, 0x62, 0xe4, 0x20, 0xe7, 0x48, 0x08, 0x15, 0x48, 0x07, 0x5f, 0x62,
+  0x48, 0x5f, 0x61, 0xe4, 0x21, 0xe7, 0x48, 0x07, 0x15, 0x60, 0x61, 0x48, 0x48, 0x5f, 0x62, 0xe4,
+  0x20, 0xe7, 0xee, 0x49, 0x07, 0x5f, 0xe4, 0x15, 0xe8, 0x48, 0x07, 0x15, 0x48, 0x08, 0x5f, 0x61,
+  0x48, 0x5f, 0x62, 0xe4, 0x20, 0xe7, 0x48, 0x08, 0xe4, 0x20, 0x12, 0x07, 0x08, 0xf3, 0x0f, 0xe7,
+  0xed, 0xe8, 0x61, 0xe7, 0x1e, 0x07, 0x49, 0x61, 0x61, 0x61, 0x61, 0x21, 0x12, 0x07, 0x5f, 0x61,
+  0x49, 0x48, 0x5f, 0x20, 0x48, 0x62, 0x61, 0x61, 0xe7, 0xe7, 0x08, 0x15, 0x48, 0x07, 0x5f, 0x62,
+  0x07, 0x5f, 0x61, 0x48, 0x60, 0x61, 0xe4, 0x20, 0xe7, 0x49, 0x07, 0x15, 0x5f, 0x61, 0x49, 0x07,
+  0x5f, 0x61, 0xca, 0x08, 0x15, 0x48, 0x07, 0x5f, 0xe5, 0x15, 0xe7, 0x48, 0x07, 0x16, 0x48, 0x07,
+  0xe4, 0xe7, 0x21, 0xe7, 0x48, 0x07, 0x15, 0x60, 0x0f, 0xe7, 0x5f, 0xe4, 0x9c, 0xca, 0x61, 0x61,
+  0x48, 0x60, 0x5f, 0x61, 0xe4, 0x20, 0xe8, 0x48, 0x07, 0x15, 0x5f, 0x10, 0xe7, 0x5f, 0xe4, 0x9b,
+  0xf3, 0x7b, 0x5e, 0x07, 0x07, 0x0f, 0x50, 0x0f, 0x9b, 0x12, 0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7,
+  0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61, 0x20, 0xe7, 0x48, 0x07, 0x15, 0x48, 0x07, 0x5f, 0x61,
+  0x48, 0x5f, 0x61, 0xe4, 0x20, 0xe7, 0x48, 0x9b, 0x20, 0x07, 0x20, 0x61, 0xe4, 0xca, 0x07, 0x48,
+  0x12, 0xe7, 0xe4, 0xee, 0xe4, 0x9b, 0x1e, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4, 0x9b, 0xca,
+  0x61, 0x61, 0x48, 0x5f, 0x5f, 0x61, 0x12, 0xe7, 0x48, 0x07, 0x15, 0x5f, 0x0f, 0xe7, 0x5f, 0xe4,
+  0x9b, 0xca, 0x61, 0x07, 0x48, 0x5f, 0x61, 0xe4, 0xe7, 0xe7, 0x7b, 0x07, 0x5e, 0xe7, 0x2e, 0xee,
+  0x5f, 0x61, 0x5f, 0x61, 0x12, 0x20, 0x07, 0x20, 0x1e, 0x5f, 0x5f, 0x5e, 0x15, 0xe7, 0x48, 0x07,
+  0x15, 0x48, 0x07, 0x5f, 0x61, 0x48, 0xe7, 0x48, 0x07, 0xe7, 0x61, 0xe4, 0x65, 0x35, 0xff, 0xff,
+  0x35, 0x35, 0x35, 0x06, 0x12, 0xff, 0x35, 0x35, 0x35, 0x06, 0x12, 0xff, 0x35, 0x35, 0x35, 0x06,
+  0x12, 0xff, 0x35, 0x35, 0x35, 0x06, 0x4f, 0xb5, 0xb5, 0x0b, 0x35, 0x06, 0x12, 0xff, 0x35, 0x35,
+  0x35, 0x06, 0x4f, 0xb5, 0xb5, 0x0b, 0x35, 0x06, 0x12, 0xff, 0x12, 0xff, 0x35, 0x35, 0x35, 0x06,
+  0x4f, 0xb5, 0xb5, 0x0b, 0x35, 0x06, 0x12, 0xff, 0xdf, 0x0f, 0x62, 0x35, 0x35, 0x06, 0x4f, 0xb5,
+  0xb5, 0x0b, 0x35, 0x06, 0x12, 0xff, 0x12, 0xff, 0x35, 0x35, 0x35, 0x06, 0x4f, 0xb5, 0xb5, 0x0b,
+  0x35, 0x06, 0x12, 0xff, 0xdf, 0x0f, 0x62, 0xff, 0x35, 0x35, 0x06, 0x4f, 0xb5, 0xb5, 0x0b, 0x35,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t shiftedDelta[] = {
+  0x4c, 0x42, 0x44, 0x31, 0x00, 0x04, 0x00, 0x00, 0xc4, 0xca, 0xb7, 0x7e, 0xa8, 0x2a, 0x63, 0x08,
+  0xe2, 0x21, 0x01, 0x0b, 0x85, 0xc3, 0xd6, 0x7d, 0x70, 0x04, 0x00, 0x00, 0x9b, 0xd1, 0x67, 0xd6,
+  0x82, 0x61, 0x25, 0xe9, 0x00, 0x78, 0xd6, 0x77, 0xa7, 0xac, 0x8b, 0xfb, 0x6b, 0x01, 0x00, 0x00,
+  0x00, 0x2c, 0x01, 0x40, 0x03, 0x0c, 0x02, 0x00, 0xff, 0xd3, 0xce, 0x89, 0x7e, 0xf2, 0xfc, 0x41,
+  0xad, 0x9f, 0xde, 0xf3, 0xa2, 0x37, 0x01, 0x05, 0x41, 0x00, 0xc1, 0x02, 0x1f, 0x58, 0x02, 0x00,
+  0x00, 0x28, 0x02, 0x00, 0x0a, 0xc2, 0x01, 0x3f, 0xf0, 0x01, 0x3f, 0x01, 0x3f, 0x01, 0x3f, 0x01,
+  0x18, 0x01, 0x80, 0x03, 0x00, 0xdb, 0x00, 0x80, 0x02, 0x40, 0x03, 0x64, 0x01, 0x00, 0x65, 0x35,
+  0x7f, 0xff, 0xff, 0x35, 0x35, 0x35, 0x06, 0x12, 0x01, 0x4e, 0xcf, 0x4f, 0xb5, 0xb5, 0x0b, 0x02,
+  0xcd, 0x03, 0x4b, 0xdf, 0x0f, 0x11, 0x62, 0x06, 0xd9, 0x03, 0xc0, 0x03, 0x83, 0x00,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t fullSource[] = {
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t fullTarget[] = {
+  0x4d, 0xcb, 0x4d, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x07, 0x20, 0xf2,
+  0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2,
+  0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42,
+  0x42, 0x20, 0x77, 0x42, 0xbd, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x4d, 0x20, 0x21, 0xf2, 0x51, 0x06,
+  0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf0, 0x21, 0xcb, 0xc7, 0x51, 0xf2, 0xc7, 0x21, 0xf2,
+  0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42,
+  0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21,
+  0xf2, 0x20, 0x21, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd,
+  0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2,
+  0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0,
+  0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20, 0x21, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20,
+  0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0,
+  0x42, 0x42, 0x20, 0x77, 0x42, 0xbd, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x4d, 0x20, 0x21, 0xf2, 0x51,
+  0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x51, 0x21, 0xf2, 0x4d, 0x20, 0x21, 0xf2, 0x51, 0x06,
+  0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x9a, 0x62, 0x15, 0x84, 0x9a,
+  0x0f, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20,
+  0x21, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x9a, 0x76, 0x06, 0x21, 0xf2, 0x20, 0x21, 0x20,
+  0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0x42,
+  0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20,
+  0x21, 0xf2, 0x84, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x07,
+  0x20, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0x15, 0xf2,
+  0xcb, 0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21,
+  0x15, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x07,
+  0x20, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20,
+  0x21, 0x15, 0x4d, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2,
+  0x20, 0x21, 0xf2, 0x84, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb,
+  0x0f, 0x15, 0x20, 0x20, 0x51, 0x21, 0xf2, 0x4d, 0x20, 0x21, 0xf2, 0x51, 0xf2, 0x51, 0x06, 0xf0,
+  0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20, 0x21, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20,
+  0x9a, 0x76, 0x06, 0x21, 0xf2, 0x20, 0x21, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x0f,
+  0x21, 0xf2, 0x20, 0x21, 0x15, 0x4d, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2,
+  0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x84, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20,
+  0x9a, 0x62, 0x84, 0x20, 0xf2, 0x42, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x0f, 0x15, 0x20, 0x20, 0x51,
+  0x21, 0xf2, 0x4d, 0x20, 0x21, 0xf2, 0x51, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20,
+  0x21, 0xf2, 0x20, 0x21, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0x4d, 0x79, 0xf2, 0x42, 0xf0, 0x20, 0x20,
+  0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0xc7, 0x42,
+  0x51, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20,
+  0xf2, 0x20, 0x21, 0xf2, 0x07, 0x42, 0xf0, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42,
+  0x42, 0x20, 0x77, 0x42, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x79,
+  0x20, 0x42, 0x84, 0xf2, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb,
+  0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0xc7, 0x42, 0x51, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42,
+  0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x4d, 0x79, 0x21, 0x42, 0xbd, 0xbd, 0xbd, 0x21, 0x21,
+  0xf2, 0x42, 0xbd, 0x4d, 0xf0, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x84, 0x42, 0xf0,
+  0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x0f, 0x15, 0x20, 0x20, 0x51, 0x21,
+  0xf3, 0xcb, 0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20,
+  0x21, 0x15, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x77,
+  0x07, 0x4d, 0xcb, 0x20, 0xf2, 0x20, 0x21, 0x15, 0x4d, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51,
+  0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x84, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20,
+  0x21, 0xf2, 0x20, 0x21, 0x07, 0x42, 0x4d, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x4d, 0x79, 0x21, 0x42,
+  0xbd, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x42, 0xbd, 0x4d, 0xf0, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20,
+  0x21, 0xf2, 0x84, 0x42, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0xf0, 0x0f, 0x79, 0x20, 0x21, 0xf2, 0xcb,
+  0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0xc7, 0x42, 0x51, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42,
+  0xbd, 0x84, 0x79, 0xf3, 0x07, 0x77, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20,
+  0x89, 0xc7, 0x9a, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0x15, 0xf2, 0xcb, 0x07, 0x20,
+  0xf2, 0x20, 0x21, 0xf2, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0x15, 0x4d, 0xf0,
+  0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0x20, 0x4d, 0x20, 0xf0, 0x0f, 0x79,
+  0x20, 0x21, 0xf2, 0xcb, 0x07, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0xc7, 0x42, 0x51, 0xbd, 0x21, 0x42,
+  0x42, 0x20, 0x77, 0x42, 0xbd, 0x84, 0x79, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d,
+  0xf0, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0x20, 0x15, 0xbd, 0xbd,
+  0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x84, 0x79,
+  0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd,
+  0x21, 0x21, 0xf2, 0x20, 0x21, 0x20, 0x15, 0xbd, 0xbd, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20, 0x21,
+  0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21,
+  0x42, 0xf2, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15, 0xbd, 0xbd, 0x21, 0x42,
+  0x42, 0x20, 0x77, 0x42, 0x77, 0x07, 0x4d, 0xf0, 0x9a, 0x51, 0x89, 0x20, 0xf2, 0x20, 0x21, 0xf2,
+  0x20, 0x21, 0xf2, 0x62, 0xbd, 0xf0, 0x20, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x9a, 0xf2, 0x42,
+  0x20, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21, 0xf2, 0x20, 0x21, 0x15, 0xbd, 0xbd, 0x21,
+  0x21, 0xf2, 0x20, 0x15, 0xc7, 0x42, 0x51, 0xbd, 0x21, 0x42, 0x42, 0x20, 0x77, 0x42, 0xbd, 0x84,
+  0x79, 0xf3, 0x07, 0x77, 0xf0, 0x9a, 0x51, 0xcb, 0x07, 0xbd, 0x84, 0x4d, 0x06, 0x20, 0x9a, 0x9a,
+  0x15, 0x21, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x62, 0xbd, 0xf0, 0x20, 0x20, 0xf2,
+  0x20, 0x21, 0xf2, 0x20, 0x9a, 0xf2, 0x42, 0x20, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x20, 0x21,
+  0xf2, 0x20, 0x21, 0xc7, 0x20, 0x06, 0x20, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0xcb, 0x0f,
+  0x15, 0x20, 0xf0, 0x0f, 0x62, 0x4d, 0x20, 0x77, 0x62, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20,
+  0x15, 0xbd, 0xbd, 0x21, 0x42, 0xf2, 0xbd, 0xbd, 0x21, 0x21, 0xf2, 0x20, 0x21, 0xf2, 0x20, 0x15,
+  0xbd, 0xbd, 0x21, 0x42, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0x15, 0xbd, 0xbd, 0x21, 0x42, 0xf2, 0xbd,
+  0xbd, 0x21, 0x21, 0xf2, 0x20, 0x0f, 0x51, 0x20, 0x0f, 0x51, 0x21, 0xf2, 0xcb, 0x07, 0x20, 0xf2,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t fullDelta[] = {
+  0x4c, 0x42, 0x44, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb0, 0x04, 0x00, 0x00, 0xdd, 0x48, 0x2d, 0x02,
+  0x22, 0x1f, 0x8a, 0x5c, 0xff, 0xfc, 0xbf, 0xc8, 0x4d, 0x85, 0xdc, 0xb5, 0xff, 0x03, 0xb0, 0x04,
+  0x00, 0x00, 0x4d, 0xcb, 0x4d, 0x77, 0x20, 0x21, 0xf2, 0x00, 0x83, 0xcb, 0x07, 0x20, 0x01, 0x81,
+  0x7f, 0x51, 0x06, 0xf0, 0x20, 0x0f, 0x15, 0x20, 0x05, 0x84, 0xef, 0x15, 0xbd, 0xbd, 0x21, 0x02,
+  0x47, 0x42, 0x42, 0x20, 0xc7, 0x77, 0x42, 0xbd, 0x04, 0x82, 0x0d, 0xc1, 0x0a, 0x86, 0xf0, 0x21,
+  0xdf, 0xcb, 0xc7, 0x51, 0xf2, 0xc7, 0x0b, 0xd3, 0x77, 0x07, 0x73, 0x4d, 0xf0, 0x06, 0x48, 0x08,
+  0x95, 0x9a, 0x51, 0x89, 0x1f, 0xc2, 0xc8, 0x22, 0x53, 0x0d, 0x14, 0x24, 0x14, 0x51, 0x03, 0x8c,
+  0x01, 0xc1, 0x9a, 0x62, 0xef, 0x15, 0x84, 0x9a, 0x0f, 0x15, 0xd4, 0x9a, 0x76, 0x06, 0x5e, 0x26,
+  0xe4, 0x84, 0x42, 0xf0, 0x20, 0x29, 0xd5, 0x15, 0x04, 0x4f, 0xa2, 0x35, 0xde, 0x4d, 0x18, 0x1a,
+  0x33, 0x09, 0x2d, 0xe0, 0x0f, 0x14, 0x9d, 0x9a, 0xdf, 0x62, 0x84, 0x20, 0xf2, 0x42, 0x16, 0xa0,
+  0x4d, 0x79, 0x5d, 0xf2, 0x3a, 0x0f, 0xc7, 0x42, 0x51, 0x45, 0x10, 0x07, 0x0a, 0x00, 0xbc, 0x4c,
+  0x09, 0x02, 0x88, 0x79, 0x20, 0x42, 0x84, 0x11, 0xe1, 0x4d, 0x7b, 0x79, 0x21, 0x71, 0x44, 0x42,
+  0xbd, 0x4d, 0xf0, 0x42, 0x58, 0xc9, 0xf3, 0x58, 0x1b, 0x13, 0x80, 0xcb, 0x02, 0xc1, 0x55, 0x5a,
+  0x07, 0x42, 0xdd, 0x4d, 0x1d, 0x1f, 0xf0, 0x0f, 0x79, 0x2b, 0xd1, 0xbd, 0x84, 0xef, 0x79, 0xf3,
+  0x07, 0x77, 0x16, 0x07, 0x89, 0xc7, 0x9a, 0x86, 0x7f, 0x24, 0x20, 0x4d, 0x14, 0xd8, 0xca, 0x24,
+  0x0a, 0x18, 0xec, 0x15, 0xf2, 0x76, 0xb4, 0x1e, 0x62, 0xbd, 0x87, 0x06, 0xf2, 0x42, 0x20, 0x98,
+  0x8f, 0xfd, 0x15, 0x3f, 0x50, 0xcb, 0x07, 0xbd, 0x84, 0x4d, 0x06, 0xdf, 0x20, 0x9a, 0x9a, 0x15,
+  0x21, 0x11, 0x9e, 0xc7, 0x20, 0xfd, 0x06, 0x71, 0x09, 0xf0, 0x0f, 0x62, 0x4d, 0x20, 0x77, 0x31,
+  0x62, 0x28, 0xd8, 0x01, 0x07, 0x06, 0x04, 0x0f, 0x51, 0x00, 0x80, 0x4e, 0x03, 0x01, 0x00,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t runsSource[] = {
+  0x82, 0xb7, 0x0e, 0xee, 0x7f, 0x1a, 0x50, 0x39, 0xbe, 0xf0, 0x7e, 0xc2, 0x34, 0x7f, 0x06, 0x6e,
+  0xd0, 0x8f, 0x5d, 0xc7, 0x51, 0x24, 0x47, 0xe3, 0x40, 0x43, 0x00, 0x02, 0x6b, 0x6e, 0x54, 0x55,
+  0x94, 0xa0, 0x65, 0x68, 0x5d, 0x64, 0xc4, 0x98, 0x0b, 0xb8, 0xd4, 0x54, 0x4a, 0x87, 0x21, 0xa9,
+  0x9a, 0x01, 0xad, 0x21, 0x9e, 0xb5, 0x9c, 0xf6, 0xa1, 0x5e, 0xf6, 0xf1, 0x5a, 0x1d, 0x83, 0x0b,
+  0xb7, 0xce, 0x09, 0xd6, 0xbb, 0xc0, 0x04, 0xe7, 0x17, 0x5c, 0x64, 0x3c, 0x7d, 0xec, 0xb0, 0xb5,
+  0x80, 0xec, 0x37, 0xbc, 0x97, 0x12, 0xdd, 0x2e, 0x6a, 0xae, 0xb9, 0x4b, 0xae, 0x8d, 0x2f, 0x9f,
+  0xa2, 0x9c, 0x5a, 0x28, 0x4c, 0x9e, 0xf7, 0x52, 0x18, 0x29, 0xcf, 0x10, 0x79, 0xb0, 0x80, 0xe9,
+  0xd7, 0x4a, 0x1c, 0x10, 0xfc, 0xab, 0x6a, 0x42, 0x43, 0xd3, 0x36, 0x56, 0xde, 0xbe, 0x4c, 0x1e,
+  0xd7, 0x96, 0x48, 0xe8, 0x56, 0xe8, 0xf9, 0xa2, 0xf5, 0x8c, 0x95, 0xf0, 0xce, 0x4b, 0x39, 0xc1,
+  0x5b, 0xff, 0xad, 0x5c, 0x2d, 0xfb, 0x8b, 0xb8, 0x20, 0xb6, 0x11, 0x9c, 0xba, 0x8f, 0xf8, 0x87,
+  0x96, 0xae, 0x5b, 0x05, 0xf2, 0x80, 0xa6, 0x8c, 0xed, 0x93, 0xb6, 0xb2, 0x8c, 0xb0, 0xd1, 0xb3,
+  0x58, 0xe6, 0xba, 0xab, 0x48, 0x55, 0x65, 0xb9, 0xf4, 0x90, 0x28, 0xd5, 0x57, 0xd7, 0x9a, 0x8a,
+  0x0e, 0x64, 0x51, 0xe1, 0x5c, 0x70, 0x5c, 0x15, 0xf1, 0x73, 0x54, 0x1b, 0x44, 0x38, 0xa2, 0x5c,
+  0xf7, 0x63, 0x12, 0xd4, 0xee, 0xb3, 0xc2, 0x24, 0x68, 0x79, 0xbf, 0x00, 0xb3, 0xcf, 0x8e, 0xd1,
+  0x3a, 0xbf, 0x12, 0x9a, 0x30, 0x97, 0xad, 0x96, 0xb4, 0x42, 0xd6, 0xd1, 0xbd, 0xef, 0x48, 0x50,
+  0xc3, 0xf4, 0x65, 0x44, 0x2e, 0xb3, 0x00, 0xc3, 0x37, 0xa6, 0x48, 0xa6, 0xc0, 0xdb, 0xdd, 0x73,
+  0xfc, 0x95, 0xf5, 0xc2, 0xc4, 0x51, 0x85, 0x9a, 0xfe, 0x80, 0xd4, 0x0a, 0xa3, 0x9d, 0xfb, 0x92,
+  0x49, 0xf4, 0x0c, 0x3e, 0xe3, 0x7d, 0x96, 0x14, 0x45, 0xc8, 0x06, 0xf5, 0x8c, 0x7c, 0xf2, 0x12,
+  0x7d, 0xfa, 0x89, 0x4f, 0x92, 0x96, 0xfc, 0xf3, 0x3c, 0x08, 0x40, 0x99, 0x90, 0xac, 0x97, 0x0d,
+  0xed, 0xb3, 0xb8, 0x43, 0x12, 0x01, 0x81, 0xe9, 0x37, 0x61, 0x07, 0xdb, 0xda, 0xf6, 0xc5, 0xf3,
+  0xc8, 0x64, 0x97, 0xee, 0x21, 0x9b, 0x01, 0xdd, 0x92, 0xf1, 0x9f, 0x49, 0x54, 0xf4, 0xfe, 0xa9,
+  0x4e, 0xd9, 0x18, 0x23, 0x75, 0x88, 0x2b, 0x20, 0x0d, 0xaa, 0xdb, 0x23, 0xcf, 0xf9, 0x19, 0x3f,
+  0x3e, 0x70, 0x38, 0x44, 0x95, 0xe0, 0x4c, 0x5d, 0x5e, 0xd3, 0x52, 0x22, 0x6d, 0x16, 0x37, 0xc2,
+  0x24, 0x8f, 0x1d, 0x3c, 0xcc, 0x44, 0x05, 0xdd, 0x2e, 0xa1, 0xfa, 0xfa, 0xb4, 0xbf, 0x1c, 0x46,
+  0x96, 0x4d, 0x94, 0x70, 0x86, 0x20, 0x78, 0x82, 0x91, 0x44, 0x78, 0xbe, 0xe8, 0xc7, 0x5b, 0x43,
+  0x09, 0xae, 0x2b, 0x12, 0x2e, 0x3f, 0xe8, 0x7a, 0xc7, 0xec, 0xf5, 0xa5, 0x37, 0x0f, 0xc4, 0x1b,
+  0x4d, 0xdb, 0x72, 0x3b, 0x2a, 0xfb, 0x6c, 0x47, 0xc0, 0xb5, 0x78, 0x94, 0xaa, 0xb2, 0xc5, 0xc1,
+  0x45, 0xb7, 0x97, 0xdd, 0xb9, 0x12, 0x6e, 0x5c, 0xca, 0x20, 0x31, 0x12, 0x10, 0x5f, 0x67, 0x64,
+  0x14, 0xfa, 0xf6, 0xb2, 0x00, 0xda, 0xf0, 0x99, 0xdb, 0xa5, 0xee, 0xec, 0x33, 0x62, 0x4f, 0x51,
+  0x24, 0xbf, 0xc5, 0xf0, 0x4d, 0x82, 0x38, 0x8e, 0x52, 0x92, 0x78, 0x10, 0xf6, 0x10, 0xb0, 0xbc,
+  0xa1, 0x1e, 0x0b, 0xe9, 0xf1, 0x4f, 0x3c, 0xa6, 0x95, 0xe8, 0x7a, 0x53, 0x11, 0x66, 0x0c, 0x76,
+  0x28, 0xcd, 0xba, 0x9f, 0x5e, 0xef, 0xb9, 0x90, 0x22, 0xef, 0x53, 0x7b, 0x59, 0x6a, 0x16, 0xdc,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t runsTarget[] = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4c, 0x9e, 0xf7, 0x52, 0x18, 0x29, 0xcf, 0x10,
+  0x79, 0xb0, 0x80, 0xe9, 0xd7, 0x4a, 0x1c, 0x10, 0xfc, 0xab, 0x6a, 0x42, 0x43, 0xd3, 0x36, 0x56,
+  0xde, 0xbe, 0x4c, 0x1e, 0xd7, 0x96, 0x48, 0xe8, 0x56, 0xe8, 0xf9, 0xa2, 0xf5, 0x8c, 0x95, 0xf0,
+  0xce, 0x4b, 0x39, 0xc1, 0x5b, 0xff, 0xad, 0x5c, 0x2d, 0xfb, 0x8b, 0xb8, 0x20, 0xb6, 0x11, 0x9c,
+  0xba, 0x8f, 0xf8, 0x87, 0x96, 0xae, 0x5b, 0x05, 0xf2, 0x80, 0xa6, 0x8c, 0xed, 0x93, 0xb6, 0xb2,
+  0x8c, 0xb0, 0xd1, 0xb3, 0x58, 0xe6, 0xba, 0xab, 0x48, 0x55, 0x65, 0xb9, 0xf4, 0x90, 0x28, 0xd5,
+  0x57, 0xd7, 0x9a, 0x8a, 0x0e, 0x64, 0x51, 0xe1, 0x5c, 0x70, 0x5c, 0x15, 0xf1, 0x73, 0x54, 0x1b,
+  0x44, 0x38, 0xa2, 0x5c, 0xf7, 0x63, 0x12, 0xd4, 0xee, 0xb3, 0xc2, 0x24, 0x68, 0x79, 0xbf, 0x00,
+  0xb3, 0xcf, 0x8e, 0xd1, 0x3a, 0xbf, 0x12, 0x9a, 0x30, 0x97, 0xad, 0x96, 0xb4, 0x42, 0xd6, 0xd1,
+  0xbd, 0xef, 0x48, 0x50, 0xc3, 0xf4, 0x65, 0x44, 0x2e, 0xb3, 0x00, 0xc3, 0x37, 0xa6, 0x48, 0xa6,
+  0xc0, 0xdb, 0xdd, 0x73, 0xfc, 0x95, 0xf5, 0xc2, 0xc4, 0x51, 0x85, 0x9a, 0xfe, 0x80, 0xd4, 0x0a,
+  0xa3, 0x9d, 0xfb, 0x92, 0x49, 0xf4, 0x0c, 0x3e, 0xe3, 0x7d, 0x96, 0x14, 0x45, 0xc8, 0x06, 0xf5,
+  0x8c, 0x7c, 0xf2, 0x12, 0x7d, 0xfa, 0x89, 0x4f, 0x92, 0x96, 0xfc, 0xf3, 0x3c, 0x08, 0x40, 0x99,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5,
+  0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0xa5, 0x8a, 0x03, 0xec, 0x1f,
+  0xe7, 0xd2, 0x56, 0x17, 0x11, 0xb3, 0x30, 0x24, 0x79, 0xfb, 0x2f, 0xf1, 0x1b, 0x7c, 0x19, 0xfe,
+  0xcb, 0x1e, 0x18, 0x82, 0xd0, 0xe4, 0x9c, 0x1a, 0x13, 0x63, 0x5b, 0xce, 0x60, 0x77, 0x2b, 0xa0,
+  0x37, 0x2c, 0x52, 0x26, 0x6d, 0x08, 0xe1, 0xb7, 0xf9, 0xd8, 0xc0, 0x43, 0x06, 0x9d, 0xe5, 0x72,
+  0x3b, 0x47, 0x9f, 0xf7, 0x2c, 0x86, 0xce, 0xa0, 0x43, 0x42, 0x29, 0xf1, 0x7d, 0x2b, 0xdb, 0x7d,
+  0x8d, 0x1f, 0xfc, 0x7f, 0x18, 0x66, 0x92, 0xbf, 0x32, 0x24, 0xd7, 0xa0,
+  0x00  // keeps an empty image a valid array
+};
+
+static const uint8_t runsDelta[] = {
+  0x4c, 0x42, 0x44, 0x31, 0x00, 0x02, 0x00, 0x00, 0xa7, 0xb7, 0xdd, 0x22, 0x8c, 0xc0, 0x96, 0x2c,
+  0xbf, 0xaf, 0x1b, 0xff, 0xc6, 0xb9, 0x35, 0x6e, 0x9c, 0x04, 0x00, 0x00, 0x86, 0x72, 0x8b, 0x91,
+  0xb3, 0x91, 0x6b, 0x4e, 0x68, 0xf5, 0x8b, 0x23, 0x1b, 0x4c, 0x39, 0x1b, 0x0f, 0x03, 0x58, 0x02,
+  0x00, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x3f, 0xc0, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x3f,
+  0x00, 0x3f, 0x00, 0x3f, 0x00, 0x04, 0x01, 0x64, 0xfa, 0x01, 0x00, 0xc8, 0x00, 0xc0, 0x03, 0x7c,
+  0x01, 0x00, 0x00, 0xc1, 0xa5, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x3f, 0x00, 0x20, 0x8a,
+  0x03, 0xff, 0xec, 0x1f, 0xe7, 0xd2, 0x56, 0x17, 0x11, 0xb3, 0xff, 0x30, 0x24, 0x79, 0xfb, 0x2f,
+  0xf1, 0x1b, 0x7c, 0xff, 0x19, 0xfe, 0xcb, 0x1e, 0x18, 0x82, 0xd0, 0xe4, 0xff, 0x9c, 0x1a, 0x13,
+  0x63, 0x5b, 0xce, 0x60, 0x77, 0xff, 0x2b, 0xa0, 0x37, 0x2c, 0x52, 0x26, 0x6d, 0x08, 0xff, 0xe1,
+  0xb7, 0xf9, 0xd8, 0xc0, 0x43, 0x06, 0x9d, 0xff, 0xe5, 0x72, 0x3b, 0x47, 0x9f, 0xf7, 0x2c, 0x86,
+  0xff, 0xce, 0xa0, 0x43, 0x42, 0x29, 0xf1, 0x7d, 0x2b, 0xff, 0xdb, 0x7d, 0x8d, 0x1f, 0xfc, 0x7f,
+  0x18, 0x66, 0x7f, 0x92, 0xbf, 0x32, 0x24, 0xd7, 0xa0, 0x00,
+  0x00  // keeps an empty image a valid array
+};
+
+struct DeltaFixture {
+  const char* name;
+  const uint8_t* source;
+  uint32_t sourceSize;
+  const uint8_t* target;
+  uint32_t targetSize;
+  const uint8_t* delta;
+  uint32_t deltaSize;
+};
+
+static const DeltaFixture fixtures[] = {
+  { "addNearStart", addNearStartSource, 1024, addNearStartTarget, 1024, addNearStartDelta, 82 },
+  { "shifted", shiftedSource, 1024, shiftedTarget, 1136, shiftedDelta, 142 },
+  { "full", fullSource, 0, fullTarget, 1200, fullDelta, 319 },
+  { "runs", runsSource, 512, runsTarget, 1180, runsDelta, 186 },
+};
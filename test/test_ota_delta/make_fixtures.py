@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Writes fixtures.h for test_main.cpp: pairs of images and the deltas
+tools/make_delta.py makes between them, checked with its --apply path.
+
+  python3 test/test_ota_delta/make_fixtures.py
+"""
+import os
+import random
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, "..", "..", "tools"))
+import make_delta  # noqa: E402
+
+
+def code_like(rng, n):
+    """Bytes from a small alphabet with repeats, so LZSS finds references."""
+    alphabet = bytes(rng.randrange(256) for _ in range(24))
+    out = bytearray()
+    while len(out) < n:
+        if out and rng.random() < 0.3:
+            start = rng.randrange(len(out))
+            out += out[start:start + rng.randrange(3, 40)]
+        else:
+            out.append(rng.choice(alphabet))
+    return bytes(out[:n])
+
+
+def bump(data, every):
+    return bytes((b + 1) & 0xFF if k % every == 0 else b for k, b in enumerate(data))
+
+
+def add_near_start():
+    # COPY 0..40, then an ADD reading the running image from address 40
+    rng = random.Random(57)
+    old = bytes(rng.randrange(256) for _ in range(1024))
+    return old, old[:40] + bump(old[40:400], 7) + old[400:]
+
+
+def shifted():
+    # code moved by a few bytes, with its addresses changed further on
+    rng = random.Random(11)
+    old = code_like(rng, 1024)
+    new = old[:300] + bytes(rng.randrange(256) for _ in range(12)) + old[300:600] + bump(old[600:900], 5) + old[900:]
+    return old, new + code_like(rng, 100)
+
+
+def full():
+    return b"", code_like(random.Random(3), 1200)
+
+
+def runs():
+    # long runs give references of the longest length and farthest distance
+    rng = random.Random(5)
+    old = bytes(rng.randrange(256) for _ in range(512))
+    return old, bytes(600) + old[100:300] + bytes([0xA5]) * 300 + bytes(rng.randrange(256) for _ in range(80))
+
+
+CASES = [("addNearStart", add_near_start), ("shifted", shifted), ("full", full), ("runs", runs)]
+
+
+def array(name, data):
+    lines = [f"static const uint8_t {name}[] = {{"]
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join(f"0x{b:02x}" for b in data[i:i + 16]) + ",")
+    lines.append("  0x00  // keeps an empty image a valid array")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    parts = ["// Generated by make_fixtures.py from tools/make_delta.py, do not edit", "", "#pragma once", "",
+             "#include <stdint.h>", ""]
+    entries = []
+    for name, make in CASES:
+        old, new = make()
+        delta, _ = make_delta.make_delta(old, new)
+        if make_delta.apply_delta(old, delta) != new:
+            sys.exit(f"{name}: delta does not reproduce the new image")
+        parts += [array(name + "Source", old), "", array(name + "Target", new), "", array(name + "Delta", delta), ""]
+        entries.append(f"  {{ \"{name}\", {name}Source, {len(old)}, {name}Target, {len(new)}, {name}Delta, {len(delta)} }},")
+
+    parts += ["struct DeltaFixture {", "  const char* name;", "  const uint8_t* source;", "  uint32_t sourceSize;",
+              "  const uint8_t* target;", "  uint32_t targetSize;", "  const uint8_t* delta;", "  uint32_t deltaSize;",
+              "};", "", "static const DeltaFixture fixtures[] = {"] + entries + ["};", ""]
+    with open(os.path.join(HERE, "fixtures.h"), "w") as f:
+        f.write("\n".join(parts))
+
+
+if __name__ == "__main__":
+    main()
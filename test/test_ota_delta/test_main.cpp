@@ -0,0 +1,119 @@
+#include <unity.h>
+#include <ota_delta.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "fixtures.h"
+
+/*
+  Host tests for the delta decoder: every delta in fixtures.h, fed in
+  slices of several sizes, must rebuild its target exactly.
+
+  pio test -e native -f test_ota_delta
+*/
+
+static const DeltaFixture* fixture = nullptr;
+static std::vector<uint8_t> target;
+
+static bool readSource(uint32_t address, uint8_t* data, size_t length) {
+  if (address > fixture->sourceSize || length > fixture->sourceSize - address) {
+    return false;
+  }
+  memcpy(data, fixture->source + address, length);
+  return true;
+}
+
+static bool writeTarget(const uint8_t* data, size_t length) {
+  target.insert(target.end(), data, data + length);
+  return true;
+}
+
+static uint32_t headerField(const DeltaFixture& f, size_t offset) {
+  const uint8_t* p = f.delta + offset;
+  return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Decodes a fixture's body slice by slice; true if it finished without error
+static bool decode(const DeltaFixture& f, size_t slice, uint32_t targetSize) {
+  fixture = &f;
+  target.clear();
+  beginOtaDelta(headerField(f, 4), targetSize, readSource, writeTarget);
+  for (size_t offset = 44; offset < f.deltaSize; offset += slice) {
+    size_t length = f.deltaSize - offset < slice ? f.deltaSize - offset : slice;
+    if (!applyOtaDelta(f.delta + offset, length)) {
+      return false;
+    }
+  }
+  return isOtaDeltaDone();
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_header_matches_fixture() {
+  for (const DeltaFixture& f : fixtures) {
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(0x3144424C, headerField(f, 0), f.name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(f.sourceSize, headerField(f, 4), f.name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(f.targetSize, headerField(f, 24), f.name);
+  }
+}
+
+static void test_rebuilds_target_in_any_slices() {
+  static const size_t slices[] = { 1, 2, 3, 7, 64, 255, 1024, 1 << 20 };
+  for (const DeltaFixture& f : fixtures) {
+    for (size_t slice : slices) {
+      char message[64];
+      snprintf(message, sizeof(message), "%s in %u byte slices", f.name, (unsigned)slice);
+      TEST_ASSERT_TRUE_MESSAGE(decode(f, slice, f.targetSize), message);
+      TEST_ASSERT_NULL_MESSAGE(otaDeltaFailure(), message);
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(f.targetSize, otaDeltaOutput(), message);
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(f.targetSize, target.size(), message);
+      TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(f.target, target.data(), f.targetSize, message);
+    }
+  }
+}
+
+// An ADD that starts below OTA_SOURCE_CHUNK must read the image, not stale buffer bytes
+static void test_add_near_start_reads_source() {
+  const DeltaFixture& f = fixtures[0];
+  TEST_ASSERT_EQUAL_STRING("addNearStart", f.name);
+  TEST_ASSERT_TRUE(decode(f, 1 << 20, f.targetSize));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(f.target, target.data(), f.targetSize);
+}
+
+static void test_decoder_starts_clean() {
+  // a failed run must not leave anything behind for the next one
+  TEST_ASSERT_FALSE(decode(fixtures[1], 64, fixtures[1].targetSize - 1));
+  TEST_ASSERT_EQUAL_STRING("patch runs past the target size", otaDeltaFailure());
+  for (const DeltaFixture& f : fixtures) {
+    TEST_ASSERT_TRUE_MESSAGE(decode(f, 64, f.targetSize), f.name);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(f.target, target.data(), f.targetSize, f.name);
+  }
+}
+
+static void test_short_target_fails() {
+  for (const DeltaFixture& f : fixtures) {
+    TEST_ASSERT_FALSE_MESSAGE(decode(f, 64, f.targetSize + 1), f.name);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("patch ended short of the target size", otaDeltaFailure(), f.name);
+  }
+}
+
+static void test_read_past_source_fails() {
+  const DeltaFixture& f = fixtures[0];
+  fixture = &f;
+  target.clear();
+  beginOtaDelta(20, f.targetSize, readSource, writeTarget);  // COPY 0..40 no longer fits
+  TEST_ASSERT_FALSE(applyOtaDelta(f.delta + 44, f.deltaSize - 44));
+  TEST_ASSERT_EQUAL_STRING("patch reads past the running image", otaDeltaFailure());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_header_matches_fixture);
+  RUN_TEST(test_rebuilds_target_in_any_slices);
+  RUN_TEST(test_add_near_start_reads_source);
+  RUN_TEST(test_decoder_starts_clean);
+  RUN_TEST(test_short_target_fails);
+  RUN_TEST(test_read_past_source_fails);
+  return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Updater.h>
+#include <host.h>
+#include <log.h>
+#include <ota_update.h>
+#include <string>
+#include <vector>
+#include "../test_ota_delta/fixtures.h"
+
+/*
+  Host tests for the update flow around the decoder: Update.end() leaves
+  the eboot command in RTC user words 0-31, and whatever the firmware
+  logs before it restarts must leave them intact, or the bootloader
+  boots the old image.
+
+  pio test -e native -f test_ota_update
+*/
+
+static const DeltaFixture& fixture = fixtures[1];  // "shifted", a delta against a source
+
+static void clearEbootCommand() {
+  uint32_t zeros[32] = {};
+  ESP.rtcUserMemoryWrite(0, zeros, sizeof(zeros));
+}
+
+// A BINARY_OTA payload: offset, then the delta from there on
+static std::vector<uint8_t> deltaFrame(uint32_t offset) {
+  std::vector<uint8_t> frame;
+  for (int i = 0; i < 4; i++) {
+    frame.push_back(offset >> (8 * i));
+  }
+  frame.insert(frame.end(), fixture.delta + offset, fixture.delta + fixture.deltaSize);
+  return frame;
+}
+
+static bool contains(const std::string& data, const char* part) {
+  return data.find(part) != std::string::npos;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_verified_update_keeps_eboot_command() {
+  TEST_ASSERT_EQUAL_STRING("shifted", fixture.name);
+  hostSetWebSocketConnected(true);
+  hostSetSketch(std::vector<uint8_t>(fixture.source, fixture.source + fixture.sourceSize));
+  LittleFS.begin();
+  logBegin();
+  clearEbootCommand();
+
+  // The whole delta in one frame: only the header is taken while the running image is saved
+  std::vector<uint8_t> frame = deltaFrame(0);
+  receiveOtaChunk(frame.data(), frame.size());
+  TEST_ASSERT_TRUE(isOtaRunning());
+  size_t sent = hostSentFrames().size();
+  for (int pass = 0; pass < 100 && hostSentFrames().size() == sent; pass++) {
+    otaTick();
+  }
+  TEST_ASSERT_EQUAL(sent + 1, hostSentFrames().size());
+  TEST_ASSERT_EQUAL_STRING("{\"type\": \"ota\", \"next\": 44}", hostSentFrames().back().payload.c_str());
+  TEST_ASSERT_TRUE(LittleFS.exists(OTA_ROLLBACK_PATH));
+
+  frame = deltaFrame(OTA_HEADER_SIZE);
+  bool restarted = false;
+  try {
+    receiveOtaChunk(frame.data(), frame.size());
+  } catch (const HostRestart&) {
+    restarted = true;
+  }
+
+  TEST_ASSERT_TRUE_MESSAGE(restarted, hostSerialOutput().c_str());
+  TEST_ASSERT_TRUE(contains(hostSentFrames().back().payload, "\"done\""));
+  TEST_ASSERT_TRUE(contains(hostSerialOutput(), "Update verified"));
+  TEST_ASSERT_EQUAL_UINT32(fixture.targetSize, Update.image.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(fixture.target, Update.image.data(), fixture.targetSize);
+  TEST_ASSERT_TRUE(hostEbootCommandValid());
+}
+
+// The image on trial crashes OTA_TRIAL_BOOTS times, and the saved one is flashed back
+static void test_rollback_keeps_eboot_command() {
+  TEST_ASSERT_TRUE(LittleFS.exists(OTA_STATE_PATH));
+  TEST_ASSERT_TRUE(LittleFS.exists(OTA_ROLLBACK_PATH));
+  clearEbootCommand();
+  hostSetResetReason(REASON_EXCEPTION_RST);
+
+  bool restarted = false;
+  for (int boot = 0; boot < OTA_TRIAL_BOOTS && !restarted; boot++) {
+    try {
+      otaBootCheck();
+    } catch (const HostRestart&) {
+      restarted = true;
+    }
+  }
+
+  TEST_ASSERT_TRUE_MESSAGE(restarted, hostSerialOutput().c_str());
+  TEST_ASSERT_TRUE(contains(hostSerialOutput(), "Rolled back"));
+  TEST_ASSERT_EQUAL_UINT32(fixture.sourceSize, Update.image.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(fixture.source, Update.image.data(), fixture.sourceSize);
+  TEST_ASSERT_TRUE(hostEbootCommandValid());
+  TEST_ASSERT_FALSE(LittleFS.exists(OTA_STATE_PATH));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_verified_update_keeps_eboot_command);
+  RUN_TEST(test_rollback_keeps_eboot_command);
+  return UNITY_END();
+}
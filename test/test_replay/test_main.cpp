@@ -0,0 +1,167 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WebSocketsClient.h>
+#include <host.h>
+#include <trace.h>
+#include <string>
+#include <vector>
+
+/*
+  Replays a trace through setup() and loop() on the host stand-ins
+  (host/lovebox_host) and checks what the firmware sent and stored. Both
+  clocks advance TRACE_REPLAY_STEP_MS per pass, so a run is the same on
+  every machine; a trace recorded on a device ('r' on Serial) can be
+  dropped in the same way to pin down a bug it shows.
+
+  pio test -e native -f test_replay
+*/
+
+#define TOUCH_PIN 12
+#define MISS_BUTTON_PIN 13
+#define MAX_PASSES 10000
+
+void setup();
+void loop();
+
+static std::string trace;
+
+static void putVarint(uint32_t value) {
+  while (value >= 0x80) {
+    trace += (char)((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  trace += (char)value;
+}
+
+static void putLe32(uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    trace += (char)(value >> (8 * i));
+  }
+}
+
+static void record(TraceRecordType type, uint32_t afterMs) {
+  trace += (char)type;
+  putVarint(afterMs);
+}
+
+static void text(uint32_t afterMs, const char* frame) {
+  record(TRACE_WS_TEXT, afterMs);
+  putVarint(strlen(frame));
+  trace += frame;
+}
+
+static void pin(uint32_t afterMs, uint8_t number, uint8_t level) {
+  record(TRACE_GPIO, afterMs);
+  trace += (char)number;
+  trace += (char)level;
+}
+
+/*
+  A connect, then seq 1, its resend, seq 3 ahead of seq 2, seq 2 closing
+  the gap and a seq too far ahead to track; then the message is touched
+  and the miss-you button pressed.
+*/
+static void buildTrace() {
+  trace = "TRC1";
+  record(TRACE_START, 0);
+  putLe32(1234);        // random seed
+  putLe32(1760000000);  // clock
+  putLe32(2000);        // millis()
+  record(TRACE_WIFI, 0);
+  trace += (char)WL_CONNECTED;
+  record(TRACE_CLOCK, 0);
+  putLe32(1760000000);
+  record(TRACE_WS_EVENT, 100);
+  trace += (char)WStype_CONNECTED;
+  text(200, "{\"seq\": 1, \"text\": \"First\"}");
+  text(100, "{\"seq\": 1, \"text\": \"First\"}");
+  text(100, "{\"seq\": 3, \"text\": \"Third\"}");
+  text(100, "{\"seq\": 2, \"text\": \"Second\"}");
+  text(100, "{\"seq\": 200, \"text\": \"Far ahead\"}");
+  pin(1000, TOUCH_PIN, HIGH);
+  pin(200, TOUCH_PIN, LOW);
+  pin(300, MISS_BUTTON_PIN, LOW);
+  pin(100, MISS_BUTTON_PIN, HIGH);
+  record(TRACE_END, 1000);
+}
+
+static bool contains(const std::string& data, const char* part) {
+  return data.find(part) != std::string::npos;
+}
+
+static std::vector<std::string> sentText() {
+  std::vector<std::string> frames;
+  for (const HostFrame& frame : hostSentFrames()) {
+    if (!frame.binary) {
+      frames.push_back(frame.payload);
+    }
+  }
+  return frames;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_replay_runs_to_the_end() {
+  buildTrace();
+  TEST_ASSERT_TRUE(hostWriteFile(TRACE_PATH, trace.data(), trace.size()));
+  hostSetWebSocketConnected(true);  // as it was while the trace was recorded
+
+  setup();
+  TEST_ASSERT_TRUE(isTraceReplaying());
+  int passes = 0;
+  while (isTraceReplaying() && passes < MAX_PASSES) {
+    hostAdvance(TRACE_REPLAY_STEP_MS);
+    loop();
+    passes++;
+  }
+  TEST_ASSERT_FALSE_MESSAGE(isTraceReplaying(), hostSerialOutput().c_str());
+  TEST_ASSERT_EQUAL(330, passes);  // 3.3 s of trace at 10 ms a pass
+}
+
+// The ACK never moves past a missing seq, and resends and far seqs only repeat it
+static void test_frames_sent() {
+  static const char* const expected[] = {
+    "{\"type\": \"assets\", \"manifest\": \"\"}",
+    "{\"type\": \"hello\", \"last_ack\": 0}",
+    "{\"type\": \"ack\", \"ack\": 1}",
+    "{\"type\": \"ack\", \"ack\": 1}",
+    "{\"type\": \"ack\", \"ack\": 1}",
+    "{\"type\": \"ack\", \"ack\": 3}",
+    "{\"type\": \"ack\", \"ack\": 3}",
+    "{\"type\": \"displayed\", \"seq\": 2}",
+    "{\"type\": \"miss_you_button\"}",
+  };
+  std::vector<std::string> frames = sentText();
+  TEST_ASSERT_EQUAL(sizeof(expected) / sizeof(expected[0]), frames.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    TEST_ASSERT_EQUAL_STRING(expected[i], frames[i].c_str());
+  }
+}
+
+static void test_state_stored() {
+  std::string data;
+  TEST_ASSERT_TRUE(hostReadFile("/delivery.json", data));
+  TEST_ASSERT_EQUAL_STRING("{\"ack\":3,\"window\":0}", data.c_str());
+  TEST_ASSERT_TRUE(hostReadFile("/message.json", data));
+  TEST_ASSERT_EQUAL_STRING("{\"seq\":2,\"text\":\"Second\"}", data.c_str());
+  TEST_ASSERT_TRUE(hostReadFile("/stats.json", data));
+  TEST_ASSERT_TRUE(contains(data, "\"messagesReceived\":3"));
+}
+
+static void test_log_shows_the_drops() {
+  const std::string& log = hostSerialOutput();
+  TEST_ASSERT_TRUE(contains(log, "Dropping duplicate message seq 1"));
+  TEST_ASSERT_TRUE(contains(log, "Dropping seq 200, too far ahead of ack 3"));
+  TEST_ASSERT_TRUE(contains(log, "Replay finished"));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_replay_runs_to_the_end);
+  RUN_TEST(test_frames_sent);
+  RUN_TEST(test_state_stored);
+  RUN_TEST(test_log_shows_the_drops);
+  return UNITY_END();
+}
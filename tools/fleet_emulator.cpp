@@ -0,0 +1,908 @@
+/*
+  Emulates a fleet of devices against a relay, to see how it holds up when
+  they all come back at once. Built on the host and linked with the
+  firmware's own delivery window, reconnect backoff and message encoding:
+
+    g++ -std=gnu++17 -O2 -Iinclude -o fleet_emulator tools/fleet_emulator.cpp \
+        src/delivery_window.cpp src/connection_timing.cpp src/protocol_messages.cpp
+
+    ./fleet_emulator ws://127.0.0.1:8765/ --devices 2000 --duration 300 \
+        --press-rate 0.5 --offline 0.05:60 --storm 120:30
+
+  Each emulated device speaks the firmware's side of the protocol: "hello"
+  with its last_ack on connect, then its stored miss_you_button presses
+  100 ms apart; a cumulative "ack" for every stored message, with
+  duplicates and seqs too far ahead told apart by the DeliveryWindow of
+  delivery_window.h; a ping every heartbeat interval, dropping the
+  connection after WS_MAX_MISSED_PONGS missed pongs; reconnects with
+  backoffInterval() of connection_timing.h, reset when WiFi comes back.
+
+    --press-rate   miss_you_button presses per device per minute
+    --offline      FRACTION:SECONDS, each minute that fraction of devices
+                   loses WiFi for that long and stores its presses
+    --storm        AT:SECONDS, every device loses WiFi at AT for SECONDS
+                   (a router reboot) and then reconnects at once
+    --ramp         seconds over which the devices first connect
+    --dhcp-jitter  seconds WiFi takes to give an IP after an outage
+    --timeout      connect and upgrade timeout in seconds
+    --report       seconds between reports
+    --seed         for the presses, outages and jitter
+
+  Reported from the devices' side of the relay:
+
+    connect  TCP connect plus WebSocket upgrade
+    resume   hello to the first frame back
+    rtt      ping to pong, the relay's responsiveness under load
+    loss     seqs skipped and never filled in, duplicates, presses still
+             unwritten when their connection died (the firmware loses
+             those too)
+
+  The firmware connects to "/"; a relay that serves many devices can tell
+  them apart when the path holds {device}, e.g. ws://127.0.0.1:8765/d/{device}.
+  Every device holds a socket, so the soft file descriptor limit is raised
+  to the hard one at start. POSIX only; text frames are searched for
+  "seq" rather than parsed, which is enough for the relay's messages.
+*/
+
+#include <binary_protocol.h>
+#include <connection_timing.h>
+#include <delivery_window.h>
+#include <protocol_messages.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#define PRESS_SPACING_MS 100  // delay(100) between replayed presses in onWebSocketEvent()
+#define POLL_MS 10
+#define READ_CHUNK 4096
+#define FRAME_MAX (1UL << 24)
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+enum WsOpcode : uint8_t {
+  OP_CONTINUATION = 0x0,
+  OP_TEXT = 0x1,
+  OP_BINARY = 0x2,
+  OP_CLOSE = 0x8,
+  OP_PING = 0x9,
+  OP_PONG = 0xA
+};
+
+enum DeviceState : uint8_t {
+  DEVICE_WAITING,     // for the ramp, a backoff, WiFi or DHCP
+  DEVICE_CONNECTING,  // TCP connect in progress
+  DEVICE_UPGRADING,   // upgrade request sent, waiting for the 101
+  DEVICE_OPEN
+};
+
+struct Options {
+  std::string host;
+  std::string port = "80";
+  std::string path = "/";
+  int devices = 100;
+  double duration = 120;
+  double ramp = 10;
+  double pressRate = 0.2;
+  double offlineFraction = 0;
+  double offlineSeconds = 0;
+  double stormAt = -1;
+  double stormSeconds = 0;
+  double dhcpJitter = 3;
+  double timeout = 10;
+  double report = 10;
+  uint32_t seed = 1;
+};
+
+struct Device {
+  int index;
+  std::mt19937 rng;
+  DeviceState state;
+  int fd;
+  double wakeAt;      // DEVICE_WAITING: when to connect
+  double wifiBackAt;  // when WiFi returns, 0 while up
+  double connectAt;
+  double helloAt;
+  bool awaitingFirstFrame;
+  DeliveryWindow window;
+  uint32_t highestSeq;
+  uint32_t missedPresses;  // /missed_presses.txt
+  uint8_t attempts;
+  double nextPress;
+  double nextReplay;
+  double nextPing;
+  double pingSentAt;
+  bool awaitingPong;
+  uint8_t missedPongs;
+  std::string key;  // Sec-WebSocket-Key of the upgrade in progress
+  std::string in;   // received, not yet parsed
+  std::string out;  // queued, not yet written
+  uint64_t queuedBytes;
+  uint64_t sentBytes;
+  std::deque<uint64_t> pressEnds;  // stream offset after each unwritten press
+  uint8_t messageOpcode;           // of the fragmented message in progress
+  std::string message;
+};
+
+enum Counter {
+  COUNT_CONNECTS,
+  COUNT_FAILED_CONNECTS,
+  COUNT_DROPS,
+  COUNT_PRESSES,
+  COUNT_REPLAYED_PRESSES,
+  COUNT_LOST_PRESSES,
+  COUNT_MESSAGES,
+  COUNT_DUPLICATES,
+  COUNT_BEYOND_WINDOW,
+  COUNT_PONG_TIMEOUTS,
+  COUNTERS
+};
+
+static const char* const counterNames[COUNTERS] = {
+  "connects", "failed connects", "drops", "presses", "replayed presses", "lost presses",
+  "messages", "duplicates", "beyond window", "pong timeouts"
+};
+
+enum Sample { SAMPLE_CONNECT, SAMPLE_RESUME, SAMPLE_RTT, SAMPLES };
+
+static const char* const sampleNames[SAMPLES] = { "connect", "resume", "rtt" };
+
+static Options options;
+static struct addrinfo* relay = nullptr;
+static std::vector<Device> devices;
+static std::vector<double> samples[SAMPLES];  // ms
+static uint64_t counters[COUNTERS];
+static std::chrono::steady_clock::time_point started;
+
+// Seconds since the emulator started
+static double now() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+static double uniform(std::mt19937& rng, double low, double high) {
+  return std::uniform_real_distribution<double>(low, high)(rng);
+}
+
+static uint32_t rotateLeft(uint32_t value, int bits) {
+  return value << bits | value >> (32 - bits);
+}
+
+// SHA-1 (RFC 3174), only to check the relay's Sec-WebSocket-Accept
+static void sha1(const std::string& data, uint8_t digest[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string padded = data;
+  uint64_t bits = (uint64_t)data.size() * 8;
+  padded += (char)0x80;
+  while (padded.size() % 64 != 56) {
+    padded += (char)0;
+  }
+  for (int i = 7; i >= 0; i--) {
+    padded += (char)(bits >> (8 * i));
+  }
+
+  for (size_t block = 0; block < padded.size(); block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t* p = (const uint8_t*)padded.data() + block + 4 * i;
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t t = rotateLeft(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rotateLeft(b, 30);
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (int i = 0; i < 20; i++) {
+    digest[i] = h[i / 4] >> (24 - 8 * (i % 4));
+  }
+}
+
+static std::string base64(const uint8_t* data, size_t length) {
+  static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string text;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t group = (uint32_t)data[i] << 16;
+    if (i + 1 < length) {
+      group |= (uint32_t)data[i + 1] << 8;
+    }
+    if (i + 2 < length) {
+      group |= data[i + 2];
+    }
+    text += alphabet[group >> 18 & 0x3F];
+    text += alphabet[group >> 12 & 0x3F];
+    text += i + 1 < length ? alphabet[group >> 6 & 0x3F] : '=';
+    text += i + 2 < length ? alphabet[group & 0x3F] : '=';
+  }
+  return text;
+}
+
+/*
+  The top level "seq" of a text message, 0 if it has none. A search, not a
+  JSON parser: the relay's messages carry no nested "seq".
+*/
+static uint32_t findSeq(const std::string& text) {
+  size_t at = text.find("\"seq\"");
+  if (at == std::string::npos) {
+    return 0;
+  }
+  at += 5;
+  while (at < text.size() && (text[at] == ' ' || text[at] == ':')) {
+    at++;
+  }
+  uint32_t seq = 0;
+  while (at < text.size() && text[at] >= '0' && text[at] <= '9') {
+    seq = seq * 10 + (text[at++] - '0');
+  }
+  return seq;
+}
+
+// Appends a masked client frame to the device's output
+static void queueFrame(Device& device, uint8_t opcode, const char* payload, size_t length) {
+  std::string frame;
+  frame += (char)(0x80 | opcode);
+  if (length < 126) {
+    frame += (char)(0x80 | length);
+  } else if (length < 1 << 16) {
+    frame += (char)(0x80 | 126);
+    frame += (char)(length >> 8);
+    frame += (char)length;
+  } else {
+    frame += (char)(0x80 | 127);
+    for (int i = 7; i >= 0; i--) {
+      frame += (char)((uint64_t)length >> (8 * i));
+    }
+  }
+  uint32_t mask = device.rng();
+  for (int i = 0; i < 4; i++) {
+    frame += (char)(mask >> (8 * i));
+  }
+  for (size_t i = 0; i < length; i++) {
+    frame += (char)(payload[i] ^ (mask >> (8 * (i & 3))));
+  }
+  device.out += frame;
+  device.queuedBytes += frame.size();
+}
+
+static void queueText(Device& device, const char* text) {
+  queueFrame(device, OP_TEXT, text, strlen(text));
+}
+
+// A press goes out like any text frame but is lost if the connection dies first
+static void queuePress(Device& device) {
+  queueText(device, MISS_YOU_BUTTON_MESSAGE);
+  device.pressEnds.push_back(device.queuedBytes);
+}
+
+/*
+  Writes what the socket takes without blocking.
+  Returns false if the connection is gone.
+*/
+static bool flushOutput(Device& device) {
+  while (!device.out.empty()) {
+    ssize_t written = send(device.fd, device.out.data(), device.out.size(), 0);
+    if (written < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    device.out.erase(0, written);
+    device.sentBytes += written;
+    while (!device.pressEnds.empty() && device.pressEnds.front() <= device.sentBytes) {
+      device.pressEnds.pop_front();
+    }
+  }
+  return true;
+}
+
+/*
+  Closes the connection, if any. While WiFi is down the device waits for
+  it to return; otherwise it backs off as the firmware does.
+*/
+static void disconnect(Device& device, double at) {
+  if (device.fd >= 0) {
+    close(device.fd);
+    device.fd = -1;
+  }
+  if (device.state == DEVICE_OPEN) {
+    counters[COUNT_DROPS]++;
+    counters[COUNT_LOST_PRESSES] += device.pressEnds.size();
+  }
+  device.state = DEVICE_WAITING;
+  device.in.clear();
+  device.out.clear();
+  device.pressEnds.clear();
+  device.message.clear();
+  if (device.wifiBackAt == 0) {
+    device.wakeAt = at + backoffInterval(device.attempts, device.rng()) / 1000.0;
+    device.attempts = std::min(device.attempts + 1, 255);
+  }
+}
+
+static void failConnect(Device& device, double at) {
+  counters[COUNT_FAILED_CONNECTS]++;
+  disconnect(device, at);
+}
+
+static void wifiDown(Device& device, double at, double seconds) {
+  device.wifiBackAt = std::max(device.wifiBackAt, at + seconds);
+  if (device.state != DEVICE_WAITING) {
+    disconnect(device, at);  // presses from now on are stored
+  }
+}
+
+static void startConnect(Device& device, double at) {
+  device.connectAt = at;
+  device.queuedBytes = 0;
+  device.sentBytes = 0;
+  device.fd = socket(relay->ai_family, relay->ai_socktype, relay->ai_protocol);
+  if (device.fd < 0) {
+    failConnect(device, at);
+    return;
+  }
+  fcntl(device.fd, F_SETFL, fcntl(device.fd, F_GETFL) | O_NONBLOCK);
+  device.state = DEVICE_CONNECTING;
+  if (connect(device.fd, relay->ai_addr, relay->ai_addrlen) < 0 && errno != EINPROGRESS) {
+    failConnect(device, at);
+  }
+}
+
+// TCP is up: send the upgrade request
+static void startUpgrade(Device& device, double at) {
+  int error = 0;
+  socklen_t length = sizeof(error);
+  if (getsockopt(device.fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+    failConnect(device, at);
+    return;
+  }
+
+  uint8_t nonce[16];
+  for (uint8_t& byte : nonce) {
+    byte = device.rng();
+  }
+  device.key = base64(nonce, sizeof(nonce));
+
+  std::string path = options.path;
+  size_t placeholder = path.find("{device}");
+  if (placeholder != std::string::npos) {
+    path.replace(placeholder, 8, std::to_string(device.index));
+  }
+  device.out = "GET " + path + " HTTP/1.1\r\nHost: " + options.host + ":" + options.port +
+               "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + device.key +
+               "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+  device.state = DEVICE_UPGRADING;
+  if (!flushOutput(device)) {
+    failConnect(device, at);
+  }
+}
+
+// What onWebSocketEvent() does on WStype_CONNECTED
+static void onOpen(Device& device, double at) {
+  samples[SAMPLE_CONNECT].push_back((at - device.connectAt) * 1000);
+  counters[COUNT_CONNECTS]++;
+  device.state = DEVICE_OPEN;
+  device.attempts = 0;
+  device.awaitingPong = false;
+  device.missedPongs = 0;
+  device.nextPing = at + WS_HEARTBEAT_INTERVAL_MS / 1000.0 * uniform(device.rng, 0.9, 1.1);
+
+  char hello[PROTOCOL_MESSAGE_MAX];
+  formatHelloMessage(hello, sizeof(hello), device.window.ackedSeq);
+  queueText(device, hello);
+  device.helloAt = at;
+  device.awaitingFirstFrame = true;
+  device.nextReplay = at;
+}
+
+/*
+  Checks the relay's answer to the upgrade.
+  Returns false if it refused.
+*/
+static bool finishUpgrade(Device& device, double at) {
+  size_t end = device.in.find("\r\n\r\n");
+  if (end == std::string::npos) {
+    return device.in.size() < READ_CHUNK;
+  }
+
+  uint8_t digest[20];
+  sha1(device.key + WS_GUID, digest);
+  std::string header = device.in.substr(0, end);
+  std::string status = header.substr(0, header.find("\r\n"));
+  if (status.find(" 101 ") == std::string::npos || header.find(base64(digest, sizeof(digest))) == std::string::npos) {
+    return false;
+  }
+  device.in.erase(0, end + 4);
+  onOpen(device, at);
+  return true;
+}
+
+// A stored message: acknowledgeMessage() or rejectMessage() in main.cpp
+static void onSeq(Device& device, uint32_t seq) {
+  if (seq == 0) {
+    return;
+  }
+  if (isDuplicateInWindow(device.window, seq)) {
+    counters[COUNT_DUPLICATES]++;
+  } else if (isBeyondWindow(device.window, seq)) {
+    counters[COUNT_BEYOND_WINDOW]++;  // dropped, the unchanged ack asks for the gap
+  } else {
+    recordInWindow(device.window, seq);
+    device.highestSeq = std::max(device.highestSeq, seq);
+    counters[COUNT_MESSAGES]++;
+  }
+  char ack[PROTOCOL_MESSAGE_MAX];
+  formatAckMessage(ack, sizeof(ack), device.window.ackedSeq);
+  queueText(device, ack);
+}
+
+static void onMessage(Device& device, uint8_t opcode, const std::string& payload) {
+  if (opcode == OP_TEXT) {
+    onSeq(device, findSeq(payload));
+  } else if (opcode == OP_BINARY && payload.size() >= BINARY_HEADER_SIZE + 4 &&
+             (payload[0] == BINARY_IMAGE || payload[0] == BINARY_DOODLE)) {
+    onSeq(device, readLe32((const uint8_t*)payload.data() + BINARY_HEADER_SIZE));
+  }
+}
+
+/*
+  Handles every complete frame received, answering pings and reassembling
+  fragmented messages. Returns false when the relay closed or sent garbage.
+*/
+static bool readFrames(Device& device, double at) {
+  size_t pos = 0;
+  bool open = true;
+  while (open) {
+    const uint8_t* p = (const uint8_t*)device.in.data() + pos;
+    size_t available = device.in.size() - pos;
+    if (available < 2) {
+      break;
+    }
+    uint64_t length = p[1] & 0x7F;
+    size_t head = 2;
+    if (length == 126) {
+      if (available < 4) {
+        break;
+      }
+      length = p[2] << 8 | p[3];
+      head = 4;
+    } else if (length == 127) {
+      if (available < 10) {
+        break;
+      }
+      length = 0;
+      for (int i = 0; i < 8; i++) {
+        length = length << 8 | p[2 + i];
+      }
+      head = 10;
+    }
+    if (length > FRAME_MAX) {
+      return false;
+    }
+    const uint8_t* mask = p + head;
+    if (p[1] & 0x80) {
+      head += 4;
+    }
+    if (available < head + length) {
+      break;
+    }
+
+    std::string payload(device.in, pos + head, length);
+    if (p[1] & 0x80) {
+      for (size_t i = 0; i < length; i++) {
+        payload[i] ^= mask[i & 3];
+      }
+    }
+    uint8_t opcode = p[0] & 0x0F;
+    bool final = p[0] & 0x80;
+    pos += head + length;
+
+    if (device.awaitingFirstFrame) {
+      samples[SAMPLE_RESUME].push_back((at - device.helloAt) * 1000);
+      device.awaitingFirstFrame = false;
+    }
+    if (opcode == OP_PING) {
+      queueFrame(device, OP_PONG, payload.data(), payload.size());
+    } else if (opcode == OP_PONG) {
+      if (device.awaitingPong) {
+        samples[SAMPLE_RTT].push_back((at - device.pingSentAt) * 1000);
+        device.awaitingPong = false;
+        device.missedPongs = 0;
+      }
+    } else if (opcode == OP_CLOSE) {
+      open = false;
+    } else {
+      if (opcode != OP_CONTINUATION) {
+        device.messageOpcode = opcode;
+        device.message.clear();
+      }
+      device.message += payload;
+      if (final) {
+        onMessage(device, device.messageOpcode, device.message);
+        device.message.clear();
+      }
+    }
+  }
+  device.in.erase(0, pos);
+  return open;
+}
+
+static void schedulePress(Device& device, double after) {
+  double perSecond = options.pressRate / 60;
+  device.nextPress = perSecond > 0 ? after + std::exponential_distribution<double>(perSecond)(device.rng) : 1e300;
+}
+
+/*
+  Timers: WiFi, backoff and connect timeouts, presses, the replay of
+  stored presses and the heartbeat.
+*/
+static void tick(Device& device, double at) {
+  if (at >= device.nextPress) {
+    counters[COUNT_PRESSES]++;
+    if (device.state == DEVICE_OPEN) {
+      queuePress(device);
+    } else {
+      device.missedPresses++;
+    }
+    schedulePress(device, at);
+  }
+
+  switch (device.state) {
+    case DEVICE_WAITING:
+      if (device.wifiBackAt != 0) {
+        if (at >= device.wifiBackAt) {
+          device.wifiBackAt = 0;
+          device.attempts = 0;  // "WiFi got IP, reconnecting now"
+          device.wakeAt = at + uniform(device.rng, 0, options.dhcpJitter);
+        }
+      } else if (at >= device.wakeAt) {
+        startConnect(device, at);
+      }
+      break;
+
+    case DEVICE_CONNECTING:
+    case DEVICE_UPGRADING:
+      if (at - device.connectAt > options.timeout) {
+        failConnect(device, at);
+      }
+      break;
+
+    case DEVICE_OPEN:
+      if (device.missedPresses > 0 && at >= device.nextReplay) {
+        queuePress(device);
+        device.missedPresses--;
+        counters[COUNT_REPLAYED_PRESSES]++;
+        device.nextReplay = at + PRESS_SPACING_MS / 1000.0;
+      }
+      if (device.awaitingPong) {
+        if (at - device.pingSentAt > WS_PONG_TIMEOUT_MS / 1000.0) {
+          counters[COUNT_PONG_TIMEOUTS]++;
+          device.awaitingPong = false;
+          if (++device.missedPongs >= WS_MAX_MISSED_PONGS) {
+            disconnect(device, at);
+            return;
+          }
+        }
+      } else if (at >= device.nextPing) {
+        queueFrame(device, OP_PING, "", 0);
+        device.pingSentAt = at;
+        device.awaitingPong = true;
+        device.nextPing = at + WS_HEARTBEAT_INTERVAL_MS / 1000.0 * uniform(device.rng, 0.9, 1.1);
+      }
+      if (!flushOutput(device)) {
+        disconnect(device, at);
+      }
+      break;
+  }
+}
+
+// Reads what arrived and moves the connection along
+static void onReadable(Device& device, double at) {
+  bool closed = false;
+  char buffer[READ_CHUNK];
+  for (;;) {
+    ssize_t received = recv(device.fd, buffer, sizeof(buffer), 0);
+    if (received > 0) {
+      device.in.append(buffer, received);
+      continue;
+    }
+    closed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+    break;
+  }
+
+  if (device.state == DEVICE_UPGRADING && !device.in.empty()) {
+    if (!finishUpgrade(device, at)) {
+      failConnect(device, at);
+      return;
+    }
+  }
+  if (device.state == DEVICE_OPEN && (!readFrames(device, at) || !flushOutput(device))) {
+    closed = true;
+  }
+  if (closed) {
+    if (device.state == DEVICE_OPEN) {
+      disconnect(device, at);
+    } else {
+      failConnect(device, at);
+    }
+  }
+}
+
+// Seqs below the highest one seen that never arrived
+static uint64_t missingSeqs(const Device& device) {
+  uint64_t missing = 0;
+  for (uint32_t seq = device.window.ackedSeq + 1; seq < device.highestSeq; seq++) {
+    if (!isDuplicateInWindow(device.window, seq)) {
+      missing++;
+    }
+  }
+  return missing;
+}
+
+static void report(double elapsed) {
+  size_t online = 0;
+  uint64_t missing = 0;
+  for (const Device& device : devices) {
+    online += device.state == DEVICE_OPEN;
+    missing += missingSeqs(device);
+  }
+  printf("--- %7.1f s, %zu/%zu connected\n", elapsed, online, devices.size());
+
+  for (int i = 0; i < SAMPLES; i++) {
+    std::vector<double>& values = samples[i];
+    if (values.empty()) {
+      continue;
+    }
+    std::sort(values.begin(), values.end());
+    auto pick = [&values](double q) { return values[std::min(values.size() - 1, (size_t)(q * values.size()))]; };
+    printf("  %-8s n=%-7zu p50=%8.1f p90=%8.1f p99=%8.1f max=%8.1f ms\n", sampleNames[i], values.size(),
+           pick(0.5), pick(0.9), pick(0.99), values.back());
+  }
+
+  printf(" ");
+  for (int i = 0; i < COUNTERS; i++) {
+    printf(" %llu %s,", (unsigned long long)counters[i], counterNames[i]);
+  }
+  printf(" %llu seqs missing\n", (unsigned long long)missing);
+  fflush(stdout);
+}
+
+// Offline periods and the storm
+static void chaos(std::mt19937& rng, double at, double& nextMinute) {
+  if (options.stormAt >= 0 && at >= options.stormAt) {
+    printf("*** storm: all %zu devices lose WiFi for %g s\n", devices.size(), options.stormSeconds);
+    for (Device& device : devices) {
+      wifiDown(device, at, options.stormSeconds);
+    }
+    options.stormAt = -1;
+  }
+  if (options.offlineFraction > 0 && at >= nextMinute) {
+    nextMinute += 60;
+    std::vector<Device*> picked;
+    std::vector<Device*> all;
+    for (Device& device : devices) {
+      all.push_back(&device);
+    }
+    std::sample(all.begin(), all.end(), std::back_inserter(picked), (size_t)(devices.size() * options.offlineFraction),
+                rng);
+    for (Device* device : picked) {
+      wifiDown(*device, at, options.offlineSeconds);
+    }
+  }
+}
+
+static void usage(const char* problem) {
+  if (problem) {
+    fprintf(stderr, "fleet_emulator: %s\n", problem);
+  }
+  fprintf(stderr,
+          "usage: fleet_emulator ws://host:port/path [--devices N] [--duration S] [--ramp S]\n"
+          "         [--press-rate PER_MINUTE] [--offline FRACTION:SECONDS] [--storm AT:SECONDS]\n"
+          "         [--dhcp-jitter S] [--timeout S] [--report S] [--seed N]\n");
+  exit(2);
+}
+
+static void parsePair(const char* text, double& first, double& second) {
+  char* end;
+  first = strtod(text, &end);
+  if (*end != ':') {
+    usage("expected FIRST:SECOND");
+  }
+  second = strtod(end + 1, &end);
+  if (*end != '\0') {
+    usage("expected FIRST:SECOND");
+  }
+}
+
+static void parseRelay(const std::string& url) {
+  if (url.compare(0, 5, "ws://") != 0) {
+    usage("only ws:// relays are supported");
+  }
+  std::string rest = url.substr(5);
+  size_t slash = rest.find('/');
+  if (slash != std::string::npos) {
+    options.path = rest.substr(slash);
+    rest.erase(slash);
+  }
+  size_t colon = rest.find(':');
+  if (colon != std::string::npos) {
+    options.port = rest.substr(colon + 1);
+    rest.erase(colon);
+  }
+  options.host = rest;
+}
+
+static void parseOptions(int argc, char** argv) {
+  const char* relayUrl = nullptr;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name == "-h" || name == "--help") {
+      usage(nullptr);
+    }
+    if (name.compare(0, 2, "--") != 0) {
+      relayUrl = argv[i];
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage("missing value");
+    }
+    const char* value = argv[++i];
+    if (name == "--devices") {
+      options.devices = atoi(value);
+    } else if (name == "--duration") {
+      options.duration = atof(value);
+    } else if (name == "--ramp") {
+      options.ramp = atof(value);
+    } else if (name == "--press-rate") {
+      options.pressRate = atof(value);
+    } else if (name == "--offline") {
+      parsePair(value, options.offlineFraction, options.offlineSeconds);
+    } else if (name == "--storm") {
+      parsePair(value, options.stormAt, options.stormSeconds);
+    } else if (name == "--dhcp-jitter") {
+      options.dhcpJitter = atof(value);
+    } else if (name == "--timeout") {
+      options.timeout = atof(value);
+    } else if (name == "--report") {
+      options.report = atof(value);
+    } else if (name == "--seed") {
+      options.seed = strtoul(value, nullptr, 10);
+    } else {
+      usage(("unknown option " + name).c_str());
+    }
+  }
+  if (!relayUrl) {
+    usage("no relay given");
+  }
+  parseRelay(relayUrl);
+}
+
+int main(int argc, char** argv) {
+  parseOptions(argc, argv);
+  signal(SIGPIPE, SIG_IGN);
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  int error = getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &relay);
+  if (error != 0) {
+    fprintf(stderr, "fleet_emulator: %s: %s\n", options.host.c_str(), gai_strerror(error));
+    return 1;
+  }
+
+  struct rlimit files;
+  if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max) {
+    files.rlim_cur = files.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &files);
+  }
+
+  started = std::chrono::steady_clock::now();
+  devices.resize(options.devices);
+  for (int i = 0; i < options.devices; i++) {
+    Device& device = devices[i];
+    device.index = i;
+    device.rng.seed(options.seed * 100003 + i);
+    device.state = DEVICE_WAITING;
+    device.fd = -1;
+    device.wakeAt = uniform(device.rng, 0, options.ramp);
+    schedulePress(device, device.wakeAt);
+  }
+
+  std::mt19937 chaosRng(options.seed);
+  double nextMinute = 60;
+  double nextReport = options.report;
+  std::vector<struct pollfd> polled;
+  std::vector<Device*> owners;
+
+  for (double at = now(); at < options.duration; at = now()) {
+    for (Device& device : devices) {
+      tick(device, at);
+    }
+    chaos(chaosRng, at, nextMinute);
+    if (at >= nextReport) {
+      report(at);
+      nextReport += options.report;
+    }
+
+    polled.clear();
+    owners.clear();
+    for (Device& device : devices) {
+      if (device.fd < 0) {
+        continue;
+      }
+      short events = POLLIN;
+      if (device.state == DEVICE_CONNECTING || !device.out.empty()) {
+        events |= POLLOUT;
+      }
+      polled.push_back({device.fd, events, 0});
+      owners.push_back(&device);
+    }
+    if (poll(polled.data(), polled.size(), POLL_MS) <= 0) {
+      continue;
+    }
+
+    at = now();
+    for (size_t i = 0; i < polled.size(); i++) {
+      Device& device = *owners[i];
+      short events = polled[i].revents;
+      if (events == 0 || device.fd != polled[i].fd) {
+        continue;
+      }
+      if (device.state == DEVICE_CONNECTING) {
+        startUpgrade(device, at);
+      } else if (events & (POLLIN | POLLHUP | POLLERR)) {
+        onReadable(device, at);
+      } else if (!flushOutput(device)) {
+        disconnect(device, at);
+      }
+    }
+  }
+
+  for (Device& device : devices) {
+    if (device.fd >= 0) {
+      close(device.fd);
+    }
+  }
+  freeaddrinfo(relay);
+  report(now());
+  return 0;
+}
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+Makes a firmware delta for the device's OTA path (src/ota_update.cpp):
+
+  python3 tools/make_delta.py old/firmware.bin .pio/build/nodemcuv2/firmware.bin update.lbd
+  python3 tools/make_delta.py --full .pio/build/nodemcuv2/firmware.bin update.lbd
+  python3 tools/make_delta.py --apply old/firmware.bin update.lbd new.bin
+
+old must be the exact image the device runs (its 'o' Serial command
+prints the size and MD5). Every delta is applied back to old before it is
+written and compared with new, so a bad delta never leaves this tool.
+
+Format (little endian), see ota_update.h:
+
+  header  "LBD1", source size (u32), source MD5, target size (u32), target MD5
+  body    LZSS (1024 byte window) of the patch ops
+          COPY src n | ADD src n bytes | INSERT n bytes | END
+"""
+import argparse
+import hashlib
+import struct
+import sys
+
+OP_END, OP_COPY, OP_ADD, OP_INSERT = 0, 1, 2, 3
+
+WINDOW = 1024      # OTA_WINDOW_SIZE
+MIN_REF = 3
+MAX_REF = 66       # 6 bit length
+CHAIN_DEPTH = 32
+
+KEY = 8            # bytes hashed to find matches in the old image
+MIN_COPY = 16      # shorter exact matches are left to ADD/INSERT
+ADD_SIMILARITY = 0.5
+
+
+def find_ops(old, new):
+    """Greedy rsync-style matching. Exact matches become COPY; the gaps
+    between them become ADD against the old bytes that continue the last
+    match when most of those bytes agree (code shifted by a few bytes keeps
+    only its addresses different), INSERT otherwise."""
+    index = {}
+    for i in range(len(old) - KEY + 1):
+        index.setdefault(old[i:i + KEY], []).append(i)
+
+    ops = []
+    gap_start = 0
+    follow = None  # old offset that lines up with new[gap_start]
+
+    def flush_gap(end):
+        if gap_start == end:
+            return
+        n = end - gap_start
+        if follow is not None and follow + n <= len(old):
+            same = sum(1 for k in range(n) if old[follow + k] == new[gap_start + k])
+            if same >= n * ADD_SIMILARITY:
+                diff = bytes((new[gap_start + k] - old[follow + k]) & 0xFF for k in range(n))
+                ops.append((OP_ADD, follow, n, diff))
+                return
+        ops.append((OP_INSERT, None, n, new[gap_start:end]))
+
+    i = 0
+    while i + KEY <= len(new):
+        best_len, best_src = 0, 0
+        for src in index.get(new[i:i + KEY], ())[-16:]:
+            n = KEY
+            while i + n < len(new) and src + n < len(old) and new[i + n] == old[src + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_src = n, src
+        if best_len < MIN_COPY:
+            i += 1
+            continue
+        flush_gap(i)
+        ops.append((OP_COPY, best_src, best_len, b""))
+        i += best_len
+        gap_start = i
+        follow = best_src + best_len
+    flush_gap(len(new))
+    return ops
+
+
+def encode_ops(ops):
+    out = bytearray()
+    for op, src, n, data in ops:
+        if op == OP_INSERT:
+            out += struct.pack("<BI", op, n) + data
+        else:
+            out += struct.pack("<BII", op, src, n) + data
+    out.append(OP_END)
+    return bytes(out)
+
+
+def lzss_compress(data):
+    out = bytearray()
+    heads = {}  # 3 byte prefix -> recent positions
+    i = 0
+    while i < len(data):
+        flag_at = len(out)
+        out.append(0)
+        flags = 0
+        for bit in range(8):
+            if i >= len(data):
+                break
+            best_len, best_dist = 0, 0
+            if i + MIN_REF <= len(data):
+                for pos in reversed(heads.get(data[i:i + MIN_REF], ())):
+                    dist = i - pos
+                    if dist > WINDOW:
+                        break
+                    n = 0
+                    limit = min(MAX_REF, len(data) - i)
+                    while n < limit and data[pos + n] == data[i + n]:
+                        n += 1
+                    if n > best_len:
+                        best_len, best_dist = n, dist
+                        if n == limit:
+                            break
+            step = best_len if best_len >= MIN_REF else 1
+            if step == 1:
+                flags |= 1 << bit
+                out.append(data[i])
+            else:
+                code = (best_dist - 1) << 6 | (best_len - MIN_REF)
+                out += bytes((code >> 8, code & 0xFF))
+            for k in range(i, i + step):
+                chain = heads.setdefault(data[k:k + MIN_REF], [])
+                chain.append(k)
+                if len(chain) > CHAIN_DEPTH:
+                    del chain[0]
+            i += step
+        out[flag_at] = flags
+    return bytes(out)
+
+
+def lzss_decompress(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        flags = data[i]
+        i += 1
+        for bit in range(8):
+            if i >= len(data):
+                break
+            if flags >> bit & 1:
+                out.append(data[i])
+                i += 1
+            else:
+                code = data[i] << 8 | data[i + 1]
+                i += 2
+                dist, n = (code >> 6) + 1, (code & 0x3F) + MIN_REF
+                for _ in range(n):
+                    out.append(out[-dist])
+    return bytes(out)
+
+
+def apply_delta(old, delta):
+    magic, src_size, src_md5, dst_size, dst_md5 = struct.unpack_from("<4sI16sI16s", delta)
+    if magic != b"LBD1":
+        raise ValueError("not a delta file")
+    if src_size and (src_size != len(old) or hashlib.md5(old).digest() != src_md5):
+        raise ValueError("delta is for a different image")
+    patch = lzss_decompress(delta[44:])
+    out = bytearray()
+    i = 0
+    while True:
+        op = patch[i]
+        i += 1
+        if op == OP_END:
+            break
+        if op == OP_INSERT:
+            (n,) = struct.unpack_from("<I", patch, i)
+            out += patch[i + 4:i + 4 + n]
+            i += 4 + n
+            continue
+        src, n = struct.unpack_from("<II", patch, i)
+        i += 8
+        if op == OP_COPY:
+            out += old[src:src + n]
+        elif op == OP_ADD:
+            out += bytes((old[src + k] + patch[i + k]) & 0xFF for k in range(n))
+            i += n
+        else:
+            raise ValueError(f"unknown op {op}")
+    if len(out) != dst_size or hashlib.md5(out).digest() != dst_md5:
+        raise ValueError("target MD5 mismatch")
+    return bytes(out)
+
+
+def make_delta(old, new):
+    ops = find_ops(old, new) if old else [(OP_INSERT, None, len(new), new)]
+    header = struct.pack("<4sI16sI16s", b"LBD1", len(old), hashlib.md5(old).digest() if old else bytes(16),
+                         len(new), hashlib.md5(new).digest())
+    return header + lzss_compress(encode_ops(ops)), ops
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--full", action="store_true", help="no old image, make a full update")
+    parser.add_argument("--apply", action="store_true", help="apply DELTA to OLD and write the result")
+    parser.add_argument("files", nargs="+")
+    args = parser.parse_args()
+
+    if args.apply:
+        old_path, delta_path, out_path = args.files
+        with open(old_path, "rb") as f:
+            old = f.read()
+        with open(delta_path, "rb") as f:
+            delta = f.read()
+        with open(out_path, "wb") as f:
+            f.write(apply_delta(old, delta))
+        return
+
+    if args.full:
+        old = b""
+        new_path, out_path = args.files
+    else:
+        old_path, new_path, out_path = args.files
+        with open(old_path, "rb") as f:
+            old = f.read()
+    with open(new_path, "rb") as f:
+        new = f.read()
+
+    delta, ops = make_delta(old, new)
+    if apply_delta(old, delta) != new:
+        sys.exit("delta does not reproduce the new image, not written")
+    with open(out_path, "wb") as f:
+        f.write(delta)
+
+    counts = {name: sum(n for op, _, n, _ in ops if op == code)
+              for name, code in (("copied", OP_COPY), ("added", OP_ADD), ("inserted", OP_INSERT))}
+    print(f"{out_path}: {len(delta)} bytes for a {len(new)} byte image ({100 * len(delta) / len(new):.1f}%), "
+          + ", ".join(f"{n} {name}" for name, n in counts.items()))
+
+
+if __name__ == "__main__":
+    main()
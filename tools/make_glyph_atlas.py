@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Builds the glyph atlas read by src/glyph_atlas.cpp from a BDF font, e.g.
+GNU Unifont (16 px) for Latin, Devanagari and the other Indian scripts:
+
+  python3 tools/make_glyph_atlas.py unifont.bdf data/glyphs.bin \\
+      --ranges 0x20-0x24F,0x900-0x97F,0x980-0xDFF,0x2600-0x27BF,0xFFFD
+
+then upload the filesystem image as usual. Layout (little endian):
+
+  header  "GLY1", glyph count (u16), cell height (u8), reserved (u8)
+  index   count * { codepoint (u32), glyph offset (u32) }, sorted by codepoint
+  glyphs  width (u8), x offset (s8), advance (u8), then the bitmap in the
+          SSD1306 page layout: for every band of 8 rows one byte per
+          column, bit 0 at the top
+"""
+import argparse
+import struct
+import sys
+
+MAX_WIDTH = 16   # GLYPH_MAX_W
+MAX_HEIGHT = 16  # GLYPH_MAX_H
+
+
+def parse_ranges(text):
+    ranges = []
+    for part in text.split(","):
+        first, _, last = part.partition("-")
+        ranges.append((int(first, 0), int(last or first, 0)))
+    return ranges
+
+
+def read_bdf(path):
+    """Returns (ascent, descent, {codepoint: (dwidth, w, h, xoff, yoff, rows)})."""
+    ascent = descent = None
+    glyphs = {}
+    with open(path, encoding="latin-1") as bdf:
+        lines = iter(bdf)
+        for line in lines:
+            words = line.split()
+            if not words:
+                continue
+            if words[0] == "FONT_ASCENT":
+                ascent = int(words[1])
+            elif words[0] == "FONT_DESCENT":
+                descent = int(words[1])
+            elif words[0] == "STARTCHAR":
+                codepoint, dwidth, bbx, rows = -1, 0, None, []
+                for line in lines:
+                    words = line.split()
+                    if words[0] == "ENCODING":
+                        codepoint = int(words[-1])
+                    elif words[0] == "DWIDTH":
+                        dwidth = int(words[1])
+                    elif words[0] == "BBX":
+                        bbx = [int(v) for v in words[1:5]]
+                    elif words[0] == "BITMAP":
+                        for line in lines:
+                            if line.startswith("ENDCHAR"):
+                                break
+                            rows.append(int(line.strip(), 16) if line.strip() else 0)
+                        break
+                if codepoint >= 0 and bbx:
+                    glyphs[codepoint] = (dwidth, *bbx, rows)
+    if ascent is None or descent is None:
+        sys.exit(f"{path}: FONT_ASCENT/FONT_DESCENT missing")
+    return ascent, descent, glyphs
+
+
+def to_pages(glyph, ascent, height):
+    """Renders one glyph into its cell, returns (width, x offset, page bytes)."""
+    dwidth, w, h, xoff, yoff, rows = glyph
+    row_bits = (w + 7) // 8 * 8
+    pages = bytearray(w * ((height + 7) // 8))
+    for r, bits in enumerate(rows[:h]):
+        y = ascent - (yoff + h) + r
+        if not 0 <= y < height:
+            continue
+        for x in range(w):
+            if bits & (1 << (row_bits - 1 - x)):
+                pages[(y // 8) * w + x] |= 1 << (y % 8)
+    return w, xoff, bytes(pages)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("bdf")
+    parser.add_argument("atlas")
+    parser.add_argument("--ranges", help="codepoints to keep, e.g. 0x20-0x7E,0x900-0x97F (default: all)")
+    args = parser.parse_args()
+
+    ascent, descent, glyphs = read_bdf(args.bdf)
+    height = ascent + descent
+    if not 0 < height <= MAX_HEIGHT:
+        sys.exit(f"cells are {height} px high, the device draws at most {MAX_HEIGHT}")
+
+    if args.ranges:
+        ranges = parse_ranges(args.ranges)
+        glyphs = {cp: g for cp, g in glyphs.items() if any(a <= cp <= b for a, b in ranges)}
+
+    records = []
+    for codepoint in sorted(glyphs):
+        width, xoff, pages = to_pages(glyphs[codepoint], ascent, height)
+        dwidth = glyphs[codepoint][0]
+        if width > MAX_WIDTH or not -128 <= xoff < 128 or not 0 <= dwidth < 256:
+            print(f"skipping U+{codepoint:04X}: {width} px wide", file=sys.stderr)
+            continue
+        records.append((codepoint, struct.pack("<BbB", width, xoff, dwidth) + pages))
+    if len(records) > 0xFFFF:
+        sys.exit(f"{len(records)} glyphs, the index holds at most 65535")
+
+    index = bytearray()
+    data = bytearray()
+    offset = 8 + 8 * len(records)
+    for codepoint, record in records:
+        index += struct.pack("<II", codepoint, offset + len(data))
+        data += record
+
+    with open(args.atlas, "wb") as out:
+        out.write(b"GLY1" + struct.pack("<HBB", len(records), height, 0) + index + data)
+    print(f"{args.atlas}: {len(records)} glyphs, {height} px high, {8 + len(index) + len(data)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+Builds the asset manifest the server sends as a BINARY_MANIFEST frame
+(see include/asset_sync.h) from a directory laid out like data/:
+
+  python3 tools/make_manifest.py data/ assets.manifest --skip message.json stats.json wifi.json
+
+The output is the frame payload; prefix it with the type (0x05) and flags
+(0x00) bytes to send it. Its MD5 is what the device reports as
+{"type": "assets", "manifest": ...} once it has applied it.
+"""
+import argparse
+import hashlib
+import os
+import struct
+import sys
+
+PATH_MAX = 31  # ASSET_PATH_MAX
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("directory")
+    parser.add_argument("manifest")
+    parser.add_argument("--skip", nargs="*", default=[], help="files that are device state, not assets")
+    args = parser.parse_args()
+
+    entries = []
+    for root, _, files in os.walk(args.directory):
+        for name in sorted(files):
+            full = os.path.join(root, name)
+            path = "/" + os.path.relpath(full, args.directory).replace(os.sep, "/")
+            if path.lstrip("/") in args.skip:
+                continue
+            if len(path) > PATH_MAX:
+                sys.exit(f"{path}: longer than {PATH_MAX} characters")
+            with open(full, "rb") as f:
+                data = f.read()
+            entries.append((path, struct.pack("<B", len(path)) + path.encode() +
+                            struct.pack("<I", len(data)) + hashlib.md5(data).digest()))
+    if len(entries) > 255:
+        sys.exit("a manifest holds at most 255 files")
+
+    manifest = bytes([len(entries)]) + b"".join(entry for _, entry in sorted(entries))
+    if len(manifest) > 1024:  # ASSET_MANIFEST_MAX
+        sys.exit(f"manifest is {len(manifest)} bytes, the device takes at most 1024")
+    with open(args.manifest, "wb") as f:
+        f.write(manifest)
+    print(f"{args.manifest}: {len(entries)} files, MD5 {hashlib.md5(manifest).hexdigest()}")
+
+
+if __name__ == "__main__":
+    main()
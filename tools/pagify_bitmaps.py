@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+Converts image2cpp bitmaps (horizontal, 1 bit per pixel, MSB first, one row
+after the other) to the SSD1306 page layout used by blitPages(): for every
+band of 8 rows one byte per column, bit 0 at the top.
+
+Every array must be preceded by image2cpp's "// 'name', WxHpx" comment;
+everything else in the header is copied unchanged. Converted arrays are
+4-byte aligned so the blitter can read them a word at a time.
+
+  python3 tools/pagify_bitmaps.py include/message_animaiton_frames.h
+"""
+import re
+import sys
+
+ARRAY = re.compile(
+    r"// '(?P<name>[^']*)', (?P<w>\d+)x(?P<h>\d+)px\n"
+    r"const unsigned char (?P<ident>\w+) ?\[\] PROGMEM(?P<attrs>[^=]*)= \{(?P<body>[^}]*)\};")
+
+
+def to_pages(data, w, h):
+    row_bytes = (w + 7) // 8
+    pages = []
+    for page in range((h + 7) // 8):
+        for x in range(w):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < h and data[y * row_bytes + x // 8] & (0x80 >> (x % 8)):
+                    byte |= 1 << bit
+            pages.append(byte)
+    return pages
+
+
+def convert(match):
+    if "page layout" in match.group(0):
+        return match.group(0)  # already converted
+    w, h = int(match.group("w")), int(match.group("h"))
+    data = [int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]{2}", match.group("body"))]
+    if len(data) != (w + 7) // 8 * h:
+        sys.exit("%s: expected %d bytes, found %d" % (match.group("ident"), (w + 7) // 8 * h, len(data)))
+
+    pages = to_pages(data, w, h)
+    lines = []
+    for i in range(0, len(pages), 16):
+        lines.append("\t" + ", ".join("0x%02x" % b for b in pages[i:i + 16]))
+    return ("// '%s', %dx%dpx, SSD1306 page layout\n"
+            "const unsigned char %s [] PROGMEM __attribute__((aligned(4))) = {\n%s\n};"
+            % (match.group("name"), w, h, match.group("ident"), ",\n".join(lines)))
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit(__doc__)
+    source = open(sys.argv[1]).read()
+    result, count = ARRAY.subn(convert, source)
+    open(sys.argv[-1], "w").write(result)
+    print("converted %d bitmaps" % count)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Reads the input traces the device records to /trace.bin (Serial 'r', see
+include/trace.h):
+
+  python3 tools/trace_tool.py dump trace.bin
+  python3 tools/trace_tool.py cut trace.bin short.bin --start 120.5 --end 300
+
+dump prints one line per record with the time since the recording
+started. cut keeps the records between two such times and puts the inputs'
+state at the start (GPIO levels, WiFi status, clock) in front of them, so
+a moment from a long production trace can be replayed on its own with a
+LOVEBOX_REPLAY build.
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = b"TRC1"
+START, GPIO, WIFI, CLOCK, WS_EVENT, WS_TEXT, WS_BINARY, SERIAL, WS_DROPPED, END = range(10)
+NAMES = ["start", "gpio", "wifi", "clock", "ws", "text", "binary", "serial", "dropped", "end"]
+CLOCK_SET = 100000  # time() below this was not set by NTP
+WS_TYPES = {1: "disconnected", 2: "connected", 3: "text", 4: "binary"}  # WStype_t
+WIFI_STATUS = {0: "idle", 1: "no ssid", 3: "connected", 4: "connect failed", 5: "connection lost",
+               6: "wrong password", 7: "disconnected"}
+
+
+def read_varint(data, at):
+    value = shift = 0
+    while True:
+        byte = data[at]
+        at += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, at
+        shift += 7
+
+
+def write_varint(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append(value & 0x7F | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def parse(data):
+    """Yields (time in ms since the start record, type, payload bytes)."""
+    if data[:4] != MAGIC:
+        sys.exit("not a trace file")
+    at, now = 4, 0
+    while at < len(data):
+        kind = data[at]
+        delta, at = read_varint(data, at + 1)
+        now += delta
+        begin = at
+        if kind == START:
+            at += 12
+        elif kind == GPIO:
+            at += 2
+        elif kind in (WIFI, WS_EVENT, SERIAL):
+            at += 1
+        elif kind == CLOCK:
+            at += 4
+        elif kind in (WS_TEXT, WS_BINARY):
+            length, at = read_varint(data, at)
+            at += length
+        elif kind == WS_DROPPED:
+            _, at = read_varint(data, at + 1)
+        elif kind == END:
+            pass
+        else:
+            sys.exit(f"unknown record type {kind} at byte {begin - 1}")
+        if at > len(data):
+            print(f"trace ends inside a {NAMES[kind]} record", file=sys.stderr)
+            return
+        yield now, kind, data[begin:at]
+
+
+def describe(kind, payload):
+    if kind == START:
+        seed, clock, millis = struct.unpack("<III", payload)
+        return f"seed {seed:#010x}, clock {clock}, millis {millis}"
+    if kind == GPIO:
+        return f"pin {payload[0]} {'HIGH' if payload[1] else 'LOW'}"
+    if kind == WIFI:
+        return WIFI_STATUS.get(payload[0], str(payload[0]))
+    if kind == CLOCK:
+        return str(struct.unpack("<I", payload)[0])
+    if kind == WS_EVENT:
+        return WS_TYPES.get(payload[0], str(payload[0]))
+    if kind == SERIAL:
+        return repr(chr(payload[0]))
+    if kind == END:
+        return ""
+    if kind == WS_DROPPED:
+        length, _ = read_varint(payload, 1)
+        return f"{WS_TYPES.get(payload[0], payload[0])}, {length} bytes"
+    length, at = read_varint(payload, 0)
+    frame = payload[at:]
+    if kind == WS_TEXT:
+        text = frame.decode("utf-8", "replace")
+        return text if len(text) <= 100 else text[:100] + "..."
+    return f"{length} bytes, type {frame[0]:#04x}" if frame else "0 bytes"
+
+
+def dump(data):
+    counts = {}
+    for now, kind, payload in parse(data):
+        counts[NAMES[kind]] = counts.get(NAMES[kind], 0) + 1
+        print(f"{now / 1000:10.3f}  {NAMES[kind]:8} {describe(kind, payload)}")
+    print(", ".join(f"{n} {name}" for name, n in counts.items()), file=sys.stderr)
+
+
+def cut(data, start_s, end_s):
+    start_ms, end_ms = start_s * 1000, end_s * 1000
+    head = None
+    state = {}  # (type, key) -> payload of the latest input record before the window
+    clock = None
+    kept = []
+    end = 0
+    for now, kind, payload in parse(data):
+        end = now
+        if kind == START:
+            head = payload
+        elif now < start_ms:
+            if kind == GPIO:
+                state[(GPIO, payload[0])] = payload
+            elif kind == WIFI:
+                state[(WIFI, 0)] = payload
+            elif kind == CLOCK:
+                clock = (now, struct.unpack("<I", payload)[0])
+        elif now <= end_ms:
+            kept.append((now, kind, payload))
+
+    seed, _, millis = struct.unpack("<III", head)
+    first = kept[0][0] if kept else start_ms
+    out = bytearray(MAGIC)
+    out += bytes([START]) + write_varint(0) + struct.pack("<III", seed, 0, millis + int(first))
+    for payload in state.values():
+        kind = GPIO if len(payload) == 2 else WIFI
+        out += bytes([kind]) + write_varint(0) + payload
+    if clock:
+        seconds = clock[1] + int(first - clock[0]) // 1000 if clock[1] >= CLOCK_SET else clock[1]
+        out += bytes([CLOCK]) + write_varint(0) + struct.pack("<I", seconds)
+    if not kept or kept[-1][1] != END:
+        kept.append((min(end, end_ms), END, b""))  # replay runs to the end of the window
+    last = first
+    for now, kind, payload in kept:
+        out += bytes([kind]) + write_varint(int(now - last)) + payload
+        last = now
+    return bytes(out), len(kept) - 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+    dump_parser = commands.add_parser("dump")
+    dump_parser.add_argument("trace")
+    cut_parser = commands.add_parser("cut")
+    cut_parser.add_argument("trace")
+    cut_parser.add_argument("output")
+    cut_parser.add_argument("--start", type=float, default=0, help="seconds after the recording started")
+    cut_parser.add_argument("--end", type=float, default=float("inf"))
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as f:
+        data = f.read()
+    if args.command == "dump":
+        dump(data)
+    else:
+        trace, count = cut(data, args.start, args.end)
+        with open(args.output, "wb") as f:
+            f.write(trace)
+        print(f"{args.output}: {count} records, {len(trace)} bytes")
+
+
+if __name__ == "__main__":
+    main()